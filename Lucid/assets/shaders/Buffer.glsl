@@ -81,6 +81,31 @@ uniform float u_NormalTexToggle;
 uniform float u_SpecularTexToggle;
 uniform float u_GlossTexToggle;
 
+// Write the compact g-buffer layout, see GBufferPacking.h
+uniform float u_CompactGBuffer;
+
+// Folds the lower hemisphere of the octahedron over the upper one
+vec2 OctahedralWrap(vec2 v)
+{
+	return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Unit vector to a point on the [-1, 1] square
+vec2 OctahedralEncode(vec3 normal)
+{
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+
+	return normal.z >= 0.0 ? normal.xy : OctahedralWrap(normal.xy);
+}
+
+// Quantises both axes to 12 bits and spreads them over three 8-bit channels
+vec3 PackOctahedral24(vec2 encoded)
+{
+	uvec2 quantised = uvec2(round(clamp(encoded * 0.5 + 0.5, 0.0, 1.0) * 4095.0));
+
+	return vec3(quantised.x >> 4, ((quantised.x & 15u) << 4) | (quantised.y >> 8), quantised.y & 255u) / 255.0;
+}
+
 void main()
 {	
 	m_Params.Diffuse = u_DiffuseTexToggle > 0.5 ? texture(u_DiffuseTexture, vs_Input.TexCoord).rgb : u_Diffuse;
@@ -89,8 +114,9 @@ void main()
 
 	if (u_NormalTexToggle > 0.5)
 	{
-		// Use texture maps normals
-		m_Params.Normal = normalize(2.0 * texture(u_NormalTexture, vs_Input.TexCoord).rgb - 1.0);
+		// Use texture maps normals, Z is rebuilt from X and Y as cooked normal maps only store two channels
+		vec2 normalXY = 2.0 * texture(u_NormalTexture, vs_Input.TexCoord).rg - 1.0;
+		m_Params.Normal = normalize(vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0))));
 
 		m_Params.Normal = normalize(vs_Input.WorldNormals * m_Params.Normal);
 	}
@@ -100,6 +126,15 @@ void main()
 		m_Params.Normal = normalize(vs_Input.Normal);
 	}
 
+	// Compact layout writes albedo/specular to the first target and the packed normal/gloss to the second, position is rebuilt from depth
+	if (u_CompactGBuffer > 0.5)
+	{
+		o_Position = vec4(m_Params.Diffuse, m_Params.Specular);
+		o_Normal = vec4(PackOctahedral24(OctahedralEncode(m_Params.Normal)), m_Params.Gloss);
+
+		return;
+	}
+
 	// Output positions
 	o_Position.rgb = vs_Input.FragPos;
 	o_Position.a = 1.0;
@@ -0,0 +1,167 @@
+#type vertex
+#version 430 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec3 a_Tangent;
+layout(location = 3) in vec3 a_Bitangent;
+layout(location = 4) in vec2 a_TexCoord;
+
+// Per-instance transforms streamed by the renderer, each draw reads from r_InstanceOffset onwards
+layout(std430, binding = 0) readonly buffer InstanceTransforms
+{
+	mat4 s_InstanceTransforms[];
+};
+
+uniform mat4 u_ViewProjectionMatrix;
+
+// Unused, declared so material values are laid out exactly as in Buffer.glsl
+uniform mat4 u_Transform;
+
+uniform int r_InstanceOffset;
+
+out VertexOutput
+{
+	vec2 TexCoord;
+
+	vec3 Normal;
+	vec3 FragPos;
+
+	mat3 WorldNormals;
+
+} vs_Output;
+
+void main()
+{
+	mat4 transform = s_InstanceTransforms[r_InstanceOffset + gl_InstanceID];
+
+	vs_Output.Normal = mat3(transform) * a_Normal;
+	vs_Output.WorldNormals = mat3(transform) * mat3(a_Tangent, a_Bitangent, a_Normal);
+
+	// Flip texture coordinates
+	vs_Output.TexCoord = vec2(a_TexCoord.x, 1.0 - a_TexCoord.y);
+
+	vs_Output.FragPos = vec3(transform * vec4(a_Position, 1.0));
+
+	gl_Position = u_ViewProjectionMatrix * transform * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 430 core
+
+layout(location = 0) out vec4 o_Position;
+layout(location = 1) out vec4 o_Normal;
+layout(location = 2) out vec4 o_Albedo;
+layout(location = 3) out vec4 o_Specular;
+
+struct MaterialParameters
+{
+	vec3 Diffuse;
+	vec3 Normal;
+
+	float Specular;
+	float Gloss;
+};
+
+MaterialParameters m_Params;
+
+in VertexOutput
+{
+	vec2 TexCoord;
+
+	vec3 Normal;
+	vec3 FragPos;
+
+	mat3 WorldNormals;
+
+} vs_Input;
+
+// Material texture inputs
+uniform sampler2D u_DiffuseTexture;
+uniform sampler2D u_NormalTexture;
+uniform sampler2D u_SpecularTexture;
+uniform sampler2D u_GlossTexture;
+
+// Material inputs
+uniform vec3 u_Diffuse;
+uniform float u_Specular;
+uniform float u_Gloss;
+
+// ImGui texture toggles (no longer available in user-interface)
+uniform float u_DiffuseTexToggle;
+uniform float u_NormalTexToggle;
+uniform float u_SpecularTexToggle;
+uniform float u_GlossTexToggle;
+
+// Write the compact g-buffer layout, see GBufferPacking.h
+uniform float u_CompactGBuffer;
+
+// Folds the lower hemisphere of the octahedron over the upper one
+vec2 OctahedralWrap(vec2 v)
+{
+	return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Unit vector to a point on the [-1, 1] square
+vec2 OctahedralEncode(vec3 normal)
+{
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+
+	return normal.z >= 0.0 ? normal.xy : OctahedralWrap(normal.xy);
+}
+
+// Quantises both axes to 12 bits and spreads them over three 8-bit channels
+vec3 PackOctahedral24(vec2 encoded)
+{
+	uvec2 quantised = uvec2(round(clamp(encoded * 0.5 + 0.5, 0.0, 1.0) * 4095.0));
+
+	return vec3(quantised.x >> 4, ((quantised.x & 15u) << 4) | (quantised.y >> 8), quantised.y & 255u) / 255.0;
+}
+
+void main()
+{	
+	m_Params.Diffuse = u_DiffuseTexToggle > 0.5 ? texture(u_DiffuseTexture, vs_Input.TexCoord).rgb : u_Diffuse;
+	m_Params.Specular = u_SpecularTexToggle > 0.5 ? texture(u_SpecularTexture, vs_Input.TexCoord).r : u_Specular;
+	m_Params.Gloss = u_GlossTexToggle > 0.5 ? texture(u_GlossTexture, vs_Input.TexCoord).g : u_Gloss;
+
+	if (u_NormalTexToggle > 0.5)
+	{
+		// Use texture maps normals, Z is rebuilt from X and Y as cooked normal maps only store two channels
+		vec2 normalXY = 2.0 * texture(u_NormalTexture, vs_Input.TexCoord).rg - 1.0;
+		m_Params.Normal = normalize(vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0))));
+
+		m_Params.Normal = normalize(vs_Input.WorldNormals * m_Params.Normal);
+	}
+	else
+	{
+		// Use mesh normals
+		m_Params.Normal = normalize(vs_Input.Normal);
+	}
+
+	// Compact layout writes albedo/specular to the first target and the packed normal/gloss to the second, position is rebuilt from depth
+	if (u_CompactGBuffer > 0.5)
+	{
+		o_Position = vec4(m_Params.Diffuse, m_Params.Specular);
+		o_Normal = vec4(PackOctahedral24(OctahedralEncode(m_Params.Normal)), m_Params.Gloss);
+
+		return;
+	}
+
+	// Output positions
+	o_Position.rgb = vs_Input.FragPos;
+	o_Position.a = 1.0;
+
+	// Output normals
+	o_Normal.rgb = normalize(m_Params.Normal);
+	o_Normal.a = 1.0;
+
+	// Output albedo
+	o_Albedo.rgb = m_Params.Diffuse;
+	o_Albedo.a = 1.0;
+
+	// Output specular/gloss
+	o_Specular.r = m_Params.Specular;
+	o_Specular.g = m_Params.Gloss;
+	o_Specular.b = 1.0;
+	o_Specular.a = 1.0;
+}
\ No newline at end of file
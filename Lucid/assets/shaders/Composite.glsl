@@ -33,6 +33,9 @@ uniform sampler2D u_lightingDepth;
 
 uniform float u_Exposure;
 
+// Zero when the peel passes were culled and their textures are stale
+uniform int u_Transparency;
+
 void main()
 {
 	const float gamma = 2.2;
@@ -40,7 +43,8 @@ void main()
 
 	vec4 lightingPass;
 
-	vec3 colour = texture(u_LightingTexture, v_TexCoord).rgb * u_Exposure;
+	// Read by texel as the lighting target can be larger than the viewport
+	vec3 colour = texelFetch(u_LightingTexture, ivec2(gl_FragCoord.xy), 0).rgb * u_Exposure;
 
 	// Reinhard tonemapping operator
 	float luminance = dot(colour, vec3(0.2126, 0.7152, 0.0722));
@@ -52,6 +56,13 @@ void main()
 	// Gamma correction to final output
 	lightingPass = vec4(pow(mappedColour, vec3(1.0 / gamma)), 1.0);
 
+	if (u_Transparency == 0)
+	{
+		o_Colour = lightingPass;
+
+		return;
+	}
+
 	// Frag coords for sampling front and back textures
 	vec2 fragCoord = gl_FragCoord.xy;
 
@@ -11,21 +11,70 @@ void main()
 #type fragment
 #version 430
 
-uniform sampler2DRect depthBlenderTex;
-uniform sampler2DRect frontBlenderTex;
-uniform sampler2DRect backBlenderTex;
+// Front and back blender colours of the last peeled layer, rendered at a fraction of the viewport resolution
+uniform sampler2DRect u_FrontTexture;
+uniform sampler2DRect u_BackTexture;
 
-layout(location = 0) out vec4 vFragColor;
+// Full resolution opaque depth
+uniform sampler2D u_DepthTexture;
+
+// Width and height of the peel textures divided by the viewport's
+uniform int u_ResolutionFactor;
+
+// Size of the rendered region of the peel textures
+uniform vec2 u_PeelViewportSize;
+
+// Third row entries of the projection matrix, (column 3, column 2), to turn depth back into view distance
+uniform vec2 u_ProjectionParams;
+
+// Full resolution front and back colours, read by the composite in place of the peel textures
+layout(location = 0) out vec4 o_FrontColour;
+layout(location = 1) out vec4 o_BackColour;
+
+float GetViewDistance(float depth)
+{
+	return u_ProjectionParams.x / (depth * 2.0 - 1.0 + u_ProjectionParams.y);
+}
 
 void main()
 {
-	// Get the front and back blender colours
-	vec2 fragCoord = gl_FragCoord.xy;
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+
+	float distance = GetViewDistance(texelFetch(u_DepthTexture, texel, 0).r);
+
+	// The four peel texels around this pixel and the bilinear weights between them
+	vec2 peelPosition = gl_FragCoord.xy / float(u_ResolutionFactor) - 0.5;
+	ivec2 peelBase = ivec2(floor(peelPosition));
+	vec2 bilinear = fract(peelPosition);
+
+	ivec2 peelMax = ivec2(u_PeelViewportSize) - 1;
+
+	vec4 frontColour = vec4(0.0);
+	vec3 backColour = vec3(0.0);
+	float totalWeight = 0.0;
+
+	for (int y = 0; y < 2; y++)
+	{
+		for (int x = 0; x < 2; x++)
+		{
+			ivec2 peelTexel = clamp(peelBase + ivec2(x, y), ivec2(0), peelMax);
+
+			// Opaque depth at the centre of the pixels the peel texel covers, texels across a depth edge from this pixel barely contribute
+			ivec2 sampleTexel = peelTexel * u_ResolutionFactor + u_ResolutionFactor / 2;
+			float sampleDistance = GetViewDistance(texelFetch(u_DepthTexture, sampleTexel, 0).r);
+
+			float depthWeight = exp(-abs(sampleDistance - distance) / max(distance, 1e-4) * 50.0);
+			float bilinearWeight = (x == 1 ? bilinear.x : 1.0 - bilinear.x) * (y == 1 ? bilinear.y : 1.0 - bilinear.y);
+
+			// Floored so a pixel whose neighbours all sit across an edge still blends them rather than going black
+			float weight = max(bilinearWeight * depthWeight, 1e-5);
 
-	vec4 frontColour = texture(frontBlenderTex, fragCoord);
-	vec3 backColour = texture(backBlenderTex, fragCoord).rgb; 
+			frontColour += texelFetch(u_FrontTexture, peelTexel) * weight;
+			backColour += texelFetch(u_BackTexture, peelTexel).rgb * weight;
+			totalWeight += weight;
+		}
+	}
 
-	// Composite the front and back blending results
-	vFragColor.rgb = frontColour.rgb + backColour * frontColour.a;
-	vFragColor.a = 1.0;
+	o_FrontColour = frontColour / totalWeight;
+	o_BackColour = vec4(backColour / totalWeight, 1.0);
 }
\ No newline at end of file
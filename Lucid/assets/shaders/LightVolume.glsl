@@ -0,0 +1,167 @@
+#type vertex
+#version 430
+
+layout(location = 0) in vec3 a_Position;
+
+uniform mat4 u_ViewProjectionMatrix;
+
+// Centre and radius of the light being drawn
+uniform vec4 u_LightVolume;
+
+void main()
+{
+	vec3 position = u_LightVolume.xyz + a_Position * u_LightVolume.w;
+
+	gl_Position = u_ViewProjectionMatrix * vec4(position, 1.0);
+}
+
+#type fragment
+#version 430
+
+layout(location = 0) out vec4 o_Colour;
+
+struct DirectionalLight
+{
+	vec3 Direction;
+	float Brightness;
+
+	vec3 Diffuse;
+	float Padding0;
+
+	vec3 Ambient;
+	float Padding1;
+
+	vec3 Specular;
+	float Padding2;
+};
+
+struct PointLight
+{
+	vec3 Position;
+	float Brightness;
+
+	vec3 Diffuse;
+	float Quadratic;
+
+	vec3 Specular;
+	float Radius;
+};
+
+// Light inputs, packed by the scene renderer and only re-uploaded when the scene's lights change
+layout(std430, binding = 1) readonly buffer LightBuffer
+{
+	DirectionalLight s_DirectionalLight;
+
+	int s_PointLightCount;
+
+	PointLight s_PointLights[];
+};
+
+// Colour attachment inputs
+uniform sampler2D u_PositionTexture;
+uniform sampler2D u_NormalTexture;
+uniform sampler2D u_AlbedoTexture;
+uniform sampler2D u_SpecGlossTexture;
+uniform sampler2D u_DepthTexture;
+
+// Camera position
+uniform vec3 u_CameraPosition;
+
+// Read the compact g-buffer layout, see GBufferPacking.h
+uniform int u_CompactGBuffer;
+uniform mat4 u_InverseViewProjection;
+
+// The g-buffer can be larger than the viewport, texture coordinates are relative to the viewport in its lower left corner
+uniform vec2 u_InverseViewportSize;
+
+// Index of the light being drawn in s_PointLights
+uniform int u_LightIndex;
+
+// Unit vector from a point on the [-1, 1] square
+vec3 OctahedralDecode(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+	float t = clamp(-normal.z, 0.0, 1.0);
+
+	normal.x += normal.x >= 0.0 ? -t : t;
+	normal.y += normal.y >= 0.0 ? -t : t;
+
+	return normalize(normal);
+}
+
+vec2 UnpackOctahedral24(vec3 packed)
+{
+	uvec3 bytes = uvec3(round(packed * 255.0));
+	uvec2 quantised = uvec2((bytes.x << 4) | (bytes.y >> 4), ((bytes.y & 15u) << 8) | bytes.z);
+
+	return vec2(quantised) / 4095.0 * 2.0 - 1.0;
+}
+
+// World space position from a [0, 1] texture coordinate and depth buffer value
+vec3 ReconstructPosition(vec2 texCoord, float depth)
+{
+	vec4 position = u_InverseViewProjection * vec4(vec3(texCoord, depth) * 2.0 - 1.0, 1.0);
+
+	return position.xyz / position.w;
+}
+
+// Diffuse and specular of one point light, attenuated by distance
+void AccumulatePointLight(PointLight light, vec3 FragPos, vec3 Normal, vec3 viewDir, vec3 DiffuseMap, float SpecularMap, float GlossMap, inout vec3 diffuse, inout vec3 specular)
+{
+	// Diffuse component
+	vec3 lightDir = normalize(light.Position - FragPos);
+	float NdotL = max(dot(Normal, lightDir), 0.0);
+	vec3 pointDiffuse = light.Diffuse * NdotL * DiffuseMap * light.Brightness;
+
+	// Specular component
+	float shininess = 16.0;
+
+	// Specular factor
+	vec3 halfwayDir = normalize(lightDir + viewDir);
+	float spec = pow(max(dot(Normal, halfwayDir), 0.0), shininess);
+	vec3 pointSpecular = light.Specular * spec * SpecularMap * GlossMap * light.Brightness;
+
+	// Attenuation
+	float distance = length(light.Position - FragPos);
+	float attenuation = 1.0 / (light.Brightness + light.Quadratic * (distance * distance));
+
+	diffuse += pointDiffuse * attenuation;
+	specular += pointSpecular * attenuation;
+}
+
+void main()
+{
+	// Volumes cover only part of the screen, the g-buffer is read at the pixel being shaded
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+
+	vec3 FragPos = texelFetch(u_PositionTexture, texel, 0).rgb;
+	vec3 Normal = texelFetch(u_NormalTexture, texel, 0).rgb;
+	vec3 DiffuseMap = texelFetch(u_AlbedoTexture, texel, 0).rgb;
+	float SpecularMap = texelFetch(u_SpecGlossTexture, texel, 0).r;
+	float GlossMap = texelFetch(u_SpecGlossTexture, texel, 0).g;
+
+	if (u_CompactGBuffer != 0)
+	{
+		vec4 albedoSpecular = texelFetch(u_AlbedoTexture, texel, 0);
+		vec4 normalGloss = texelFetch(u_NormalTexture, texel, 0);
+
+		vec2 texCoord = (vec2(texel) + 0.5) * u_InverseViewportSize;
+
+		FragPos = ReconstructPosition(texCoord, texelFetch(u_DepthTexture, texel, 0).r);
+		Normal = OctahedralDecode(UnpackOctahedral24(normalGloss.rgb));
+		DiffuseMap = albedoSpecular.rgb;
+		SpecularMap = albedoSpecular.a;
+		GlossMap = normalGloss.a;
+	}
+
+	vec3 viewDir = normalize(u_CameraPosition - FragPos);
+
+	vec3 pointDiffuse = vec3(0.0);
+	vec3 pointSpecular = vec3(0.0);
+
+	AccumulatePointLight(s_PointLights[u_LightIndex], FragPos, Normal, viewDir, DiffuseMap, SpecularMap, GlossMap, pointDiffuse, pointSpecular);
+
+	// Added onto the directional pass, alpha is left as written by it
+	o_Colour = vec4(pointDiffuse + pointSpecular, 0.0);
+}
\ No newline at end of file
@@ -22,48 +22,154 @@ layout(location = 0) out vec4 o_Colour;
 
 struct DirectionalLight
 {
-    vec3 Direction;
+	vec3 Direction;
+	float Brightness;
+
 	vec3 Diffuse;
-    vec3 Ambient;
-    vec3 Specular;
+	float Padding0;
 
-	float Brightness;
+	vec3 Ambient;
+	float Padding1;
+
+	vec3 Specular;
+	float Padding2;
 };
 
 struct PointLight
 {
 	vec3 Position;
-    vec3 Diffuse;
-    vec3 Specular;
-
 	float Brightness;
+
+	vec3 Diffuse;
 	float Quadratic;
+
+	vec3 Specular;
+	float Radius;
 };
 
 in vec2 v_TexCoord;
 
-// Light inputs
-uniform DirectionalLight r_DirectionalLight;
+// Light inputs, packed by the scene renderer and only re-uploaded when the scene's lights change
+layout(std430, binding = 1) readonly buffer LightBuffer
+{
+	DirectionalLight s_DirectionalLight;
+
+	int s_PointLightCount;
+
+	PointLight s_PointLights[];
+};
+
+// View space clusters, each an (offset, count) range of s_ClusterLightIndices, sliced exponentially by view depth
+layout(std430, binding = 2) readonly buffer ClusterBuffer
+{
+	mat4 s_ClusterViewMatrix;
+
+	uvec4 s_ClusterGridSize;
 
-uniform PointLight r_PointLights[100];
-uniform int r_PointLightCount;
+	float s_ClusterDepthScale;
+	float s_ClusterDepthBias;
+
+	uvec2 s_Clusters[];
+};
+
+layout(std430, binding = 3) readonly buffer ClusterIndexBuffer
+{
+	uint s_ClusterLightIndices[];
+};
 
 // Colour attachment inputs
 uniform sampler2D u_PositionTexture;
 uniform sampler2D u_NormalTexture;
 uniform sampler2D u_AlbedoTexture;
 uniform sampler2D u_SpecGlossTexture;
+uniform sampler2D u_DepthTexture;
 
 // Camera position
 uniform vec3 u_CameraPosition;
 
+// Read the compact g-buffer layout, see GBufferPacking.h
+uniform int u_CompactGBuffer;
+uniform mat4 u_InverseViewProjection;
+
+// Point lights shaded by this pass, 0 for every point light, 1 for the lights of the pixel's cluster and 2 for none when they are drawn as light volumes
+uniform int u_PointLightMode;
+
+// Unit vector from a point on the [-1, 1] square
+vec3 OctahedralDecode(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+	float t = clamp(-normal.z, 0.0, 1.0);
+
+	normal.x += normal.x >= 0.0 ? -t : t;
+	normal.y += normal.y >= 0.0 ? -t : t;
+
+	return normalize(normal);
+}
+
+vec2 UnpackOctahedral24(vec3 packed)
+{
+	uvec3 bytes = uvec3(round(packed * 255.0));
+	uvec2 quantised = uvec2((bytes.x << 4) | (bytes.y >> 4), ((bytes.y & 15u) << 8) | bytes.z);
+
+	return vec2(quantised) / 4095.0 * 2.0 - 1.0;
+}
+
+// World space position from a [0, 1] texture coordinate and depth buffer value
+vec3 ReconstructPosition(vec2 texCoord, float depth)
+{
+	vec4 position = u_InverseViewProjection * vec4(vec3(texCoord, depth) * 2.0 - 1.0, 1.0);
+
+	return position.xyz / position.w;
+}
+
+// Diffuse and specular of one point light, attenuated by distance
+void AccumulatePointLight(PointLight light, vec3 FragPos, vec3 Normal, vec3 viewDir, vec3 DiffuseMap, float SpecularMap, float GlossMap, inout vec3 diffuse, inout vec3 specular)
+{
+	// Diffuse component
+	vec3 lightDir = normalize(light.Position - FragPos);
+	float NdotL = max(dot(Normal, lightDir), 0.0);
+	vec3 pointDiffuse = light.Diffuse * NdotL * DiffuseMap * light.Brightness;
+
+	// Specular component
+	float shininess = 16.0;
+
+	// Specular factor
+	vec3 halfwayDir = normalize(lightDir + viewDir);
+	float spec = pow(max(dot(Normal, halfwayDir), 0.0), shininess);
+	vec3 pointSpecular = light.Specular * spec * SpecularMap * GlossMap * light.Brightness;
+
+	// Attenuation
+	float distance = length(light.Position - FragPos);
+	float attenuation = 1.0 / (light.Brightness + light.Quadratic * (distance * distance));
+
+	diffuse += pointDiffuse * attenuation;
+	specular += pointSpecular * attenuation;
+}
+
 void main()
 {
-    vec3 FragPos = texture(u_PositionTexture, v_TexCoord).rgb;
-    vec3 Normal = texture(u_NormalTexture, v_TexCoord).rgb;
-    vec3 DiffuseMap = texture(u_AlbedoTexture, v_TexCoord).rgb;
-    float SpecularMap = texture(u_SpecGlossTexture, v_TexCoord).r;
-	float GlossMap = texture(u_SpecGlossTexture, v_TexCoord).g;
+	// The g-buffer can be larger than the viewport, which covers its lower left corner, so targets are read by texel
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+
+    vec3 FragPos = texelFetch(u_PositionTexture, texel, 0).rgb;
+    vec3 Normal = texelFetch(u_NormalTexture, texel, 0).rgb;
+    vec3 DiffuseMap = texelFetch(u_AlbedoTexture, texel, 0).rgb;
+    float SpecularMap = texelFetch(u_SpecGlossTexture, texel, 0).r;
+	float GlossMap = texelFetch(u_SpecGlossTexture, texel, 0).g;
+
+	// Packed values decoded from the compact targets
+	if (u_CompactGBuffer != 0)
+	{
+		vec4 albedoSpecular = texelFetch(u_AlbedoTexture, texel, 0);
+		vec4 normalGloss = texelFetch(u_NormalTexture, texel, 0);
+
+		FragPos = ReconstructPosition(v_TexCoord, texelFetch(u_DepthTexture, texel, 0).r);
+		Normal = OctahedralDecode(UnpackOctahedral24(normalGloss.rgb));
+		DiffuseMap = albedoSpecular.rgb;
+		SpecularMap = albedoSpecular.a;
+		GlossMap = normalGloss.a;
+	}
 
 	vec3 finalDiffuse = vec3(0.0);
 	vec3 finalSpecular = vec3(0.0);
@@ -73,12 +179,12 @@ void main()
 	vec3 dirSpecular = vec3(0.0);
 
 	// Ambient constant
-	dirAmbient = r_DirectionalLight.Ambient * DiffuseMap;
+	dirAmbient = s_DirectionalLight.Ambient * DiffuseMap;
 
 	// Diffuse component
-	vec3 lightDir = normalize(-r_DirectionalLight.Direction - FragPos);
+	vec3 lightDir = normalize(-s_DirectionalLight.Direction - FragPos);
 	float NdotL = max(dot(Normal, lightDir), 0.0);
-	dirDiffuse = r_DirectionalLight.Diffuse * NdotL * DiffuseMap * r_DirectionalLight.Brightness;
+	dirDiffuse = s_DirectionalLight.Diffuse * NdotL * DiffuseMap * s_DirectionalLight.Brightness;
 
 	// Specular component
 	float shininess = 16.0;
@@ -87,38 +193,29 @@ void main()
 	// Specular factor
 	vec3 halfwayDir = normalize(lightDir + viewDir);
     float spec = pow(max(dot(Normal, halfwayDir), 0.0), shininess);
-	dirSpecular = r_DirectionalLight.Specular * spec * SpecularMap * GlossMap * r_DirectionalLight.Brightness;
-
-	// Point light attributes
-	vec3 pointDiffuse = vec3(0.0);
-	vec3 pointSpecular = vec3(0.0);
+	dirSpecular = s_DirectionalLight.Specular * spec * SpecularMap * GlossMap * s_DirectionalLight.Brightness;
 
 	// Iterate over point lights
-	for (int i = 0; i < r_PointLightCount; i++)
+	if (u_PointLightMode == 1)
+	{
+		float depth = max(-(s_ClusterViewMatrix * vec4(FragPos, 1.0)).z, 1e-4);
+
+		uint slice = uint(clamp(log(depth) * s_ClusterDepthScale - s_ClusterDepthBias, 0.0, float(s_ClusterGridSize.z - 1)));
+		uvec2 tile = min(uvec2(v_TexCoord * vec2(s_ClusterGridSize.xy)), s_ClusterGridSize.xy - 1);
+
+		uvec2 cluster = s_Clusters[tile.x + tile.y * s_ClusterGridSize.x + slice * s_ClusterGridSize.x * s_ClusterGridSize.y];
+
+		for (uint i = 0; i < cluster.y; i++)
+		{
+			AccumulatePointLight(s_PointLights[s_ClusterLightIndices[cluster.x + i]], FragPos, Normal, viewDir, DiffuseMap, SpecularMap, GlossMap, dirDiffuse, dirSpecular);
+		}
+	}
+	else if (u_PointLightMode == 0)
 	{
-		// Diffuse component
-		vec3 lightDir = normalize(r_PointLights[i].Position - FragPos);
-		float NdotL = max(dot(Normal, lightDir), 0.0);
-		pointDiffuse += r_PointLights[i].Diffuse * NdotL * DiffuseMap * r_PointLights[i].Brightness;
-
-		// Specular component
-		float shininess = 16.0;
-		vec3 viewDir = normalize(u_CameraPosition - FragPos);
-
-		// Specular factor
-		vec3 halfwayDir = normalize(lightDir + viewDir);
-		float spec = pow(max(dot(Normal, halfwayDir), 0.0), shininess);
-		pointSpecular += r_PointLights[i].Specular * spec * SpecularMap * GlossMap * r_PointLights[i].Brightness;
-	
-		// Attenuation
-		float distance = length(r_PointLights[i].Position - FragPos);
-		float attenuation = 1.0 / (r_PointLights[i].Brightness + r_PointLights[i].Quadratic * (distance * distance));
-		pointDiffuse *= attenuation;
-		pointSpecular *= attenuation;
-	
-		// Accumulate lighting values
-		dirDiffuse += pointDiffuse;
-		dirSpecular += pointSpecular;
+		for (int i = 0; i < s_PointLightCount; i++)
+		{
+			AccumulatePointLight(s_PointLights[i], FragPos, Normal, viewDir, DiffuseMap, SpecularMap, GlossMap, dirDiffuse, dirSpecular);
+		}
 	}
 
 	vec3 lightingResult = dirAmbient + dirDiffuse + dirSpecular;
@@ -0,0 +1,34 @@
+#type vertex
+#version 430
+
+layout(location = 0) in vec3 a_Position;
+
+uniform mat4 u_ViewProjectionMatrix;
+uniform mat4 u_Transform;
+
+void main()
+{
+	gl_Position = u_ViewProjectionMatrix * u_Transform * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 430
+
+// Summed with additive blending
+layout(location = 0) out vec4 o_Accumulation;
+
+// Multiplied into the target with zero, one minus source colour blending
+layout(location = 1) out float o_Revealage;
+
+uniform float u_Alpha;
+
+void main()
+{
+	vec4 colour = vec4(0.4, 0.5, 0.5, u_Alpha);
+
+	// Nearer and more opaque fragments weigh more, clamped so the 16-bit float accumulation neither underflows nor overflows
+	float weight = clamp(pow(min(1.0, colour.a * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+
+	o_Accumulation = vec4(colour.rgb * colour.a, colour.a) * weight;
+	o_Revealage = colour.a;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#type vertex
+#version 430
+
+layout(location = 0) in vec3 a_Position;
+
+void main()
+{
+	gl_Position = vec4(a_Position.xy, 0.0, 1.0);
+}
+
+#type fragment
+#version 430
+
+uniform sampler2D u_AccumulationTexture;
+uniform sampler2D u_RevealageTexture;
+
+// Laid out like the peeled front and back colours
+layout(location = 0) out vec4 o_FrontColour;
+layout(location = 1) out vec4 o_BackColour;
+
+void main()
+{
+	// Read by texel as the targets can be larger than the viewport
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+
+	vec4 accumulation = texelFetch(u_AccumulationTexture, texel, 0);
+	float revealage = texelFetch(u_RevealageTexture, texel, 0).r;
+
+	// Weighted average colour of every fragment covering the pixel
+	vec3 averageColour = accumulation.rgb / clamp(accumulation.a, 1e-4, 5e4);
+
+	float coverage = 1.0 - revealage;
+
+	// Everything resolves into the front colour, premultiplied by its coverage
+	o_FrontColour = vec4(averageColour * coverage, coverage);
+	o_BackColour = vec4(0.0);
+}
\ No newline at end of file
@@ -4,8 +4,41 @@
 
 int main(int argc, char** argv)
 {
+	ApplicationProps props = { "Lucid Engine", 1280, 720 };
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+
+		// Execute render commands on a dedicated render thread while the main thread records the next frame
+		if (argument == "--render-thread")
+		{
+			props.Threading = ThreadingPolicy::MultiThreaded;
+		}
+
+		// Run without a window on the null device, rendering the scene given by --scene for --frames frames then exiting
+		else if (argument == "--null")
+		{
+			props.RendererAPI = RendererAPIType::Null;
+		}
+		else if (argument == "--scene" && i + 1 < argc)
+		{
+			props.ScenePath = argv[++i];
+		}
+		else if (argument == "--frames" && i + 1 < argc)
+		{
+			props.FrameCount = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+		}
+
+		// Write the null device's call stream to a file on exit
+		else if (argument == "--record" && i + 1 < argc)
+		{
+			props.CallStreamPath = argv[++i];
+		}
+	}
+
 	// Create application instance
-	Application app;
+	Application app(props);
 
 	// Enter applications run loop
 	app.Run();
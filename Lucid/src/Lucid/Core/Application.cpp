@@ -1,5 +1,7 @@
 #include "ldpch.h"
 
+#include <chrono>
+
 #include <glad/glad.h>
 
 #include <imgui/imgui.h>
@@ -11,14 +13,18 @@
 
 #include "Application.h"
 
+#include "Lucid/Core/HeadlessLayer.h"
+
 #include "Lucid/Renderer/Renderer.h"
 #include "Lucid/Renderer/Framebuffer.h"
+#include "Lucid/Renderer/NullDevice.h"
 
 // Application instance
 Application* Application::s_Instance = nullptr;
 
 // Creates an application with desired application properties, initalizes core engine components and sets up window, event callbacks and renderer
 Application::Application(const ApplicationProps& props)
+	: m_RenderThread(props.Threading), m_Props(props)
 {
 	// Set application instance to newly created application
 	s_Instance = this;
@@ -26,23 +32,82 @@ Application::Application(const ApplicationProps& props)
 	// Initalize core engine components, such as logging system
 	InitializeCore();
 
+	// Threading policy and renderer API must be known before any layers are attached
+	Renderer::SetThreadingPolicy(props.Threading);
+	Renderer::SetAPI(props.RendererAPI);
+
+	WindowProps windowProps(props.Name, props.WindowWidth, props.WindowHeight);
+	windowProps.Headless = props.RendererAPI == RendererAPIType::Null;
+
 	// Create the applications window, set event callbacks and enable v-sync
-	m_Window = std::unique_ptr<Window>(Window::Create(WindowProps(props.Name, props.WindowWidth, props.WindowHeight)));
+	m_Window = std::unique_ptr<Window>(Window::Create(windowProps));
 	m_Window->SetEventCallback(LD_BIND_EVENT_FN(Application::OnEvent));
 	m_Window->SetVSync(true);
 
+	// Recording starts before the renderer initialises so the stream includes resource creation
+	if (m_Window->IsHeadless() && !props.CallStreamPath.empty())
+	{
+		NullDevice::SetCallStreamRecording(true);
+	}
+
 	// Push a new ImGui layer to applications layer stack, needed for inital ImGui setup (which is done when ImGuiLayers OnAttach() method is called) 
-	m_ImGuiLayer = new ImGuiLayer("Application Layer");
-	PushOverlay(m_ImGuiLayer);
+	if (!m_Window->IsHeadless())
+	{
+		m_ImGuiLayer = new ImGuiLayer("Application Layer");
+		PushOverlay(m_ImGuiLayer);
+	}
+
+	// Hand the OpenGL context over to the render thread
+	if (props.Threading == ThreadingPolicy::MultiThreaded)
+	{
+		if (!m_Window->IsHeadless())
+		{
+			glfwMakeContextCurrent(nullptr);
+		}
+
+		m_RenderThread.Run(m_Window->GetNativeWindow());
+	}
 
 	// Initalize renderer and traverse render command queue for processing any renderer commands
 	Renderer::Init();
-	Renderer::ExecuteRenderCommands();
+
+	if (props.Threading == ThreadingPolicy::MultiThreaded)
+	{
+		m_RenderThread.Pump();
+	}
+	else
+	{
+		Renderer::ExecuteRenderCommands();
+	}
 }
 
 // Destroys applications window, shuts down core engine components and releases all memory pertaining to the application
 Application::~Application()
 {
+	// Flush any outstanding frames and take the OpenGL context back from the render thread
+	if (m_RenderThread.IsRunning())
+	{
+		m_RenderThread.Terminate();
+
+		if (!m_Window->IsHeadless())
+		{
+			glfwMakeContextCurrent(m_Window->GetNativeWindow());
+		}
+	}
+
+	// Every recorded frame has executed by now, so the call stream is complete
+	if (NullDevice::IsRecordingCallStream())
+	{
+		if (NullDevice::WriteCallStream(m_Props.CallStreamPath))
+		{
+			LD_CORE_INFO("Wrote null device call stream {0} ({1} frames, {2} calls)", m_Props.CallStreamPath, NullDevice::GetFrameCount(), NullDevice::GetTotalCallCount());
+		}
+		else
+		{
+			LD_CORE_ERROR("Could not write null device call stream {0}", m_Props.CallStreamPath);
+		}
+	}
+
 	// Destroy window/GLFW and release from memory
 	m_Window.reset();
 
@@ -67,6 +132,11 @@ void Application::PushOverlay(Layer* layer)
 // Render the ImGui user-interface
 void Application::RenderImGui()
 {
+	if (!m_ImGuiLayer)
+	{
+		return;
+	}
+
 	m_ImGuiLayer->Begin();
 
 	for (Layer* layer : m_LayerStack)
@@ -131,7 +201,15 @@ std::string Application::SaveFile(const char* filter) const
 // Initalizes application specific components such as user-interface
 void Application::OnInit()
 {
-	PushLayer(new EditorLayer());
+	// The editor is built on ImGui so it only exists when there is a window to draw it in
+	if (m_ImGuiLayer)
+	{
+		PushLayer(new EditorLayer());
+	}
+	else
+	{
+		PushLayer(new HeadlessLayer(m_Props.ScenePath, m_Props.FrameCount, m_Props.WindowWidth, m_Props.WindowHeight));
+	}
 }
 
 // Applications run loop that processes all application logic
@@ -139,6 +217,21 @@ void Application::Run()
 {
 	OnInit();
 
+	if (m_RenderThread.GetThreadingPolicy() == ThreadingPolicy::MultiThreaded)
+	{
+		RunMultiThreaded();
+	}
+	else
+	{
+		RunSingleThreaded();
+	}
+
+	// Handle shutdown here
+}
+
+// Records and executes each frame on the main thread
+void Application::RunSingleThreaded()
+{
 	while (m_Running)
 	{
 		if (!m_Minimized)
@@ -166,8 +259,42 @@ void Application::Run()
 		m_TimeStep = time - m_LastFrameTime;
 		m_LastFrameTime = time;
 	}
+}
 
-	// Handle shutdown here
+// Records frame N + 1 on the main thread while the render thread executes frame N
+void Application::RunMultiThreaded()
+{
+	while (m_Running)
+	{
+		// Frame fence, the render thread must finish the previous frame before its queue can be handed back for recording
+		m_RenderThread.BlockUntilRenderComplete();
+		m_RenderThread.NextFrame();
+		m_RenderThread.Kick();
+
+		m_Window->ProcessEvents();
+
+		if (!m_Minimized)
+		{
+			// Update all the applications layers in the layer stack
+			for (Layer* layer : m_LayerStack)
+			{
+				layer->OnUpdate(m_TimeStep);
+			}
+
+			// Build the user-interface on the main thread, its draw data is submitted to the render thread
+			RenderImGui();
+		}
+
+		// Present once everything recorded this frame has executed
+		Window* window = m_Window.get();
+
+		Renderer::Submit([window]() { window->SwapBuffers(); });
+
+		// Calcuate the applications timestep
+		float time = GetTime();
+		m_TimeStep = time - m_LastFrameTime;
+		m_LastFrameTime = time;
+	}
 }
 
 // Dispatch and process applications window events
@@ -215,10 +342,13 @@ bool Application::OnWindowResize(WindowResizeEvent& e)
 	// Retrieve all framebuffer objects
 	auto& fbs = FramebufferPool::GetGlobal()->GetAll();
 
-	// Resize all framebuffers
+	// Resize framebuffers that follow the window, scene targets are sized by the viewport
 	for (auto& fb : fbs)
 	{
-		fb->Resize(width, height);
+		if (fb->GetSpecification().ScreenBufferTarget)
+		{
+			fb->Resize(width, height);
+		}
 	}
 
 	return false;
@@ -237,5 +367,13 @@ bool Application::OnWindowClose(WindowCloseEvent& e)
 // Get the applications current timestep
 float Application::GetTime() const
 {
+	// GLFW is never initialised when headless
+	if (m_Window->IsHeadless())
+	{
+		static const auto startTime = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
 	return (float)glfwGetTime();
 }
\ No newline at end of file
@@ -10,12 +10,26 @@
 #include "Lucid/ImGui/EditorLayer.h"
 
 #include "Lucid/Renderer/Camera.h"
+#include "Lucid/Renderer/Renderer.h"
 
 struct ApplicationProps
 {
 	std::string Name;
 	uint32_t WindowWidth;
 	uint32_t WindowHeight;
+
+	// Multi-threaded executes render commands on a dedicated render thread while the main thread records the next frame
+	ThreadingPolicy Threading = ThreadingPolicy::SingleThreaded;
+
+	// Null runs headless without a window, OpenGL context or user-interface
+	RendererAPIType RendererAPI = RendererAPIType::OpenGL;
+
+	// Headless runs render this scene for a fixed number of frames in place of the editor, then exit
+	std::string ScenePath;
+	uint32_t FrameCount = 1;
+
+	// Headless runs write the null device's call stream here on exit, nothing is recorded when empty
+	std::string CallStreamPath;
 };
 
 // Handles applications layer stack, on update and event data and the run loop
@@ -38,6 +52,8 @@ public:
 	void PushOverlay(Layer* layer);
 	void RenderImGui();
 
+	void Close() { m_Running = false; }
+
 	std::string OpenFile(const char* filter = "All\0*.*\0") const;
 	std::string SaveFile(const char* filter = "All\0*.*\0") const;
 
@@ -54,6 +70,9 @@ private:
 	bool OnWindowResize(WindowResizeEvent& e);
 	bool OnWindowClose(WindowCloseEvent& e);
 
+	void RunSingleThreaded();
+	void RunMultiThreaded();
+
 private:
 
 	std::unique_ptr<Window> m_Window;
@@ -62,7 +81,11 @@ private:
 	bool m_Minimized = false;
 
 	LayerStack m_LayerStack;
-	ImGuiLayer* m_ImGuiLayer;
+	ImGuiLayer* m_ImGuiLayer = nullptr;
+
+	RenderThread m_RenderThread;
+
+	ApplicationProps m_Props;
 
 	Timestep m_TimeStep;
 
@@ -0,0 +1,140 @@
+#include "ldpch.h"
+
+#include "FileSystem.h"
+
+#include <filesystem>
+
+std::string FileSystem::GetCanonicalPath(const std::string& filepath)
+{
+	std::error_code error;
+
+	std::filesystem::path path = std::filesystem::weakly_canonical(filepath, error);
+
+	if (error)
+	{
+		path = filepath;
+	}
+
+	std::string canonicalPath = path.make_preferred().string();
+
+	// Paths on Windows are case insensitive
+	std::transform(canonicalPath.begin(), canonicalPath.end(), canonicalPath.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+
+	return canonicalPath;
+}
+
+bool FileSystem::GetFileInfo(const std::string& filepath, uint64_t& size, int64_t& timestamp)
+{
+	std::error_code error;
+
+	size = (uint64_t)std::filesystem::file_size(filepath, error);
+
+	if (error)
+	{
+		return false;
+	}
+
+	timestamp = (int64_t)std::filesystem::last_write_time(filepath, error).time_since_epoch().count();
+
+	return !error;
+}
+
+uint64_t FileSystem::HashFile(const std::string& filepath)
+{
+	std::ifstream stream(filepath, std::ios::binary);
+
+	uint64_t hash = 14695981039346656037ull;
+
+	std::vector<char> chunk(64 * 1024);
+
+	while (stream)
+	{
+		stream.read(chunk.data(), chunk.size());
+
+		std::streamsize count = stream.gcount();
+
+		for (std::streamsize i = 0; i < count; i++)
+		{
+			hash ^= (uint8_t)chunk[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	return hash;
+}
+
+uint64_t FileSystem::AlignOffset(uint64_t offset, uint64_t alignment)
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+bool FileSystem::WriteFile(const std::string& filepath, const std::vector<FileSection>& sections)
+{
+	// Written beside the final path and moved over it once complete, so a file is never mapped half written
+	std::string temporaryPath = filepath + ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		if (!stream)
+		{
+			LD_CORE_WARN("Could not write {0}", filepath);
+
+			return false;
+		}
+
+		const char padding[64] = {};
+
+		uint64_t written = 0;
+
+		for (const FileSection& section : sections)
+		{
+			LD_CORE_ASSERT(section.Offset >= written, "File sections overlap!");
+
+			while (written < section.Offset)
+			{
+				uint64_t count = std::min<uint64_t>(section.Offset - written, sizeof(padding));
+
+				stream.write(padding, count);
+
+				written += count;
+			}
+
+			stream.write((const char*)section.Data, section.Size);
+
+			written = section.Offset + section.Size;
+		}
+
+		if (!stream)
+		{
+			LD_CORE_WARN("Could not write {0}", filepath);
+
+			return false;
+		}
+	}
+
+	std::error_code error;
+
+	std::filesystem::rename(temporaryPath, filepath, error);
+
+	if (error)
+	{
+		LD_CORE_WARN("Could not replace {0}: {1}", filepath, error.message());
+
+		std::filesystem::remove(temporaryPath, error);
+
+		return false;
+	}
+
+	return true;
+}
+
+bool FileSystem::PatchFile(const std::string& filepath, uint64_t offset, const void* data, uint64_t size)
+{
+	std::fstream stream(filepath, std::ios::binary | std::ios::in | std::ios::out);
+
+	stream.seekp(offset);
+	stream.write((const char*)data, size);
+
+	return (bool)stream;
+}
\ No newline at end of file
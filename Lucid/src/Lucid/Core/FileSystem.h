@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Lucid/Core/Base.h"
+
+// Part of a file written by FileSystem::WriteFile, placed at an absolute offset
+struct FileSection
+{
+	uint64_t Offset;
+
+	const void* Data;
+	uint64_t Size;
+};
+
+class FileSystem
+{
+
+public:
+
+	// Resolves relative segments and links and folds case, so different spellings of a path compare equal
+	static std::string GetCanonicalPath(const std::string& filepath);
+
+	// Size and last write time of a file, false when it cannot be read
+	static bool GetFileInfo(const std::string& filepath, uint64_t& size, int64_t& timestamp);
+
+	// 64-bit FNV-1a of the whole file
+	static uint64_t HashFile(const std::string& filepath);
+
+	// Rounds an offset up to a power of two alignment
+	static uint64_t AlignOffset(uint64_t offset, uint64_t alignment);
+
+	// Writes sections in ascending offset order with the gaps between them zeroed, replacing the file only once it is complete
+	static bool WriteFile(const std::string& filepath, const std::vector<FileSection>& sections);
+
+	// Overwrites bytes of an existing file in place, the rest of the file is left untouched
+	static bool PatchFile(const std::string& filepath, uint64_t offset, const void* data, uint64_t size);
+};
\ No newline at end of file
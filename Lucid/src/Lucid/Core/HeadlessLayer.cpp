@@ -0,0 +1,76 @@
+#include "ldpch.h"
+
+#include "HeadlessLayer.h"
+
+#include <chrono>
+#include <thread>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Lucid/Core/Application.h"
+
+#include "Lucid/Renderer/MeshLibrary.h"
+#include "Lucid/Renderer/SceneRenderer.h"
+#include "Lucid/Renderer/TextureLibrary.h"
+
+#include "Lucid/Scene/SceneSerializer.h"
+
+HeadlessLayer::HeadlessLayer(const std::string& scenePath, uint32_t frameCount, uint32_t width, uint32_t height)
+	: Layer("Headless Layer"), m_ScenePath(scenePath), m_FrameCount(frameCount), m_Width(width), m_Height(height),
+	m_Camera(glm::perspectiveFov(glm::radians(45.0f), (float)width, (float)height, 0.1f, 10000.0f))
+{
+}
+
+void HeadlessLayer::OnAttach()
+{
+	m_Scene = Ref<Scene>::Create();
+
+	// There is no viewport panel to size the scene, it takes the size of the headless window
+	SceneRenderer::SetViewportSize(m_Width, m_Height);
+
+	m_Scene->SetViewportSize(m_Width, m_Height);
+	m_Camera.SetViewportSize(m_Width, m_Height);
+
+	if (m_ScenePath.empty())
+	{
+		LD_CORE_WARN("Headless run has no scene, rendering an empty one");
+
+		return;
+	}
+
+	SceneSerializer serializer(m_Scene);
+
+	if (!serializer.Deserialize(m_ScenePath))
+	{
+		LD_CORE_ERROR("Could not load scene {0}", m_ScenePath);
+
+		return;
+	}
+
+	// Meshes load on the thread pool, waiting for all of them means every frame renders the whole scene
+	while (MeshLibrary::GetPendingLoads() > 0)
+	{
+		MeshLibrary::Update();
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	LD_CORE_INFO("Loaded scene {0}, rendering {1} frames", m_ScenePath, m_FrameCount);
+}
+
+void HeadlessLayer::OnUpdate(Timestep ts)
+{
+	MeshLibrary::Update();
+	TextureLibrary::ReleaseUnused();
+
+	m_Scene->OnUpdate(ts, m_Camera);
+
+	m_FramesRendered++;
+
+	if (m_FramesRendered >= m_FrameCount)
+	{
+		LD_CORE_INFO("Headless run rendered {0} frames", m_FramesRendered);
+
+		Application::Get().Close();
+	}
+}
\ No newline at end of file
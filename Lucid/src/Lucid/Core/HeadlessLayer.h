@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Lucid/Core/Layer.h"
+
+#include "Lucid/ImGui/EditorCamera.h"
+
+#include "Lucid/Scene/Scene.h"
+
+// Drives a scene without a window or editor, loads it and renders a fixed number of frames through the scene renderer before closing the application
+class HeadlessLayer : public Layer
+{
+
+public:
+
+	// An empty scene path renders an empty scene
+	HeadlessLayer(const std::string& scenePath, uint32_t frameCount, uint32_t width, uint32_t height);
+	virtual ~HeadlessLayer() = default;
+
+	virtual void OnAttach() override;
+	virtual void OnUpdate(Timestep ts) override;
+
+private:
+
+	std::string m_ScenePath;
+
+	uint32_t m_FrameCount;
+	uint32_t m_FramesRendered = 0;
+
+	uint32_t m_Width;
+	uint32_t m_Height;
+
+	Ref<Scene> m_Scene;
+
+	EditorCamera m_Camera;
+};
\ No newline at end of file
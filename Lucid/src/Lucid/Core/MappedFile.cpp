@@ -0,0 +1,81 @@
+#include "ldpch.h"
+
+#include "MappedFile.h"
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& filepath)
+{
+	Close();
+
+	HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	m_File = file;
+
+	LARGE_INTEGER size;
+
+	// Empty files cannot be mapped
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		Close();
+
+		return false;
+	}
+
+	m_Size = (uint64_t)size.QuadPart;
+
+	m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (!m_Mapping)
+	{
+		LD_CORE_ERROR("Could not create a file mapping of {0}", filepath);
+
+		Close();
+
+		return false;
+	}
+
+	m_Data = (const uint8_t*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (!m_Data)
+	{
+		LD_CORE_ERROR("Could not map {0}", filepath);
+
+		Close();
+
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+	}
+
+	if (m_File)
+	{
+		CloseHandle(m_File);
+	}
+
+	m_File = nullptr;
+	m_Mapping = nullptr;
+	m_Data = nullptr;
+	m_Size = 0;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Lucid/Core/Base.h"
+
+// Read only view of a whole file mapped into the address space, the OS pages the contents in on first access
+class MappedFile
+{
+
+public:
+
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& filepath);
+	void Close();
+
+	const uint8_t* GetData() const { return m_Data; }
+	uint64_t GetSize() const { return m_Size; }
+
+	bool IsOpen() const { return m_Data != nullptr; }
+
+private:
+
+	// Win32 file and file mapping handles
+	void* m_File = nullptr;
+	void* m_Mapping = nullptr;
+
+	const uint8_t* m_Data = nullptr;
+	uint64_t m_Size = 0;
+};
\ No newline at end of file
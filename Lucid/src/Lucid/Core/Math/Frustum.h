@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Lucid/Core/Math/AABB.h"
+
+// View frustum as six inward facing planes (xyz = normal, w = distance), a point p is inside a plane when dot(xyz, p) + w >= 0
+struct Frustum
+{
+	enum Plane
+	{
+		Left = 0,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+		PlaneCount
+	};
+
+	glm::vec4 Planes[PlaneCount];
+
+	Frustum()
+	{
+		for (uint32_t i = 0; i < PlaneCount; i++)
+		{
+			Planes[i] = glm::vec4(0.0f);
+		}
+	}
+
+	// Extracts the planes from a view projection matrix with an OpenGL [-1, 1] clip space depth range
+	Frustum(const glm::mat4& viewProjection)
+	{
+		glm::vec4 row0 = { viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0] };
+		glm::vec4 row1 = { viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1] };
+		glm::vec4 row2 = { viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2] };
+		glm::vec4 row3 = { viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3] };
+
+		Planes[Left] = row3 + row0;
+		Planes[Right] = row3 - row0;
+		Planes[Bottom] = row3 + row1;
+		Planes[Top] = row3 - row1;
+		Planes[Near] = row3 + row2;
+		Planes[Far] = row3 - row2;
+
+		for (uint32_t i = 0; i < PlaneCount; i++)
+		{
+			float length = glm::length(glm::vec3(Planes[i]));
+
+			if (length > 0.0f)
+			{
+				Planes[i] /= length;
+			}
+		}
+	}
+
+	// Conservative test of a world space box given by centre and half extents, only boxes fully behind a plane are rejected
+	bool IntersectsBox(const glm::vec3& centre, const glm::vec3& extent) const
+	{
+		for (uint32_t i = 0; i < PlaneCount; i++)
+		{
+			const glm::vec4& plane = Planes[i];
+
+			float distance = glm::dot(glm::vec3(plane), centre) + plane.w;
+			float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+
+			if (distance + radius < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool IntersectsAABB(const AABB& aabb) const
+	{
+		return IntersectsBox((aabb.Min + aabb.Max) * 0.5f, (aabb.Max - aabb.Min) * 0.5f);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "ldpch.h"
+
+#include "RadixSort.h"
+
+static constexpr uint32_t s_RadixBits = 8;
+static constexpr uint32_t s_RadixSize = 1 << s_RadixBits;
+static constexpr uint32_t s_PassCount = 64 / s_RadixBits;
+
+// Below this the histogram passes cost more than they save
+static constexpr uint32_t s_InsertionSortThreshold = 64;
+
+static void InsertionSort(std::vector<RadixSortEntry>& entries)
+{
+	for (size_t i = 1; i < entries.size(); i++)
+	{
+		RadixSortEntry entry = entries[i];
+
+		size_t j = i;
+
+		while (j > 0 && entries[j - 1].Key > entry.Key)
+		{
+			entries[j] = entries[j - 1];
+			j--;
+		}
+
+		entries[j] = entry;
+	}
+}
+
+void RadixSort(std::vector<RadixSortEntry>& entries, std::vector<RadixSortEntry>& scratch)
+{
+	uint32_t count = (uint32_t)entries.size();
+
+	if (count < s_InsertionSortThreshold)
+	{
+		InsertionSort(entries);
+
+		return;
+	}
+
+	// Histograms of every digit are built in a single read of the keys
+	static thread_local uint32_t histograms[s_PassCount][s_RadixSize];
+
+	memset(histograms, 0, sizeof(histograms));
+
+	for (const RadixSortEntry& entry : entries)
+	{
+		for (uint32_t pass = 0; pass < s_PassCount; pass++)
+		{
+			histograms[pass][(entry.Key >> (pass * s_RadixBits)) & (s_RadixSize - 1)]++;
+		}
+	}
+
+	scratch.resize(count);
+
+	for (uint32_t pass = 0; pass < s_PassCount; pass++)
+	{
+		uint32_t* histogram = histograms[pass];
+		uint32_t shift = pass * s_RadixBits;
+
+		// Every key has the same digit, this pass would not move anything
+		if (histogram[(entries[0].Key >> shift) & (s_RadixSize - 1)] == count)
+		{
+			continue;
+		}
+
+		uint32_t offset = 0;
+
+		for (uint32_t digit = 0; digit < s_RadixSize; digit++)
+		{
+			uint32_t digitCount = histogram[digit];
+
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (const RadixSortEntry& entry : entries)
+		{
+			scratch[histogram[(entry.Key >> shift) & (s_RadixSize - 1)]++] = entry;
+		}
+
+		entries.swap(scratch);
+	}
+}
\ No newline at end of file
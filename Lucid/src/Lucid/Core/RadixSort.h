@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+// 64-bit key with the index of the item it was computed for
+struct RadixSortEntry
+{
+	uint64_t Key;
+	uint32_t Value;
+};
+
+// Stable LSD radix sort of entries by key in ascending order, 8 bits per pass
+// Passes where every key shares the same digit are skipped so keys that only use their low bits sort in fewer passes
+// Scratch is resized as needed and may be swapped with entries, keep it around between sorts to avoid reallocating
+void RadixSort(std::vector<RadixSortEntry>& entries, std::vector<RadixSortEntry>& scratch);
\ No newline at end of file
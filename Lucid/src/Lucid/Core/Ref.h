@@ -1,28 +1,37 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
 
 // Invasive reference counting system, handles reference counting of all objects created with <Ref>, this is to manage scope of objects that are required during the render command queue
+// The count is atomic as references are released on both the main thread and the render thread
 class RefCounted
 {
 
 public:
 
+	RefCounted() = default;
+
+	// Copying an object does not copy its references
+	RefCounted(const RefCounted&) {}
+	RefCounted& operator=(const RefCounted&) { return *this; }
+
 	void IncRefCount() const
 	{
-		m_RefCount++;
+		m_RefCount.fetch_add(1, std::memory_order_relaxed);
 	}
 
-	void DecRefCount() const
+	// Returns the reference count after decrementing
+	uint32_t DecRefCount() const
 	{
-		m_RefCount--;
+		return m_RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
 	}
 
-	uint32_t GetRefCount() const { return m_RefCount; }
+	uint32_t GetRefCount() const { return m_RefCount.load(std::memory_order_relaxed); }
 
 private:
 
-	mutable uint32_t m_RefCount = 0;
+	mutable std::atomic<uint32_t> m_RefCount{ 0 };
 };
 
 template<typename T>
@@ -155,8 +164,7 @@ private:
 	{
 		if (m_Instance)
 		{
-			m_Instance->DecRefCount();
-			if (m_Instance->GetRefCount() == 0)
+			if (m_Instance->DecRefCount() == 0)
 			{
 				delete m_Instance;
 			}
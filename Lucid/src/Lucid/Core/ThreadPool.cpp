@@ -0,0 +1,147 @@
+#include "ldpch.h"
+
+#include "ThreadPool.h"
+
+#include <atomic>
+
+// Creates the worker threads, by default one per hardware thread leaving one for the main thread
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	m_Workers.reserve(threadCount);
+
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		m_Workers.emplace_back(&ThreadPool::WorkerThreadFunc, this);
+	}
+}
+
+// Finishes any queued jobs and joins all worker threads
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_JobMutex);
+
+		m_Running = false;
+	}
+
+	m_JobCondition.notify_all();
+
+	for (std::thread& worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_JobMutex);
+
+		m_Jobs.push(std::move(job));
+	}
+
+	m_JobCondition.notify_one();
+}
+
+// Calls func for every index in [0, count) across the workers and the calling thread, returns once every index has completed
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (count == 1)
+	{
+		func(0);
+
+		return;
+	}
+
+	// Shared with the helper jobs, which may only start after the calling thread has already finished every index
+	struct ParallelForState
+	{
+		std::function<void(uint32_t)> Func;
+
+		std::atomic<uint32_t> NextIndex{ 0 };
+		std::atomic<uint32_t> Completed{ 0 };
+
+		uint32_t Count = 0;
+
+		std::mutex DoneMutex;
+		std::condition_variable DoneCondition;
+	};
+
+	auto state = std::make_shared<ParallelForState>();
+	state->Func = func;
+	state->Count = count;
+
+	auto work = [state]()
+	{
+		uint32_t index;
+
+		while ((index = state->NextIndex.fetch_add(1)) < state->Count)
+		{
+			state->Func(index);
+
+			if (state->Completed.fetch_add(1) + 1 == state->Count)
+			{
+				std::lock_guard<std::mutex> lock(state->DoneMutex);
+
+				state->DoneCondition.notify_all();
+			}
+		}
+	};
+
+	uint32_t helpers = count - 1 < GetThreadCount() ? count - 1 : GetThreadCount();
+
+	for (uint32_t i = 0; i < helpers; i++)
+	{
+		Enqueue(work);
+	}
+
+	work();
+
+	std::unique_lock<std::mutex> lock(state->DoneMutex);
+
+	state->DoneCondition.wait(lock, [&state]() { return state->Completed == state->Count; });
+}
+
+// Engine wide thread pool
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool threadPool;
+
+	return threadPool;
+}
+
+void ThreadPool::WorkerThreadFunc()
+{
+	while (true)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_JobMutex);
+
+			m_JobCondition.wait(lock, [this]() { return !m_Running || !m_Jobs.empty(); });
+
+			if (!m_Running && m_Jobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(m_Jobs.front());
+			m_Jobs.pop();
+		}
+
+		job();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+
+// Fixed set of worker threads for engine jobs, the calling thread takes part in ParallelFor so it is safe to call from a job
+class ThreadPool
+{
+
+public:
+
+	ThreadPool(uint32_t threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void Enqueue(std::function<void()> job);
+
+	void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+	uint32_t GetThreadCount() const { return (uint32_t)m_Workers.size(); }
+
+	static ThreadPool& Get();
+
+private:
+
+	void WorkerThreadFunc();
+
+private:
+
+	std::vector<std::thread> m_Workers;
+
+	std::queue<std::function<void()>> m_Jobs;
+
+	std::mutex m_JobMutex;
+	std::condition_variable m_JobCondition;
+
+	bool m_Running = true;
+};
\ No newline at end of file
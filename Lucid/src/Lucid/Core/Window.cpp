@@ -6,6 +6,8 @@
 
 #include "Window.h"
 
+#include "Lucid/Renderer/NullDevice.h"
+
 #include "Lucid/Core/Events/ApplicationEvent.h"
 #include "Lucid/Core/Events/KeyEvent.h"
 #include "Lucid/Core/Events/MouseEvent.h"
@@ -44,6 +46,16 @@ void Window::Init(const WindowProps& props)
 	m_Data.Width = props.Width;
 	m_Data.Height = props.Height;
 
+	// Headless windows only track their size, OpenGL is replaced by the null device instead of being loaded through a context
+	if (props.Headless)
+	{
+		LD_CORE_INFO("Creating headless window {0} ({1}, {2})", props.Title, props.Width, props.Height);
+
+		NullDevice::Init();
+
+		return;
+	}
+
 	// Log window creation details
 	LD_CORE_INFO("Creating window {0} ({1}, {2})", props.Title, props.Width, props.Height);
 
@@ -199,6 +211,11 @@ void Window::Init(const WindowProps& props)
 // On window shutdown destroy the current window and terminate GLFW
 void Window::Shutdown()
 {
+	if (!m_Window)
+	{
+		return;
+	}
+
 	glfwDestroyWindow(m_Window);
 	glfwTerminate();
 }
@@ -206,10 +223,13 @@ void Window::Shutdown()
 // Getter to retrieve position of the window
 inline std::pair<float, float> Window::GetWindowPos() const
 {
-	int x;
-	int y;
+	int x = 0;
+	int y = 0;
 
-	glfwGetWindowPos(m_Window, &x, &y);
+	if (m_Window)
+	{
+		glfwGetWindowPos(m_Window, &x, &y);
+	}
 
 	return { x, y };
 }
@@ -217,8 +237,19 @@ inline std::pair<float, float> Window::GetWindowPos() const
 // Processes events and swaps render buffers, also gets the mouse position and processes the windows timestep
 void Window::OnUpdate()
 {
+	ProcessEvents();
+	SwapBuffers();
+}
+
+// Polls window events and updates the mouse cursor, must be called from the main thread
+void Window::ProcessEvents()
+{
+	if (!m_Window)
+	{
+		return;
+	}
+
 	glfwPollEvents();
-	glfwSwapBuffers(m_Window);
 
 	ImGuiMouseCursor imgui_cursor = ImGui::GetMouseCursor();
 
@@ -229,9 +260,29 @@ void Window::OnUpdate()
 	m_LastFrameTime = time;
 }
 
+// Presents the back buffer, must be called from the thread that owns the OpenGL context
+void Window::SwapBuffers()
+{
+	if (!m_Window)
+	{
+		NullDevice::EndFrame();
+
+		return;
+	}
+
+	glfwSwapBuffers(m_Window);
+}
+
 // Sets if the window uses vertical-sync
 void Window::SetVSync(bool isEnabled)
 {
+	m_Data.VSync = isEnabled;
+
+	if (!m_Window)
+	{
+		return;
+	}
+
 	if (isEnabled)
 	{
 		glfwSwapInterval(1);
@@ -240,8 +291,6 @@ void Window::SetVSync(bool isEnabled)
 	{
 		glfwSwapInterval(0);
 	}
-
-	m_Data.VSync = isEnabled;
 }
 
 // Returns true if the window has vertical-sync enabled
@@ -253,6 +302,11 @@ bool Window::IsVSync() const
 // Handles if a key is pressed
 bool Window::IsKeyPressed(int keycode)
 {
+	if (!m_Window)
+	{
+		return false;
+	}
+
 	auto state = glfwGetKey(m_Window, keycode);
 
 	return state == GLFW_PRESS || state == GLFW_REPEAT;
@@ -261,6 +315,11 @@ bool Window::IsKeyPressed(int keycode)
 // Handles if a mouse button is pressed
 bool Window::IsMouseButtonPressed(int button)
 {
+	if (!m_Window)
+	{
+		return false;
+	}
+
 	auto state = glfwGetMouseButton(m_Window, button);
 
 	return state == GLFW_PRESS;
@@ -285,10 +344,13 @@ float Window::GetMouseY()
 // Retrieves the mouse x and y coordinates
 std::pair<float, float> Window::GetMousePosition()
 {
-	double x;
-	double y;
+	double x = 0.0;
+	double y = 0.0;
 
-	glfwGetCursorPos(m_Window, &x, &y);
+	if (m_Window)
+	{
+		glfwGetCursorPos(m_Window, &x, &y);
+	}
 
 	return { (float)x, (float)y };
 }
@@ -296,5 +358,11 @@ std::pair<float, float> Window::GetMousePosition()
 void Window::SetTitle(const std::string& title)
 {
 	m_Data.Title = title;
+
+	if (!m_Window)
+	{
+		return;
+	}
+
 	glfwSetWindowTitle(m_Window, m_Data.Title.c_str());
 }
\ No newline at end of file
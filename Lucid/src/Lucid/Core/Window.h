@@ -14,6 +14,9 @@ struct WindowProps
 	unsigned int Width;
 	unsigned int Height;
 
+	// Headless windows create no GLFW window or OpenGL context, rendering goes to the null device
+	bool Headless = false;
+
 	WindowProps(const std::string& title = "Lucid Engine", unsigned int width = 1280, unsigned int height = 720)
 		: Title(title), Width(width), Height(height) {}
 };
@@ -33,6 +36,9 @@ public:
 
 	void OnUpdate();
 
+	void ProcessEvents();
+	void SwapBuffers();
+
 	inline unsigned int GetWidth() const { return m_Data.Width; }
 	inline unsigned int GetHeight() const { return m_Data.Height; }
 
@@ -48,6 +54,8 @@ public:
 	inline void* GetWindowPointer() const { return m_Window; }
 	inline GLFWwindow* GetNativeWindow() const { return m_Window; }
 
+	bool IsHeadless() const { return m_Window == nullptr; }
+
 	bool IsKeyPressed(int keycode);
 	bool IsMouseButtonPressed(int button);
 
@@ -63,7 +71,7 @@ private:
 
 private:
 
-	GLFWwindow* m_Window;
+	GLFWwindow* m_Window = nullptr;
 	GLFWcursor* m_ImGuiMouseCursors[9] = { 0 };
 
 	struct WindowData
@@ -7,10 +7,18 @@
 #include "Lucid/ImGui/ImGuiGizmo.h"
 
 #include "Lucid/Core/Application.h"
+#include "Lucid/Core/ThreadPool.h"
 
 #include "Lucid/Renderer/Renderer2D.h"
 #include "Lucid/Renderer/Renderer.h"
 #include "Lucid/Renderer/SceneRenderer.h"
+#include "Lucid/Renderer/RenderPacket.h"
+#include "Lucid/Renderer/MeshLibrary.h"
+#include "Lucid/Renderer/TextureLibrary.h"
+#include "Lucid/Renderer/TextureCooker.h"
+#include "Lucid/Renderer/RenderProfiler.h"
+#include "Lucid/Renderer/RenderState.h"
+#include "Lucid/Renderer/TransparencyBenchmark.h"
 
 #include "Lucid/Scene/SceneSerializer.h"
 
@@ -316,6 +324,14 @@ void EditorLayer::OnUpdate(Timestep ts)
 		m_EditorCamera.OnUpdate(ts);
 	}
 
+	TransparencyBenchmark::Update();
+
+	// Uploads meshes that finished loading in the background and unloads meshes left without entities, after deleting them or switching scene
+	MeshLibrary::Update();
+
+	// After the meshes, so textures only their materials used go with them
+	TextureLibrary::ReleaseUnused();
+
 	m_ActiveScene->OnUpdate(ts, m_EditorCamera);
 
 	if (m_SelectionContext.size() && false)
@@ -407,6 +423,253 @@ void EditorLayer::OnImGuiRender()
 
 	ImGui::End();
 
+	ImGui::Begin("Statistics");
+
+	const RenderCommandQueueStats& queueStats = Renderer::GetRenderCommandQueueStats();
+
+	ImGui::Text("Render Commands: %u", queueStats.CommandCount);
+	ImGui::Text("Command Memory: %.1f KB (peak %.1f KB)", queueStats.BytesUsed / 1024.0f, queueStats.HighWaterMark / 1024.0f);
+
+	ImGui::Separator();
+
+	// State changes filtered by the render state cache in the last executed frame
+	RenderStateStats stateStats = RenderState::GetStats();
+
+	ImGui::Text("State Changes: %u issued, %u skipped", stateStats.GetTotalIssued(), stateStats.GetTotalSkipped());
+
+	for (uint32_t i = 0; i < (uint32_t)RenderStateType::Count; i++)
+	{
+		ImGui::Text("  %s: %u issued, %u skipped", RenderStateStats::GetTypeName((RenderStateType)i), stateStats.Issued[i], stateStats.Skipped[i]);
+	}
+
+	ImGui::Separator();
+
+	// Frustum culling of the last flushed frame
+	const SceneRendererStats& sceneStats = SceneRenderer::GetStats();
+
+	ImGui::Checkbox("Frustum Culling", &SceneRenderer::GetOptions().FrustumCulling);
+
+	ImGui::Text("Submeshes: %u visible, %u culled (%u total)", sceneStats.VisibleSubmeshes, sceneStats.CulledSubmeshes, sceneStats.Submeshes);
+	ImGui::Text("Meshes Culled: %u", sceneStats.CulledMeshes);
+
+	ImGui::Separator();
+
+	// Packets are sorted on the render thread, transparent draw lists on the main thread
+	RenderPacketStats packetStats = RenderPacketList::GetStats();
+
+	ImGui::Text("Packet Sort: %u packets in %u lists, %.3f ms", packetStats.Packets, packetStats.Dispatches, packetStats.SortTime);
+
+	ImGui::Checkbox("Instancing", &SceneRenderer::GetOptions().Instancing);
+
+	ImGui::Text("Packet Draw Calls: %u (%u instanced, %u instances)", packetStats.DrawCalls, packetStats.InstancedDrawCalls, packetStats.Instances);
+
+	ImGui::Checkbox("Back-to-Front Transparency", &SceneRenderer::GetOptions().SortTransparentBackToFront);
+
+	ImGui::Text("Transparent Sort: %u meshes, %.3f ms", sceneStats.SortedTransparentMeshes, sceneStats.TransparentSortTime);
+
+	const char* transparencyTechniques[] = { "Dual Depth Peeling", "Weighted Blended" };
+
+	int transparencyTechnique = (int)SceneRenderer::GetOptions().Transparency;
+
+	if (ImGui::Combo("Transparency", &transparencyTechnique, transparencyTechniques, IM_ARRAYSIZE(transparencyTechniques)))
+	{
+		SceneRenderer::GetOptions().Transparency = (TransparencyTechnique)transparencyTechnique;
+	}
+
+	// Peel targets at a fraction of the viewport size, upsampled against the opaque depth
+	const char* transparencyResolutions[] = { "Full", "Half", "Quarter" };
+
+	int transparencyResolution = SceneRenderer::GetOptions().TransparencyResolution == 4 ? 2 : SceneRenderer::GetOptions().TransparencyResolution - 1;
+
+	if (ImGui::Combo("Transparency Resolution", &transparencyResolution, transparencyResolutions, IM_ARRAYSIZE(transparencyResolutions)))
+	{
+		SceneRenderer::GetOptions().TransparencyResolution = 1 << transparencyResolution;
+	}
+
+	// The layer peels slider is the upper bound of the adaptive count
+	ImGui::Checkbox("Adaptive Layer Peels", &SceneRenderer::GetOptions().AdaptiveLayerPeels);
+
+	ImGui::Text("Layer Peels: %u of %d", sceneStats.LayerPeels, SceneRenderer::GetOptions().LayerPeels);
+
+	ImGui::Separator();
+
+	ImGui::Checkbox("Clustered Lighting", &SceneRenderer::GetOptions().ClusteredLighting);
+
+	ImGui::Text("Light Clusters: %u light indices, %.3f ms", sceneStats.ClusterLightIndices, sceneStats.LightClusterTime);
+
+	ImGui::Checkbox("Light Volumes", &SceneRenderer::GetOptions().LightVolumes);
+
+	ImGui::Text("Light Volumes: %u drawn", sceneStats.LightVolumes);
+
+	ImGui::Separator();
+
+	ImGui::Checkbox("Compact G-Buffer", &SceneRenderer::GetOptions().CompactGBuffer);
+
+	// Transient attachments only take memory while their passes are live and share textures when their lifetimes do not overlap
+	FramebufferPoolStats framebufferStats = FramebufferPool::GetGlobal()->GetStats();
+
+	ImGui::Text("Render Targets: %.1f MB unaliased, %.1f MB pooled", framebufferStats.UnaliasedMemory / (1024.0f * 1024.0f), framebufferStats.AliasedMemory / (1024.0f * 1024.0f));
+	ImGui::Text("Transient Attachments: %u in %u textures", framebufferStats.TransientAttachments, framebufferStats.TransientTextures);
+
+	ImGui::Separator();
+
+	// Render graph passes in execution order, record time is main thread only
+	for (const RenderGraphPassStats& passStats : SceneRenderer::GetRenderGraphStats())
+	{
+		if (passStats.Culled)
+		{
+			ImGui::Text("%s: culled", passStats.Name);
+		}
+		else
+		{
+			ImGui::Text("%s: %.3f ms, barriers 0x%x", passStats.Name, passStats.RecordTime, passStats.Barriers);
+		}
+	}
+
+	ImGui::End();
+
+	ImGui::Begin("Profiler");
+
+	// Rolling averages, GPU time lags a few frames behind as timestamps are read back without waiting on them
+	std::vector<RenderProfilerResult> profilerResults = RenderProfiler::GetResults();
+
+	if (ImGui::Button("Export CSV"))
+	{
+		std::string filepath = Application::Get().SaveFile("CSV (*.csv)\0*.csv\0");
+
+		if (!filepath.empty())
+		{
+			RenderProfiler::ExportCSV(filepath);
+		}
+	}
+
+	ImGui::SameLine();
+	ImGui::Text("Dropped Frames: %u", RenderProfiler::GetDroppedFrames());
+
+	// Keep the camera still while the benchmark renders the scene with each transparency technique
+	if (TransparencyBenchmark::IsRunning())
+	{
+		ImGui::Text("Transparency Benchmark: %.0f%%", TransparencyBenchmark::GetProgress() * 100.0f);
+	}
+	else if (ImGui::Button("Benchmark Transparency"))
+	{
+		TransparencyBenchmark::Start();
+	}
+
+	if (TransparencyBenchmark::HasResult())
+	{
+		TransparencyBenchmarkResult benchmark = TransparencyBenchmark::GetResult();
+
+		ImGui::Text("Dual Depth Peeling: %.3f ms, Weighted Blended: %.3f ms", benchmark.DualDepthPeelingTime, benchmark.WeightedBlendedTime);
+
+		if (benchmark.ImageCompared)
+		{
+			ImGui::Text("Image Error: %.4f RMS, %.4f max", benchmark.RMSError, benchmark.MaxError);
+		}
+		else
+		{
+			ImGui::Text("Image Error: viewport resized during the benchmark");
+		}
+	}
+
+	ImGui::Separator();
+
+	ImGui::Columns(4);
+
+	ImGui::Text("Scope");
+	ImGui::NextColumn();
+	ImGui::Text("GPU (ms)");
+	ImGui::NextColumn();
+	ImGui::Text("Record (ms)");
+	ImGui::NextColumn();
+	ImGui::Text("Execute (ms)");
+	ImGui::NextColumn();
+
+	ImGui::Separator();
+
+	for (const RenderProfilerResult& result : profilerResults)
+	{
+		ImGui::Text("%*s%s", result.Depth * 2, "", result.Name.c_str());
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", result.GPUTime);
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", result.RecordTime);
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", result.ExecuteTime);
+		ImGui::NextColumn();
+	}
+
+	ImGui::Columns(1);
+
+	ImGui::End();
+
+	ImGui::Begin("Assets");
+
+	std::vector<MeshAsset> meshAssets = MeshLibrary::GetAssets();
+
+	MeshMemoryUsage totalMemory;
+
+	for (const MeshAsset& asset : meshAssets)
+	{
+		totalMemory.GeometryMemory += asset.Memory.GeometryMemory;
+		totalMemory.TextureMemory += asset.Memory.TextureMemory;
+		totalMemory.SystemMemory += asset.Memory.SystemMemory;
+		totalMemory.MappedMemory += asset.Memory.MappedMemory;
+	}
+
+	constexpr float megabyte = 1024.0f * 1024.0f;
+
+	ImGui::Text("Meshes: %u, Loading: %u", (uint32_t)meshAssets.size(), MeshLibrary::GetPendingLoads());
+	ImGui::Text("Geometry: %.2f MB, Textures: %.2f MB, System: %.2f MB, Mapped: %.2f MB", totalMemory.GeometryMemory / megabyte, totalMemory.TextureMemory / megabyte, totalMemory.SystemMemory / megabyte, totalMemory.MappedMemory / megabyte);
+
+	// Textures shared between meshes count once here
+	ImGui::Text("Cached Textures: %u, %.2f MB", TextureLibrary::GetTextureCount(), TextureLibrary::GetMemoryUsage() / megabyte);
+
+	ImGui::Separator();
+
+	ImGui::Columns(6);
+
+	ImGui::Text("Mesh");
+	ImGui::NextColumn();
+	ImGui::Text("References");
+	ImGui::NextColumn();
+	ImGui::Text("Geometry (MB)");
+	ImGui::NextColumn();
+	ImGui::Text("Textures (MB)");
+	ImGui::NextColumn();
+	ImGui::Text("System (MB)");
+	ImGui::NextColumn();
+	ImGui::Text("Mapped (MB)");
+	ImGui::NextColumn();
+
+	ImGui::Separator();
+
+	for (const MeshAsset& asset : meshAssets)
+	{
+		ImGui::Text("%s%s", std::filesystem::path(asset.Path).filename().string().c_str(), asset.Loaded ? "" : " (loading)");
+
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::SetTooltip("%s", asset.Path.c_str());
+		}
+
+		ImGui::NextColumn();
+		ImGui::Text("%u", asset.References);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", asset.Memory.GeometryMemory / megabyte);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", asset.Memory.TextureMemory / megabyte);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", asset.Memory.SystemMemory / megabyte);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", asset.Memory.MappedMemory / megabyte);
+		ImGui::NextColumn();
+	}
+
+	ImGui::Columns(1);
+
+	ImGui::End();
+
 	ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(12, 0));
 	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(12, 4));
 	ImGui::PushStyleVar(ImGuiStyleVar_ItemInnerSpacing, ImVec2(0, 0));
@@ -680,7 +943,9 @@ void EditorLayer::OnImGuiRender()
 	m_EditorCamera.SetProjectionMatrix(glm::perspectiveFov(glm::radians(45.0f), viewportSize.x, viewportSize.y, 0.1f, 10000.0f));
 	m_EditorCamera.SetViewportSize((uint32_t)viewportSize.x, (uint32_t)viewportSize.y);
 
-	ImGui::Image((void*)SceneRenderer::GetFinalColourBufferRendererID(), viewportSize, { 0, 1 }, { 1, 0 });
+	glm::vec2 viewportScale = SceneRenderer::GetFinalColourBufferScale();
+
+	ImGui::Image((void*)SceneRenderer::GetFinalColourBufferRendererID(), viewportSize, { 0, viewportScale.y }, { viewportScale.x, 0 });
 
 	static int counter = 0;
 
@@ -718,7 +983,9 @@ void EditorLayer::OnImGuiRender()
 		{
 			ImGuizmo::Manipulate(glm::value_ptr(m_EditorCamera.GetViewMatrix()), glm::value_ptr(m_EditorCamera.GetProjectionMatrix()), (ImGuizmo::OPERATION)m_GizmoType, ImGuizmo::LOCAL, glm::value_ptr(entityTransform), nullptr,	m_Snap ? snapValue : nullptr);
 		}
-		else
+		// Submesh transforms live on the mesh, which the mesh library shares between every entity using the file
+		// Moving a submesh is only allowed while a single entity uses the mesh, otherwise it would move on all of them
+		else if (selection.Mesh && selection.Entity.HasComponent<MeshComponent>() && !IsMeshShared(selection.Entity.GetComponent<MeshComponent>().MeshComp))
 		{
 			glm::mat4 transformBase = entityTransform * selection.Mesh->Transform;
 
@@ -776,6 +1043,28 @@ void EditorLayer::OnImGuiRender()
 				UpdateWindowTitle(path.filename().string());
 			}
 
+			ImGui::Separator();
+
+			if (ImGui::MenuItem("Cook Textures", "", false))
+			{
+				std::vector<MeshTextureSource> sources = MeshLibrary::GetTextureSources();
+
+				LD_CORE_INFO("Cooking {0} textures", sources.size());
+
+				// Cooked on the thread pool, textures already loaded switch to their cooked version the next time they are loaded
+				ThreadPool::Get().Enqueue([sources]()
+				{
+					ThreadPool::Get().ParallelFor((uint32_t)sources.size(), [&sources](uint32_t i)
+					{
+						TextureCookSettings settings;
+						settings.SRGB = sources[i].SRGB;
+						settings.NormalMap = sources[i].NormalMap;
+
+						TextureCooker::Cook(sources[i].Path, settings);
+					});
+				});
+			}
+
 			ImGui::EndMenu();
 		}
 
@@ -919,7 +1208,7 @@ bool EditorLayer::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 
 				auto mesh = entity.GetComponent<MeshComponent>().MeshComp;
 
-				if (!mesh)
+				if (!mesh || !mesh->IsLoaded())
 				{
 					continue;
 				}
@@ -990,13 +1279,37 @@ std::pair<float, float> EditorLayer::GetMouseViewportSpace()
 	return { (mx / viewportWidth) * 2.0f - 1.0f, ((my / viewportHeight) * 2.0f - 1.0f) * -1.0f };
 }
 
+bool EditorLayer::IsMeshShared(const Ref<Mesh>& mesh)
+{
+	uint32_t users = 0;
+
+	auto meshEntities = m_ActiveScene->GetAllEntitiesWith<MeshComponent>();
+
+	for (auto e : meshEntities)
+	{
+		Entity entity = { e, m_ActiveScene.Raw() };
+
+		if (entity.GetComponent<MeshComponent>().MeshComp.Raw() == mesh.Raw() && ++users > 1)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void EditorLayer::SelectEntity(Entity entity)
 {
 	SelectedSubmesh selection;
 
 	if (entity.HasComponent<MeshComponent>())
 	{
-		selection.Mesh = &entity.GetComponent<MeshComponent>().MeshComp->GetSubmeshes()[0];
+		auto& mesh = entity.GetComponent<MeshComponent>().MeshComp;
+
+		if (mesh && mesh->IsLoaded() && !mesh->GetSubmeshes().empty())
+		{
+			selection.Mesh = &mesh->GetSubmeshes()[0];
+		}
 	}
 
 	selection.Entity = entity;
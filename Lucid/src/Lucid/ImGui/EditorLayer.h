@@ -83,6 +83,9 @@ private:
 	void OnSelected(const SelectedSubmesh& selectionContext);
 	void OnEntityDeleted(Entity e);
 
+	// True when more than one entity in the scene uses the mesh
+	bool IsMeshShared(const Ref<Mesh>& mesh);
+
 	Ray CastMouseRay();
 
 private:
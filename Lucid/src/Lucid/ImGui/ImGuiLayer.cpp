@@ -14,6 +14,37 @@
 
 #include "Lucid/Core/Application.h"
 
+#include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderState.h"
+
+// Copy of ImGui's draw data for the render thread, ImGui reuses its draw lists as soon as the next frame begins
+struct ImGuiDrawDataSnapshot
+{
+	ImDrawData DrawData;
+	std::vector<ImDrawList*> CmdLists;
+
+	ImGuiDrawDataSnapshot(const ImDrawData* drawData)
+		: DrawData(*drawData)
+	{
+		CmdLists.reserve(drawData->CmdListsCount);
+
+		for (int i = 0; i < drawData->CmdListsCount; i++)
+		{
+			CmdLists.push_back(drawData->CmdLists[i]->CloneOutput());
+		}
+
+		DrawData.CmdLists = CmdLists.data();
+	}
+
+	~ImGuiDrawDataSnapshot()
+	{
+		for (ImDrawList* cmdList : CmdLists)
+		{
+			IM_DELETE(cmdList);
+		}
+	}
+};
+
 ImGuiLayer::ImGuiLayer()
 {
 }
@@ -40,8 +71,11 @@ void ImGuiLayer::OnAttach()
 	// Enable docking
 	io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
 
-	// Enable multi-viewport/windows
-	io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+	// Enable multi-viewport/windows, platform windows need the OpenGL context on the main thread so they are only available when single-threaded
+	if (Renderer::GetThreadingPolicy() != ThreadingPolicy::MultiThreaded)
+	{
+		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+	}
 
 	// Set ImGui interface font
 	ImFont* pFont = io.Fonts->AddFontFromFileTTF("C:\\Windows\\Fonts\\segoeui.ttf", 18.0f);
@@ -69,6 +103,12 @@ void ImGuiLayer::OnAttach()
 	// Setup platform/renderer bindings
 	ImGui_ImplGlfw_InitForOpenGL(window, true);
 	ImGui_ImplOpenGL3_Init("#version 410");
+
+	// Create device objects (shaders and font atlas) up front while the main thread still owns the OpenGL context
+	if (Renderer::GetThreadingPolicy() == ThreadingPolicy::MultiThreaded)
+	{
+		ImGui_ImplOpenGL3_NewFrame();
+	}
 }
 
 void ImGuiLayer::OnDetach()
@@ -80,7 +120,11 @@ void ImGuiLayer::OnDetach()
 
 void ImGuiLayer::Begin()
 {
-	ImGui_ImplOpenGL3_NewFrame();
+	if (Renderer::GetThreadingPolicy() != ThreadingPolicy::MultiThreaded)
+	{
+		ImGui_ImplOpenGL3_NewFrame();
+	}
+
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
 	ImGuizmo::BeginFrame();
@@ -98,8 +142,30 @@ void ImGuiLayer::End()
 
 	// Render ImGui interface
 	ImGui::Render();
+
+	// When multi-threaded the interface is built on the main thread and its draw data is handed to the render thread
+	if (Renderer::GetThreadingPolicy() == ThreadingPolicy::MultiThreaded)
+	{
+		ImGuiDrawDataSnapshot* snapshot = new ImGuiDrawDataSnapshot(ImGui::GetDrawData());
+
+		Renderer::Submit([snapshot]()
+		{
+			ImGui_ImplOpenGL3_RenderDrawData(&snapshot->DrawData);
+
+			// ImGui binds GL state without going through the state cache
+			RenderState::Invalidate();
+
+			delete snapshot;
+		});
+
+		return;
+	}
+
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+	// ImGui binds GL state without going through the state cache
+	RenderState::Invalidate();
+
 	if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 	{
 		GLFWwindow* backup_current_context = glfwGetCurrentContext();
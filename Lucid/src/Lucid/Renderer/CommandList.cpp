@@ -0,0 +1,29 @@
+#include "ldpch.h"
+
+#include "CommandList.h"
+
+#include "Lucid/Renderer/Renderer.h"
+
+Ref<CommandList> CommandList::Create()
+{
+	return Ref<CommandList>::Create();
+}
+
+// Routes every command submitted from the calling thread into this list until End() is called
+void CommandList::Begin()
+{
+	LD_CORE_ASSERT(!m_Recording, "Command list is already recording!");
+
+	m_Recording = true;
+
+	Renderer::SetRecordingCommandList(this);
+}
+
+void CommandList::End()
+{
+	LD_CORE_ASSERT(m_Recording, "Command list is not recording!");
+
+	Renderer::SetRecordingCommandList(nullptr);
+
+	m_Recording = false;
+}
\ No newline at end of file
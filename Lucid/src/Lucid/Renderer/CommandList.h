@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Lucid/Renderer/RenderCommandQueue.h"
+
+// Render commands recorded by a single thread, while a command list is active on a thread Renderer::Submit records into it instead of the frame queue
+// Recorded lists are stitched into the frame queue with Renderer::SubmitCommandList, commands execute in the order the lists are submitted
+class CommandList : public RefCounted
+{
+
+public:
+
+	CommandList() = default;
+	~CommandList() = default;
+
+	void Begin();
+	void End();
+
+	bool IsRecording() const { return m_Recording; }
+	bool IsEmpty() const { return m_CommandQueue.IsEmpty(); }
+
+	RenderCommandQueue& GetCommandQueue() { return m_CommandQueue; }
+
+	static Ref<CommandList> Create();
+
+private:
+
+	RenderCommandQueue m_CommandQueue;
+
+	bool m_Recording = false;
+};
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "ldpch.h"
+
+#include "CookedTexture.h"
+
+#include "Lucid/Core/FileSystem.h"
+
+static constexpr uint64_t s_CookedTextureAlignment = 16;
+
+// Bytes of one 4x4 block
+static uint64_t GetBlockSize(TextureCompression compression)
+{
+	return compression == TextureCompression::BC1 ? 8 : 16;
+}
+
+// The mip table describes the full chain glTextureStorage2D allocates for the header's size, and every mip's blocks lie within the file
+static bool IsMipChainValid(const CookedTextureHeader& header, const CookedTextureMip* mips, uint64_t fileSize)
+{
+	if (header.Width == 0 || header.Height == 0)
+	{
+		return false;
+	}
+
+	uint32_t maxMipCount = 1;
+
+	for (uint32_t size = std::max(header.Width, header.Height); size > 1; size /= 2)
+	{
+		maxMipCount++;
+	}
+
+	if (header.MipCount > maxMipCount)
+	{
+		return false;
+	}
+
+	uint64_t blockSize = GetBlockSize(header.Compression);
+
+	uint32_t width = header.Width;
+	uint32_t height = header.Height;
+
+	for (uint32_t i = 0; i < header.MipCount; i++)
+	{
+		const CookedTextureMip& mip = mips[i];
+
+		// Each mip halves the one before it, rounding down and stopping at one texel
+		if (mip.Width != width || mip.Height != height)
+		{
+			return false;
+		}
+
+		uint64_t expectedSize = (uint64_t)((mip.Width + 3) / 4) * ((mip.Height + 3) / 4) * blockSize;
+
+		if (mip.Size != expectedSize || mip.Offset > fileSize || mip.Size > fileSize - mip.Offset)
+		{
+			return false;
+		}
+
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
+
+	return true;
+}
+
+std::string CookedTexture::GetCookedPath(const std::string& sourcePath)
+{
+	return sourcePath + ".ldtex";
+}
+
+Ref<CookedTexture> CookedTexture::Open(const std::string& sourcePath, bool srgb)
+{
+	std::string cookedPath = GetCookedPath(sourcePath);
+
+	Ref<CookedTexture> texture = Ref<CookedTexture>::Create();
+
+	if (!texture->m_File.Open(cookedPath))
+	{
+		return nullptr;
+	}
+
+	uint64_t fileSize = texture->m_File.GetSize();
+
+	if (fileSize < sizeof(CookedTextureHeader))
+	{
+		LD_CORE_WARN("Cooked texture {0} is truncated", cookedPath);
+
+		return nullptr;
+	}
+
+	const CookedTextureHeader* header = (const CookedTextureHeader*)texture->m_File.GetData();
+
+	bool compressionValid = header->Compression == TextureCompression::BC1 || header->Compression == TextureCompression::BC3 || header->Compression == TextureCompression::BC5;
+
+	if (header->Magic != s_CookedTextureMagic || header->Version != s_CookedTextureVersion || !compressionValid)
+	{
+		LD_CORE_WARN("Cooked texture {0} was written by a different version, recook it", cookedPath);
+
+		return nullptr;
+	}
+
+	if ((header->SRGB != 0) != srgb)
+	{
+		LD_CORE_WARN("Cooked texture {0} was cooked for a different colour space, recook it", cookedPath);
+
+		return nullptr;
+	}
+
+	uint64_t sourceSize = 0;
+	int64_t sourceTimestamp = 0;
+
+	bool sourceFound = FileSystem::GetFileInfo(sourcePath, sourceSize, sourceTimestamp);
+
+	// Copies and checkouts change the timestamp without changing the contents, only those pay for hashing the source
+	bool timestampChanged = sourceFound && header->SourceTimestamp != sourceTimestamp;
+
+	if (sourceFound && (header->SourceSize != sourceSize || (timestampChanged && header->SourceHash != FileSystem::HashFile(sourcePath))))
+	{
+		LD_CORE_WARN("Cooked texture {0} is older than its source, recook it", cookedPath);
+
+		return nullptr;
+	}
+
+	uint64_t mipTableSize = (uint64_t)header->MipCount * sizeof(CookedTextureMip);
+
+	if (header->MipCount == 0 || sizeof(CookedTextureHeader) + mipTableSize > fileSize)
+	{
+		LD_CORE_WARN("Cooked texture {0} is corrupt", cookedPath);
+
+		return nullptr;
+	}
+
+	const CookedTextureMip* mips = (const CookedTextureMip*)(texture->m_File.GetData() + sizeof(CookedTextureHeader));
+
+	if (!IsMipChainValid(*header, mips, fileSize))
+	{
+		LD_CORE_WARN("Cooked texture {0} is corrupt", cookedPath);
+
+		return nullptr;
+	}
+
+	// The contents still match, the container takes the source's new timestamp so later loads skip the hash, see MeshCacheFile::Open
+	if (timestampChanged)
+	{
+		texture->m_File.Close();
+
+		if (!FileSystem::PatchFile(cookedPath, offsetof(CookedTextureHeader, SourceTimestamp), &sourceTimestamp, sizeof(sourceTimestamp)))
+		{
+			LD_CORE_WARN("Could not update the source timestamp of cooked texture {0}", cookedPath);
+		}
+
+		if (!texture->m_File.Open(cookedPath) || texture->m_File.GetSize() != fileSize)
+		{
+			return nullptr;
+		}
+
+		header = (const CookedTextureHeader*)texture->m_File.GetData();
+		mips = (const CookedTextureMip*)(texture->m_File.GetData() + sizeof(CookedTextureHeader));
+	}
+
+	texture->m_Header = header;
+	texture->m_Mips = mips;
+
+	return texture;
+}
+
+bool CookedTexture::Write(const std::string& sourcePath, TextureCompression compression, bool srgb, const std::vector<CookedTextureMip>& mips, const std::vector<std::vector<uint8_t>>& mipData)
+{
+	LD_CORE_ASSERT(!mips.empty() && mips.size() == mipData.size());
+
+	CookedTextureHeader header = {};
+	header.Magic = s_CookedTextureMagic;
+	header.Version = s_CookedTextureVersion;
+	header.Compression = compression;
+	header.SRGB = srgb ? 1 : 0;
+	header.Width = mips[0].Width;
+	header.Height = mips[0].Height;
+	header.MipCount = (uint32_t)mips.size();
+
+	if (!FileSystem::GetFileInfo(sourcePath, header.SourceSize, header.SourceTimestamp))
+	{
+		return false;
+	}
+
+	header.SourceHash = FileSystem::HashFile(sourcePath);
+
+	std::vector<CookedTextureMip> mipTable = mips;
+
+	uint64_t mipTableSize = mipTable.size() * sizeof(CookedTextureMip);
+
+	// The mip table's offsets are filled in below, before anything is written
+	std::vector<FileSection> sections =
+	{
+		{ 0, &header, sizeof(CookedTextureHeader) },
+		{ sizeof(CookedTextureHeader), mipTable.data(), mipTableSize }
+	};
+
+	uint64_t offset = FileSystem::AlignOffset(sizeof(CookedTextureHeader) + mipTableSize, s_CookedTextureAlignment);
+
+	for (size_t i = 0; i < mipTable.size(); i++)
+	{
+		mipTable[i].Offset = offset;
+		mipTable[i].Size = mipData[i].size();
+
+		sections.push_back({ offset, mipData[i].data(), mipTable[i].Size });
+
+		offset = FileSystem::AlignOffset(offset + mipTable[i].Size, s_CookedTextureAlignment);
+	}
+
+	return FileSystem::WriteFile(GetCookedPath(sourcePath), sections);
+}
\ No newline at end of file
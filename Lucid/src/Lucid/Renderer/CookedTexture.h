@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Lucid/Core/MappedFile.h"
+
+// Container written by the texture cooker, holding a block compressed image with its full mip chain so loading needs no decoding or mip generation
+// Layout: header, mip table and the blocks of every mip from largest to smallest, every mip 16 byte aligned
+// Cooked textures sit beside their source image as "<source>.ldtex" and are picked up by Texture2D::Decode
+
+static constexpr uint32_t s_CookedTextureMagic = 0x5854444C; // "LDTX"
+static constexpr uint32_t s_CookedTextureVersion = 2;
+
+enum class TextureCompression : uint32_t
+{
+	None = 0,
+
+	// Opaque colour, 4 bits per texel
+	BC1 = 1,
+
+	// Colour and alpha, 8 bits per texel
+	BC3 = 2,
+
+	// Two channel normal maps, 8 bits per texel
+	BC5 = 3
+};
+
+struct CookedTextureHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+
+	TextureCompression Compression;
+
+	// Mips were filtered in linear space and the blocks hold sRGB encoded colour
+	uint32_t SRGB;
+
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t MipCount;
+	uint32_t Padding;
+
+	// The source image the texture was cooked from
+	uint64_t SourceSize;
+	int64_t SourceTimestamp;
+	uint64_t SourceHash;
+};
+
+struct CookedTextureMip
+{
+	uint32_t Width;
+	uint32_t Height;
+
+	uint64_t Offset;
+	uint64_t Size;
+};
+
+// Mapped cooked texture, mip data points into the mapping and stays valid for the lifetime of the file
+class CookedTexture : public RefCounted
+{
+
+public:
+
+	// Maps the cooked container of a source image, null when there is none, it was cooked for the other colour space or the source changed since
+	// A source whose timestamp moved but whose contents hash the same still matches, and the container takes the new timestamp
+	// A container is used without checking when its source is missing, so cooked textures can ship without their sources
+	static Ref<CookedTexture> Open(const std::string& sourcePath, bool srgb);
+
+	// Writes the container of a source image, mips from largest to smallest
+	static bool Write(const std::string& sourcePath, TextureCompression compression, bool srgb, const std::vector<CookedTextureMip>& mips, const std::vector<std::vector<uint8_t>>& mipData);
+
+	static std::string GetCookedPath(const std::string& sourcePath);
+
+	const CookedTextureHeader& GetHeader() const { return *m_Header; }
+
+	const CookedTextureMip& GetMip(uint32_t level) const { return m_Mips[level]; }
+	const uint8_t* GetMipData(uint32_t level) const { return m_File.GetData() + m_Mips[level].Offset; }
+
+	uint64_t GetFileSize() const { return m_File.GetSize(); }
+
+private:
+
+	MappedFile m_File;
+
+	const CookedTextureHeader* m_Header = nullptr;
+	const CookedTextureMip* m_Mips = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "ldpch.h"
+
+#include "CullingBounds.h"
+
+#include <xmmintrin.h>
+
+void CullingBounds::Resize(uint32_t count)
+{
+	m_Count = count;
+
+	uint32_t paddedCount = (count + s_BatchSize - 1) / s_BatchSize * s_BatchSize;
+
+	for (auto* array : { &m_CentreX, &m_CentreY, &m_CentreZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+	{
+		array->resize(paddedCount);
+	}
+
+	// Padding lanes are zero sized boxes, the batch test reads them but their results are discarded
+	for (uint32_t i = count; i < paddedCount; i++)
+	{
+		m_CentreX[i] = m_CentreY[i] = m_CentreZ[i] = 0.0f;
+		m_ExtentX[i] = m_ExtentY[i] = m_ExtentZ[i] = 0.0f;
+	}
+}
+
+// Centre is transformed as a point, extents are projected onto the world axes through the absolute of the upper 3x3 of the transform
+void CullingBounds::Set(uint32_t index, const AABB& bounds, const glm::mat4& transform)
+{
+	glm::vec3 centre = (bounds.Min + bounds.Max) * 0.5f;
+	glm::vec3 extent = (bounds.Max - bounds.Min) * 0.5f;
+
+	glm::vec3 worldCentre = glm::vec3(transform * glm::vec4(centre, 1.0f));
+
+	glm::vec3 worldExtent = glm::abs(glm::vec3(transform[0])) * extent.x
+		+ glm::abs(glm::vec3(transform[1])) * extent.y
+		+ glm::abs(glm::vec3(transform[2])) * extent.z;
+
+	m_CentreX[index] = worldCentre.x;
+	m_CentreY[index] = worldCentre.y;
+	m_CentreZ[index] = worldCentre.z;
+
+	m_ExtentX[index] = worldExtent.x;
+	m_ExtentY[index] = worldExtent.y;
+	m_ExtentZ[index] = worldExtent.z;
+}
+
+// A box is culled when centre distance plus projected radius is negative for any plane, four boxes are tested per iteration
+uint32_t CullingBounds::Cull(const Frustum& frustum, uint32_t first, uint32_t count, uint8_t* visibility) const
+{
+	LD_CORE_ASSERT(first % s_BatchSize == 0, "Cull range must start on a batch boundary");
+	LD_CORE_ASSERT(first + count <= m_Count, "Cull range out of bounds");
+
+	__m128 planeX[Frustum::PlaneCount];
+	__m128 planeY[Frustum::PlaneCount];
+	__m128 planeZ[Frustum::PlaneCount];
+	__m128 planeW[Frustum::PlaneCount];
+
+	__m128 absPlaneX[Frustum::PlaneCount];
+	__m128 absPlaneY[Frustum::PlaneCount];
+	__m128 absPlaneZ[Frustum::PlaneCount];
+
+	for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+	{
+		const glm::vec4& plane = frustum.Planes[i];
+
+		planeX[i] = _mm_set1_ps(plane.x);
+		planeY[i] = _mm_set1_ps(plane.y);
+		planeZ[i] = _mm_set1_ps(plane.z);
+		planeW[i] = _mm_set1_ps(plane.w);
+
+		absPlaneX[i] = _mm_set1_ps(fabsf(plane.x));
+		absPlaneY[i] = _mm_set1_ps(fabsf(plane.y));
+		absPlaneZ[i] = _mm_set1_ps(fabsf(plane.z));
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+
+	uint32_t visibleCount = 0;
+
+	for (uint32_t batch = 0; batch < count; batch += s_BatchSize)
+	{
+		uint32_t index = first + batch;
+
+		__m128 centreX = _mm_loadu_ps(&m_CentreX[index]);
+		__m128 centreY = _mm_loadu_ps(&m_CentreY[index]);
+		__m128 centreZ = _mm_loadu_ps(&m_CentreZ[index]);
+
+		__m128 extentX = _mm_loadu_ps(&m_ExtentX[index]);
+		__m128 extentY = _mm_loadu_ps(&m_ExtentY[index]);
+		__m128 extentZ = _mm_loadu_ps(&m_ExtentZ[index]);
+
+		// All bits set while a box is inside every plane tested so far
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+
+		for (uint32_t i = 0; i < Frustum::PlaneCount; i++)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[i], centreX), _mm_mul_ps(planeY[i], centreY)), _mm_add_ps(_mm_mul_ps(planeZ[i], centreZ), planeW[i]));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absPlaneX[i], extentX), _mm_mul_ps(absPlaneY[i], extentY)), _mm_mul_ps(absPlaneZ[i], extentZ));
+
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+
+		uint32_t batchCount = count - batch < s_BatchSize ? count - batch : s_BatchSize;
+
+		for (uint32_t i = 0; i < batchCount; i++)
+		{
+			uint8_t visible = (mask >> i) & 1;
+
+			visibility[batch + i] = visible;
+			visibleCount += visible;
+		}
+	}
+
+	return visibleCount;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Lucid/Core/Math/AABB.h"
+#include "Lucid/Core/Math/Frustum.h"
+
+// World space bounding boxes stored as a structure of arrays so four boxes are tested against a frustum plane per SIMD instruction
+// Storage is padded to a multiple of the batch size with empty boxes, Set may be called from several threads for distinct indices
+class CullingBounds
+{
+
+public:
+
+	static constexpr uint32_t s_BatchSize = 4;
+
+	void Resize(uint32_t count);
+
+	// Transforms a local space box into the world space box stored at index
+	void Set(uint32_t index, const AABB& bounds, const glm::mat4& transform);
+
+	// Tests count boxes from first (a multiple of the batch size), writes 1 or 0 per box from visibility[0] and returns the visible count
+	uint32_t Cull(const Frustum& frustum, uint32_t first, uint32_t count, uint8_t* visibility) const;
+
+	uint32_t GetCount() const { return m_Count; }
+	uint32_t GetPaddedCount() const { return (uint32_t)m_CentreX.size(); }
+
+private:
+
+	uint32_t m_Count = 0;
+
+	std::vector<float> m_CentreX;
+	std::vector<float> m_CentreY;
+	std::vector<float> m_CentreZ;
+
+	std::vector<float> m_ExtentX;
+	std::vector<float> m_ExtentY;
+	std::vector<float> m_ExtentZ;
+};
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Framebuffer.h"
 
 #include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderState.h"
 
 static GLenum SetFramebufferTextureType(FramebufferTextureType type)
 {
@@ -23,6 +24,131 @@ static GLenum SetFramebufferTextureType(FramebufferTextureType type)
 	return 0;
 }
 
+// Creates the texture of an attachment with its format and filtering, must be called on the render thread
+static RendererID CreateAttachmentTexture(const FramebufferTextureSpecification& textureSpec, uint32_t width, uint32_t height)
+{
+	bool depth = textureSpec.TextureUsage == FramebufferTextureUsage::DEPTH;
+	bool multisample = textureSpec.Samples > 1;
+
+	GLenum type = SetFramebufferTextureType(textureSpec.TextureType);
+
+	RendererID textureID = 0;
+
+	glCreateTextures(type, 1, &textureID);
+	glBindTexture(type, textureID);
+
+	if (depth)
+	{
+		// Multisample depth texture
+		if (multisample)
+		{
+			glTexStorage2DMultisample(type, textureSpec.Samples, GL_DEPTH24_STENCIL8, width, height, GL_FALSE);
+		}
+
+		// Standard depth texture
+		else
+		{
+			glTexImage2D(type, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+
+			// Set depth texture minification filtering
+			if (textureSpec.MinFilter == FramebufferTextureFiltering::LINEAR)
+			{
+				glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			}
+			else if (textureSpec.MinFilter == FramebufferTextureFiltering::NEAREST)
+			{
+				glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			}
+
+			// Set depth texture magnification filtering
+			if (textureSpec.MagFilter == FramebufferTextureFiltering::LINEAR)
+			{
+				glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			}
+			else if (textureSpec.MagFilter == FramebufferTextureFiltering::NEAREST)
+			{
+				glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+
+		}
+	}
+	else
+	{
+		// Multisample texture
+		if (multisample)
+		{
+			if (textureSpec.Format == FramebufferTextureFormat::RGBA16F)
+			{
+				glTexImage2DMultisample(type, textureSpec.Samples, GL_RGBA16F, width, height, GL_FALSE);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RGBA8)
+			{
+				glTexStorage2DMultisample(type, textureSpec.Samples, GL_RGBA8, width, height, GL_FALSE);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RED8)
+			{
+				glTexStorage2DMultisample(type, textureSpec.Samples, GL_RED, width, height, GL_FALSE);
+			}
+		}
+
+		// Standard texture
+		else
+		{
+			// Set texture format
+			if (textureSpec.Format == FramebufferTextureFormat::RGBA16F)
+			{
+				glTexImage2D(type, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RGBA8)
+			{
+				glTexImage2D(type, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RED8)
+			{
+				glTexImage2D(type, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RG16F)
+			{
+				glTexImage2D(type, 0, GL_RG16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RG16F_RECT)
+			{
+				glTexImage2D(type, 0, GL_RG32F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RGB8F_RECT)
+			{
+				glTexImage2D(type, 0, GL_RGB, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
+			}
+			else if (textureSpec.Format == FramebufferTextureFormat::RGBA8F_RECT)
+			{
+				glTexImage2D(type, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+			}
+
+			// Set texture minification filtering
+			if (textureSpec.MinFilter == FramebufferTextureFiltering::LINEAR)
+			{
+				glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			}
+			else if (textureSpec.MinFilter == FramebufferTextureFiltering::NEAREST)
+			{
+				glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			}
+
+			// Set texture magnification filtering
+			if (textureSpec.MagFilter == FramebufferTextureFiltering::LINEAR)
+			{
+				glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			}
+			else if (textureSpec.MagFilter == FramebufferTextureFiltering::NEAREST)
+			{
+				glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+		}
+	}
+
+	return textureID;
+}
+
 template <typename ... Args>
 void Framebuffer::DrawBuffers(Args ... args)
 {
@@ -55,6 +181,92 @@ Ref<Framebuffer> Framebuffer::Create(const FramebufferSpecification& spec)
 	return result;
 }
 
+// Size of a texel in video memory
+static uint32_t GetBytesPerPixel(FramebufferTextureFormat format)
+{
+	switch (format)
+	{
+		case FramebufferTextureFormat::RED8:
+		{
+			return 1;
+		}
+		case FramebufferTextureFormat::RGBA8:
+		{
+			return 4;
+		}
+		case FramebufferTextureFormat::RG16F:
+		{
+			return 4;
+		}
+		case FramebufferTextureFormat::DEPTH24STENCIL8:
+		{
+			return 4;
+		}
+		case FramebufferTextureFormat::RGBA16F:
+		{
+			return 8;
+		}
+
+		// Rectangle formats are created as RG32F, RGB8 (padded to four bytes by drivers) and RGBA8
+		case FramebufferTextureFormat::RG16F_RECT:
+		{
+			return 8;
+		}
+		case FramebufferTextureFormat::RGB8F_RECT:
+		{
+			return 4;
+		}
+		case FramebufferTextureFormat::RGBA8F_RECT:
+		{
+			return 4;
+		}
+	}
+
+	return 0;
+}
+
+uint64_t Framebuffer::GetAttachmentMemory(const FramebufferTextureSpecification& spec, uint32_t width, uint32_t height)
+{
+	return (uint64_t)width * height * GetBytesPerPixel(spec.Format) * std::max(spec.Samples, 1u);
+}
+
+// Textures that keep their size and format are kept around for a while so culled passes coming back do not reallocate
+static constexpr uint64_t s_TransientTextureFrames = 60;
+
+static bool IsTransientTextureCompatible(const TransientTexture& texture, const FramebufferTextureSpecification& spec, uint32_t width, uint32_t height)
+{
+	const FramebufferTextureSpecification& textureSpec = texture.GetSpecification();
+
+	return texture.GetWidth() == width && texture.GetHeight() == height
+		&& textureSpec.TextureType == spec.TextureType && textureSpec.TextureUsage == spec.TextureUsage && textureSpec.Format == spec.Format
+		&& textureSpec.MinFilter == spec.MinFilter && textureSpec.MagFilter == spec.MagFilter && textureSpec.Samples == spec.Samples;
+}
+
+TransientTexture::TransientTexture(const FramebufferTextureSpecification& spec, uint32_t width, uint32_t height)
+	: m_Specification(spec), m_Width(width), m_Height(height)
+{
+	Ref<TransientTexture> instance = this;
+
+	Renderer::Submit([instance]() mutable
+	{
+		instance->m_RendererID = CreateAttachmentTexture(instance->m_Specification, instance->m_Width, instance->m_Height);
+
+		RenderState::Invalidate();
+	});
+}
+
+TransientTexture::~TransientTexture()
+{
+	GLuint rendererID = m_RendererID;
+
+	Renderer::Submit([rendererID]()
+	{
+		glDeleteTextures(1, &rendererID);
+
+		RenderState::Invalidate();
+	});
+}
+
 FramebufferPool* FramebufferPool::s_Instance = new FramebufferPool;
 
 FramebufferPool::FramebufferPool(uint32_t maxFBs)
@@ -65,9 +277,87 @@ FramebufferPool::~FramebufferPool()
 {
 }
 
-std::weak_ptr<Framebuffer> FramebufferPool::AllocateBuffer()
+void FramebufferPool::BeginFrame()
+{
+	m_Frame++;
+	m_FrameAllocations = 0;
+}
+
+// Greedy interval assignment, with allocations ordered by first pass reusing any texture whose last use ended before it needs the fewest textures
+Ref<TransientTexture> FramebufferPool::AllocateBuffer(const FramebufferTextureSpecification& spec, uint32_t width, uint32_t height, uint32_t firstPass, uint32_t lastPass)
+{
+	LD_CORE_ASSERT(firstPass <= lastPass, "Transient attachment is used before it is written");
+
+	m_FrameAllocations++;
+
+	for (Ref<TransientTexture>& texture : m_TransientTextures)
+	{
+		if (!IsTransientTextureCompatible(*texture, spec, width, height))
+		{
+			continue;
+		}
+
+		if (texture->m_LastFrame != m_Frame || texture->m_LastPass < firstPass)
+		{
+			texture->m_LastFrame = m_Frame;
+			texture->m_LastPass = lastPass;
+
+			return texture;
+		}
+	}
+
+	Ref<TransientTexture> texture = Ref<TransientTexture>::Create(spec, width, height);
+	texture->m_LastFrame = m_Frame;
+	texture->m_LastPass = lastPass;
+
+	m_TransientTextures.push_back(texture);
+
+	return texture;
+}
+
+void FramebufferPool::EndFrame()
+{
+	for (Ref<Framebuffer>& framebuffer : m_Pool)
+	{
+		framebuffer->ReleaseTransientAttachments(m_Frame);
+	}
+
+	m_TransientTextures.erase(std::remove_if(m_TransientTextures.begin(), m_TransientTextures.end(), [this](const Ref<TransientTexture>& texture)
+	{
+		return texture->m_LastFrame + s_TransientTextureFrames < m_Frame;
+	}), m_TransientTextures.end());
+}
+
+FramebufferPoolStats FramebufferPool::GetStats() const
 {
-	return std::weak_ptr<Framebuffer>();
+	FramebufferPoolStats stats;
+
+	for (const Ref<Framebuffer>& framebuffer : m_Pool)
+	{
+		const FramebufferSpecification& spec = framebuffer->GetSpecification();
+
+		for (const auto& [attachmentPoint, textureSpec] : spec.m_AttachmentSpecs)
+		{
+			uint64_t memory = Framebuffer::GetAttachmentMemory(textureSpec, spec.Width, spec.Height);
+
+			stats.UnaliasedMemory += memory;
+
+			if (!textureSpec.Transient)
+			{
+				stats.AliasedMemory += memory;
+			}
+		}
+	}
+
+	for (const Ref<TransientTexture>& texture : m_TransientTextures)
+	{
+		stats.AliasedMemory += Framebuffer::GetAttachmentMemory(texture->GetSpecification(), texture->GetWidth(), texture->GetHeight());
+	}
+
+	stats.TransientAttachments = m_FrameAllocations;
+	stats.TransientTextures = (uint32_t)m_TransientTextures.size();
+
+	return stats;
 }
 
 void FramebufferPool::Add(Ref<Framebuffer> framebuffer)
@@ -83,11 +373,13 @@ Framebuffer::Framebuffer(const FramebufferSpecification& spec)
 
 Framebuffer::~Framebuffer()
 {
-	Ref<Framebuffer> instance = this;
+	GLuint rendererID = m_RendererID;
 
-	Renderer::Submit([instance]()
+	Renderer::Submit([rendererID]()
 	{
-		glDeleteFramebuffers(1, &instance->m_RendererID);
+		glDeleteFramebuffers(1, &rendererID);
+
+		RenderState::Invalidate();
 	});
 }
 
@@ -102,23 +394,39 @@ void Framebuffer::Resize(uint32_t width, uint32_t height, bool forceRecreate)
 	m_Specification.Width = width;
 	m_Specification.Height = height;
 
+	m_ViewportWidth = width;
+	m_ViewportHeight = height;
+
+	// Pooled textures have the old size, the next frame assigns new ones
+	m_TransientAttachments.clear();
+
 	Ref<Framebuffer> instance = this;
 
 	Renderer::Submit([instance]() mutable
 	{
-		// If a framebuffer exists, delete all its associated textures and the framebuffer
+		std::lock_guard<std::mutex> lock(instance->m_AttachmentMutex);
+
+		const auto& attachmentSpecs = instance->m_Specification.m_AttachmentSpecs;
+
+		// If a framebuffer exists, delete all its associated textures and the framebuffer, transient textures belong to the pool
 		if (instance->m_RendererID)
 		{
 			// Delete colour attachments
 			for (auto& [attachmentPoint, textureID] : instance->m_ColourAttachments)
 			{
-				glDeleteTextures(1, &textureID);
+				if (!attachmentSpecs.at(attachmentPoint).Transient)
+				{
+					glDeleteTextures(1, &textureID);
+				}
 			}
 
 			// Delete depth attachments
 			for (auto& [attachmentPoint, textureID] : instance->m_DepthAttachments)
 			{
-				glDeleteTextures(1, &textureID);
+				if (!attachmentSpecs.at(attachmentPoint).Transient)
+				{
+					glDeleteTextures(1, &textureID);
+				}
 			}
 
 			// Clear both maps
@@ -129,144 +437,28 @@ void Framebuffer::Resize(uint32_t width, uint32_t height, bool forceRecreate)
 		}
 
 		glCreateFramebuffers(1, &instance->m_RendererID);
-		glBindFramebuffer(GL_FRAMEBUFFER, instance->m_RendererID);
+		RenderState::BindFramebuffer(instance->m_RendererID);
+
+		bool transient = false;
 
-		for (auto& [attachmentPoint, textureSpec] : instance->m_Specification.m_AttachmentSpecs)
+		for (auto& [attachmentPoint, textureSpec] : attachmentSpecs)
 		{
 			bool depth = textureSpec.TextureUsage == FramebufferTextureUsage::DEPTH;
-			bool multisample = textureSpec.Samples > 1;
 
-			GLenum type = SetFramebufferTextureType(instance->GetSpecification().m_AttachmentSpecs.at(attachmentPoint).TextureType);
+			RendererID& textureID = depth ? instance->m_DepthAttachments[attachmentPoint] : instance->m_ColourAttachments[attachmentPoint];
 
-			if (depth)
+			// Transient attachments are attached once the pool assigns them a texture
+			if (textureSpec.Transient)
 			{
-				RendererID& textureID = instance->m_DepthAttachments[attachmentPoint];
-
-				// Multisample depth texture
-				if (multisample)
-				{
-					glCreateTextures(type, 1, &textureID);
-					glBindTexture(type, textureID);
-
-					glTexStorage2DMultisample(type, textureSpec.Samples, GL_DEPTH24_STENCIL8, instance->m_Specification.Width, instance->m_Specification.Height, GL_FALSE);
-
-					glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, textureID, 0);
-				}
+				textureID = 0;
+				transient = true;
 
-				// Standard depth texture
-				else
-				{
-					glCreateTextures(type, 1, &textureID);
-					glBindTexture(type, textureID);
-
-					glTexImage2D(type, 0, GL_DEPTH24_STENCIL8, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
-
-					// Set depth texture minification filtering
-					if (textureSpec.MinFilter == FramebufferTextureFiltering::LINEAR)
-					{
-						glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-					}
-					else if (textureSpec.MinFilter == FramebufferTextureFiltering::NEAREST)
-					{
-						glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-					}
-
-					// Set depth texture magnification filtering
-					if (textureSpec.MagFilter == FramebufferTextureFiltering::LINEAR)
-					{
-						glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-					}
-					else if (textureSpec.MagFilter == FramebufferTextureFiltering::NEAREST)
-					{
-						glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-					}
-
-					glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, textureID, 0);
-				}
+				continue;
 			}
-			else
-			{
-				RendererID& textureID = instance->m_ColourAttachments[attachmentPoint];
 
-				// Multisample texture
-				if (multisample)
-				{
-					glCreateTextures(type, 1, &textureID);
-					glBindTexture(type, textureID);
-
-					if (textureSpec.Format == FramebufferTextureFormat::RGBA16F)
-					{
-						glTexImage2DMultisample(type, textureSpec.Samples, GL_RGBA16F, instance->m_Specification.Width, instance->m_Specification.Height, GL_FALSE);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RGBA8)
-					{
-						glTexStorage2DMultisample(type, textureSpec.Samples, GL_RGBA8, instance->m_Specification.Width, instance->m_Specification.Height, GL_FALSE);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RED8)
-					{
-						glTexStorage2DMultisample(type, textureSpec.Samples, GL_RED, instance->m_Specification.Width, instance->m_Specification.Height, GL_FALSE);
-					}
-				}
-
-				// Standard texture
-				else
-				{
-					glCreateTextures(type, 1, &textureID);
-					glBindTexture(type, textureID);
-
-					// Set texture format
-					if (textureSpec.Format == FramebufferTextureFormat::RGBA16F)
-					{
-						glTexImage2D(type, 0, GL_RGBA16F, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_RGBA, GL_FLOAT, nullptr);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RGBA8)
-					{
-						glTexImage2D(type, 0, GL_RGBA, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RED8)
-					{
-						glTexImage2D(type, 0, GL_RED, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RG16F)
-					{
-						glTexImage2D(type, 0, GL_RG16F, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_RGBA, GL_FLOAT, nullptr);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RG16F_RECT)
-					{
-						glTexImage2D(type, 0, GL_RG32F, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_RGB, GL_FLOAT, nullptr);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RGB8F_RECT)
-					{
-						glTexImage2D(type, 0, GL_RGB, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_RGB, GL_FLOAT, nullptr);
-					}
-					else if (textureSpec.Format == FramebufferTextureFormat::RGBA8F_RECT)
-					{
-						glTexImage2D(type, 0, GL_RGBA, instance->m_Specification.Width, instance->m_Specification.Height, 0, GL_RGBA, GL_FLOAT, nullptr);
-					}
-
-					// Set texture minification filtering
-					if (textureSpec.MinFilter == FramebufferTextureFiltering::LINEAR)
-					{
-						glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-					}
-					else if (textureSpec.MinFilter == FramebufferTextureFiltering::NEAREST)
-					{
-						glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-					}
-
-					// Set texture magnification filtering
-					if (textureSpec.MagFilter == FramebufferTextureFiltering::LINEAR)
-					{
-						glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-					}
-					else if (textureSpec.MagFilter == FramebufferTextureFiltering::NEAREST)
-					{
-						glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-					}
-				}
+			textureID = CreateAttachmentTexture(textureSpec, instance->m_Specification.Width, instance->m_Specification.Height);
 
-				glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachmentPoint, textureID, 0);
-			}
+			glFramebufferTexture(GL_FRAMEBUFFER, depth ? GL_DEPTH_STENCIL_ATTACHMENT : GL_COLOR_ATTACHMENT0 + attachmentPoint, textureID, 0);
 		}
 
 		// Set draw buffers
@@ -282,12 +474,67 @@ void Framebuffer::Resize(uint32_t width, uint32_t height, bool forceRecreate)
 			glDrawBuffers(instance->m_ColourAttachments.size(), attachments.data());
 		}
 
-		LD_CORE_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
+		// Completeness of framebuffers with transient attachments depends on the textures they are assigned
+		LD_CORE_ASSERT(transient || glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::BindFramebuffer(0);
+
+		// Attachments were deleted and recreated with glBindTexture
+		RenderState::Invalidate();
 	});
 }
 
+void Framebuffer::SetTransientAttachment(uint32_t attachmentPoint, const Ref<TransientTexture>& texture, uint64_t frame)
+{
+	const FramebufferTextureSpecification& textureSpec = m_Specification.m_AttachmentSpecs.at(attachmentPoint);
+
+	LD_CORE_ASSERT(textureSpec.Transient, "Only transient attachments take pooled textures");
+
+	TransientAttachment& attachment = m_TransientAttachments[attachmentPoint];
+	attachment.Frame = frame;
+
+	// Assignments are stable from frame to frame unless lifetimes or sizes change
+	if (attachment.Texture.Raw() == texture.Raw())
+	{
+		return;
+	}
+
+	attachment.Texture = texture;
+
+	bool depth = textureSpec.TextureUsage == FramebufferTextureUsage::DEPTH;
+
+	Ref<Framebuffer> instance = this;
+
+	Renderer::Submit([instance, attachmentPoint, texture, depth]()
+	{
+		std::lock_guard<std::mutex> lock(instance->m_AttachmentMutex);
+
+		RendererID textureID = texture ? texture->GetRendererID() : 0;
+
+		glNamedFramebufferTexture(instance->m_RendererID, depth ? GL_DEPTH_STENCIL_ATTACHMENT : GL_COLOR_ATTACHMENT0 + attachmentPoint, textureID, 0);
+
+		if (depth)
+		{
+			instance->m_DepthAttachments[attachmentPoint] = textureID;
+		}
+		else
+		{
+			instance->m_ColourAttachments[attachmentPoint] = textureID;
+		}
+	});
+}
+
+void Framebuffer::ReleaseTransientAttachments(uint64_t frame)
+{
+	for (auto& [attachmentPoint, attachment] : m_TransientAttachments)
+	{
+		if (attachment.Texture && attachment.Frame != frame)
+		{
+			SetTransientAttachment(attachmentPoint, nullptr, frame);
+		}
+	}
+}
+
 void Framebuffer::Clear(float r, float g, float b, float a)
 {
 	Renderer::Submit([=]()
@@ -298,13 +545,24 @@ void Framebuffer::Clear(float r, float g, float b, float a)
 	});
 }
 
+void Framebuffer::SetViewport(uint32_t width, uint32_t height)
+{
+	LD_CORE_ASSERT(width <= m_Specification.Width && height <= m_Specification.Height, "Viewport is larger than the framebuffer");
+
+	m_ViewportWidth = width;
+	m_ViewportHeight = height;
+}
+
 void Framebuffer::Bind() const
 {
+	uint32_t viewportWidth = m_ViewportWidth;
+	uint32_t viewportHeight = m_ViewportHeight;
+
 	Renderer::Submit([=]()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+		RenderState::BindFramebuffer(m_RendererID);
 
-		glViewport(0, 0, m_Specification.Width, m_Specification.Height);
+		glViewport(0, 0, viewportWidth, viewportHeight);
 	});
 }
 
@@ -312,26 +570,41 @@ void Framebuffer::Unbind() const
 {
 	Renderer::Submit([=]()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::BindFramebuffer(0);
 	});
 }
 
 void Framebuffer::BindColourAttachment(uint32_t attachmentIndex, uint32_t textureUnit) const
 {
-	RendererID colourAttachmentID = m_ColourAttachments.at(attachmentIndex);
+	Ref<const Framebuffer> instance = this;
 
-	Renderer::Submit([=]()
+	// Attachment is resolved when the command executes as a pending resize may recreate it
+	Renderer::Submit([instance, attachmentIndex, textureUnit]()
 	{
-		glBindTextureUnit(textureUnit, colourAttachmentID);
+		RenderState::BindTextureUnit(textureUnit, instance->m_ColourAttachments.at(attachmentIndex));
 	});
 }
 
 void Framebuffer::BindDepthAttachment(uint32_t attachmentIndex, uint32_t textureUnit) const
 {
-	RendererID depthAttachmentID = m_DepthAttachments.at(attachmentIndex);
+	Ref<const Framebuffer> instance = this;
 
-	Renderer::Submit([=]()
+	Renderer::Submit([instance, attachmentIndex, textureUnit]()
 	{
-		glBindTextureUnit(textureUnit, depthAttachmentID);
+		RenderState::BindTextureUnit(textureUnit, instance->m_DepthAttachments.at(attachmentIndex));
 	});
+}
+
+RendererID Framebuffer::GetColourAttachmentRendererID(uint32_t attachment) const
+{
+	std::lock_guard<std::mutex> lock(m_AttachmentMutex);
+
+	return m_ColourAttachments.at(attachment);
+}
+
+RendererID Framebuffer::GetDepthAttachmentRendererID(uint32_t attachment) const
+{
+	std::lock_guard<std::mutex> lock(m_AttachmentMutex);
+
+	return m_DepthAttachments.at(attachment);
 }
\ No newline at end of file
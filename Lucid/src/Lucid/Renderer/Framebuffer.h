@@ -4,6 +4,8 @@
 
 #include <glm/glm.hpp>
 
+#include <mutex>
+
 enum class FramebufferTextureType
 {
 	TEX2D = 0,
@@ -59,6 +61,9 @@ struct FramebufferTextureSpecification
 	FramebufferTextureFiltering MagFilter = FramebufferTextureFiltering::LINEAR;
 
 	uint32_t Samples = 1;
+
+	// Texture is borrowed from the framebuffer pool each frame and may be shared with attachments whose lifetimes do not overlap
+	bool Transient = false;
 };
 
 struct FramebufferSpecification
@@ -79,6 +84,38 @@ struct FramebufferSpecification
 	}
 };
 
+// Pooled texture backing transient attachments, created on the render thread
+class TransientTexture : public RefCounted
+{
+
+public:
+
+	TransientTexture(const FramebufferTextureSpecification& spec, uint32_t width, uint32_t height);
+	~TransientTexture();
+
+	RendererID GetRendererID() const { return m_RendererID; }
+
+	const FramebufferTextureSpecification& GetSpecification() const { return m_Specification; }
+
+	uint32_t GetWidth() const { return m_Width; }
+	uint32_t GetHeight() const { return m_Height; }
+
+private:
+
+	FramebufferTextureSpecification m_Specification;
+
+	uint32_t m_Width;
+	uint32_t m_Height;
+
+	RendererID m_RendererID = 0;
+
+	// Pool frame the texture was last handed out in and the last pass of that frame that uses it
+	uint64_t m_LastFrame = 0;
+	uint32_t m_LastPass = 0;
+
+	friend class FramebufferPool;
+};
+
 class Framebuffer : public RefCounted
 {
 
@@ -92,19 +129,34 @@ public:
 
 	void Resize(uint32_t width, uint32_t height, bool forceRecreate = false);
 
+	// Region rendered to when bound, anchored at the origin and no larger than the attachments, reset to the full size by a resize
+	void SetViewport(uint32_t width, uint32_t height);
+
+	uint32_t GetViewportWidth() const { return m_ViewportWidth; }
+	uint32_t GetViewportHeight() const { return m_ViewportHeight; }
+
 	void Clear(float r, float g, float b, float a);
 
 	void BindColourAttachment(uint32_t textureAttachmentIndex = 0, uint32_t textureUnit = 0) const;
 	void BindDepthAttachment(uint32_t textureAttachmentIndex = 0, uint32_t textureUnit = 0) const;
 
 	RendererID GetRendererID() const { return m_RendererID; }
-	RendererID GetColourAttachmentRendererID(uint32_t attachment = 0) const { return m_ColourAttachments.at(attachment); }
-	RendererID GetDepthAttachmentRendererID(uint32_t attachment = 0) const { return m_DepthAttachments.at(attachment); }
+	RendererID GetColourAttachmentRendererID(uint32_t attachment = 0) const;
+	RendererID GetDepthAttachmentRendererID(uint32_t attachment = 0) const;
 
 	const FramebufferSpecification& GetSpecification() const { return m_Specification; }
 
+	// Attaches a pooled texture to a transient attachment point for the given pool frame
+	void SetTransientAttachment(uint32_t attachmentPoint, const Ref<TransientTexture>& texture, uint64_t frame);
+
+	// Detaches transient attachments that were not assigned during the given pool frame so their textures can be freed
+	void ReleaseTransientAttachments(uint64_t frame);
+
 	static Ref<Framebuffer> Create(const FramebufferSpecification& spec);
 
+	// Bytes of video memory an attachment texture of the given size takes up
+	static uint64_t GetAttachmentMemory(const FramebufferTextureSpecification& spec, uint32_t width, uint32_t height);
+
 	template<typename ...Args>
 	void DrawBuffers(Args ...args);
 
@@ -112,13 +164,42 @@ private:
 
 	FramebufferSpecification m_Specification;
 
+	uint32_t m_ViewportWidth = 0;
+	uint32_t m_ViewportHeight = 0;
+
 	// Attachment point + texture ID
 	std::unordered_map<uint32_t, RendererID> m_ColourAttachments;
 	std::unordered_map<uint32_t, RendererID> m_DepthAttachments;
 
+	// Attachments are recreated on the render thread and may be queried from the main thread
+	mutable std::mutex m_AttachmentMutex;
+
+	struct TransientAttachment
+	{
+		Ref<TransientTexture> Texture;
+		uint64_t Frame = 0;
+	};
+
+	// Pooled textures assigned on the main thread, attachment point + texture
+	std::unordered_map<uint32_t, TransientAttachment> m_TransientAttachments;
+
 	RendererID m_RendererID = 0;
 };
 
+// Render target memory of every framebuffer in the pool
+struct FramebufferPoolStats
+{
+	// Bytes if every attachment owned a texture of its own
+	uint64_t UnaliasedMemory = 0;
+
+	// Bytes of the persistent attachments plus the pooled transient textures
+	uint64_t AliasedMemory = 0;
+
+	// Transient attachments assigned in the last frame and the textures backing them
+	uint32_t TransientAttachments = 0;
+	uint32_t TransientTextures = 0;
+};
+
 class FramebufferPool final
 {
 
@@ -127,7 +208,20 @@ public:
 	FramebufferPool(uint32_t maxFBs = 32);
 	~FramebufferPool();
 
-	std::weak_ptr<Framebuffer> AllocateBuffer();
+	// Starts a new frame of transient allocations, every pooled texture becomes free again
+	void BeginFrame();
+
+	// Texture matching the attachment spec and size that no other attachment uses between the first and last pass, passes are numbered in frame order
+	// Allocations within a frame must be made in order of their first pass
+	Ref<TransientTexture> AllocateBuffer(const FramebufferTextureSpecification& spec, uint32_t width, uint32_t height, uint32_t firstPass, uint32_t lastPass);
+
+	// Detaches transient attachments that were not allocated this frame and frees textures that have gone unused for a few frames
+	void EndFrame();
+
+	uint64_t GetFrame() const { return m_Frame; }
+
+	FramebufferPoolStats GetStats() const;
+
 	void Add(Ref<Framebuffer> framebuffer);
 
 	std::vector<Ref<Framebuffer>>& GetAll() { return m_Pool; }
@@ -139,5 +233,10 @@ private:
 
 	std::vector<Ref<Framebuffer>> m_Pool;
 
+	std::vector<Ref<TransientTexture>> m_TransientTextures;
+
+	uint64_t m_Frame = 0;
+	uint32_t m_FrameAllocations = 0;
+
 	static FramebufferPool* s_Instance;
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "ldpch.h"
+
+#include "GBufferPacking.h"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Worst case angle between a normal and its 24-bit octahedral round trip
+static constexpr float s_MaxNormalErrorDegrees = 0.07f;
+
+void ValidateGBufferPacking()
+{
+	// Normals over a latitude and longitude sweep of the whole sphere, which covers both halves of the octahedron and its folded edges
+	static constexpr uint32_t s_Rings = 32;
+	static constexpr uint32_t s_Segments = 64;
+
+	float worstError = 0.0f;
+
+	for (uint32_t ring = 0; ring <= s_Rings; ring++)
+	{
+		float theta = glm::pi<float>() * ring / s_Rings;
+
+		for (uint32_t segment = 0; segment < s_Segments; segment++)
+		{
+			float phi = glm::two_pi<float>() * segment / s_Segments;
+
+			glm::vec3 normal = glm::vec3(sinf(theta) * cosf(phi), sinf(theta) * sinf(phi), cosf(theta));
+
+			glm::vec3 decoded = UnpackNormal(PackNormalGloss(normal, 0.0f));
+
+			worstError = std::max(worstError, glm::degrees(acosf(glm::clamp(glm::dot(normal, decoded), -1.0f, 1.0f))));
+		}
+	}
+
+	LD_CORE_ASSERT(worstError <= s_MaxNormalErrorDegrees, "Octahedral normal round trip is off by too much!");
+
+	// Quantised axes survive the spread over three channels unchanged, the odd strides reach every nibble of both axes
+	for (uint32_t x = 0; x < 4096; x += 61)
+	{
+		for (uint32_t y = 0; y < 4096; y += 67)
+		{
+			glm::vec2 encoded = glm::vec2(x, y) / 4095.0f * 2.0f - 1.0f;
+
+			glm::vec2 unpacked = UnpackOctahedral24(PackOctahedral24(encoded));
+
+			LD_CORE_ASSERT(glm::all(glm::lessThan(glm::abs(unpacked - encoded), glm::vec2(1e-5f))), "24-bit octahedral packing is not lossless!");
+		}
+	}
+
+	for (uint32_t value = 0; value < 256; value++)
+	{
+		LD_CORE_ASSERT(PackUnorm8(value / 255.0f) == value, "Unorm8 packing does not round trip!");
+	}
+
+	// A point projected to clip space comes back from its texture coordinate and depth
+	glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f) * glm::lookAt(glm::vec3(3.0f, 2.0f, 5.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	glm::vec3 point = glm::vec3(0.5f, -0.25f, 1.0f);
+
+	glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+	glm::vec3 ndc = glm::vec3(clip) / clip.w;
+
+	glm::vec3 reconstructed = ReconstructPosition(glm::vec2(ndc) * 0.5f + 0.5f, ndc.z * 0.5f + 0.5f, glm::inverse(viewProjection));
+
+	LD_CORE_ASSERT(glm::length(reconstructed - point) < 1e-3f, "Position reconstruction from depth is off!");
+}
\ No newline at end of file
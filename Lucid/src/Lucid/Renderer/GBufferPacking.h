@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// CPU reference of the compact g-buffer encoding, mirrors the functions of the same names in Buffer.glsl, Lighting.glsl and LightVolume.glsl
+// Compact layout: target 0 is RGBA8 albedo + specular, target 1 is RGBA8 octahedral normal (12 bits per axis across rgb) + gloss, position comes from depth
+
+// Folds the lower hemisphere of the octahedron over the upper one
+inline glm::vec2 OctahedralWrap(const glm::vec2& v)
+{
+	return (glm::vec2(1.0f) - glm::abs(glm::vec2(v.y, v.x))) * glm::vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+// Unit vector to a point on the [-1, 1] square
+inline glm::vec2 OctahedralEncode(glm::vec3 normal)
+{
+	normal /= fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+
+	glm::vec2 encoded = glm::vec2(normal.x, normal.y);
+
+	return normal.z >= 0.0f ? encoded : OctahedralWrap(encoded);
+}
+
+inline glm::vec3 OctahedralDecode(const glm::vec2& encoded)
+{
+	glm::vec3 normal = glm::vec3(encoded.x, encoded.y, 1.0f - fabsf(encoded.x) - fabsf(encoded.y));
+
+	float t = glm::clamp(-normal.z, 0.0f, 1.0f);
+
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+
+	return glm::normalize(normal);
+}
+
+// Quantises both axes to 12 bits and spreads them over three 8-bit channels
+inline glm::u8vec3 PackOctahedral24(const glm::vec2& encoded)
+{
+	glm::uvec2 quantised = glm::uvec2(glm::round(glm::clamp(encoded * 0.5f + 0.5f, 0.0f, 1.0f) * 4095.0f));
+
+	return glm::u8vec3(quantised.x >> 4, ((quantised.x & 15u) << 4) | (quantised.y >> 8), quantised.y & 255u);
+}
+
+inline glm::vec2 UnpackOctahedral24(const glm::u8vec3& packed)
+{
+	glm::uvec2 quantised = glm::uvec2(((uint32_t)packed.x << 4) | ((uint32_t)packed.y >> 4), (((uint32_t)packed.y & 15u) << 8) | (uint32_t)packed.z);
+
+	return glm::vec2(quantised) / 4095.0f * 2.0f - 1.0f;
+}
+
+// Matches the GPU's conversion of a float output to an 8-bit normalised channel
+inline uint8_t PackUnorm8(float value)
+{
+	return (uint8_t)(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+inline glm::u8vec4 PackAlbedoSpecular(const glm::vec3& albedo, float specular)
+{
+	return glm::u8vec4(PackUnorm8(albedo.r), PackUnorm8(albedo.g), PackUnorm8(albedo.b), PackUnorm8(specular));
+}
+
+inline glm::u8vec4 PackNormalGloss(const glm::vec3& normal, float gloss)
+{
+	glm::u8vec3 packed = PackOctahedral24(OctahedralEncode(normal));
+
+	return glm::u8vec4(packed, PackUnorm8(gloss));
+}
+
+inline glm::vec3 UnpackNormal(const glm::u8vec4& normalGloss)
+{
+	return OctahedralDecode(UnpackOctahedral24(glm::u8vec3(normalGloss)));
+}
+
+// World space position of a pixel from its [0, 1] texture coordinate and depth buffer value, OpenGL [-1, 1] clip space depth
+inline glm::vec3 ReconstructPosition(const glm::vec2& texCoord, float depth, const glm::mat4& inverseViewProjection)
+{
+	glm::vec4 position = inverseViewProjection * glm::vec4(glm::vec3(texCoord, depth) * 2.0f - 1.0f, 1.0f);
+
+	return glm::vec3(position) / position.w;
+}
+
+// CPU self-check of the reference above, round trips each part of the encoding a few thousand times and asserts on any error above what the compact layout promises
+// It does not run the shaders, Buffer.glsl and Lighting.glsl still have to be kept in step with this file by hand
+void ValidateGBufferPacking();
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "ldpch.h"
+
+#include "LightClusters.h"
+
+#include <xmmintrin.h>
+
+#include "Lucid/Core/ThreadPool.h"
+
+static constexpr uint32_t s_BatchSize = 4;
+static constexpr uint32_t s_TilesPerSlice = LightClusterGrid::s_GridX * LightClusterGrid::s_GridY;
+
+// Avoids log(0) for projections with a zero or negative near plane
+static constexpr float s_MinNearPlane = 1e-4f;
+
+// Lighting.glsl scales a light by brightness / (brightness + quadratic * d^2), solving intensity * that = cutoff for d
+float LightClusterGrid::GetPointLightRadius(float brightness, float quadratic, float intensity, float cutoff)
+{
+	if (brightness <= 0.0f || intensity <= cutoff)
+	{
+		return 0.0f;
+	}
+
+	// Without falloff the light reaches everything
+	if (quadratic <= 0.0f)
+	{
+		return std::numeric_limits<float>::max();
+	}
+
+	return sqrtf((intensity / cutoff - 1.0f) * brightness / quadratic);
+}
+
+uint32_t LightClusterGrid::GetSlice(float viewDepth) const
+{
+	if (viewDepth <= m_Near)
+	{
+		return 0;
+	}
+
+	float slice = logf(viewDepth) * m_DepthScale - m_DepthBias;
+
+	return slice >= (float)(s_GridZ - 1) ? s_GridZ - 1 : (uint32_t)slice;
+}
+
+void LightClusterGrid::Build(const glm::mat4& viewMatrix, const glm::mat4& projection, const std::vector<glm::vec4>& lightSpheres, bool parallel)
+{
+	// Near and far distances recovered from an OpenGL perspective projection
+	m_Near = std::max(projection[3][2] / (projection[2][2] - 1.0f), s_MinNearPlane);
+	m_Far = std::max(projection[3][2] / (projection[2][2] + 1.0f), m_Near * 2.0f);
+
+	float logDepthRange = logf(m_Far / m_Near);
+
+	m_DepthScale = (float)s_GridZ / logDepthRange;
+	m_DepthBias = (float)s_GridZ * logf(m_Near) / logDepthRange;
+
+	m_ProjectionScale = { projection[0][0], projection[1][1] };
+	m_ProjectionOffset = { projection[2][0], projection[2][1] };
+
+	// Spheres are kept in view space with z flipped to a positive depth
+	m_ViewSpheres.resize(lightSpheres.size());
+
+	for (size_t i = 0; i < lightSpheres.size(); i++)
+	{
+		const glm::vec4& sphere = lightSpheres[i];
+
+		glm::vec4 centre = viewMatrix * glm::vec4(glm::vec3(sphere), 1.0f);
+
+		m_ViewSpheres[i] = { centre.x, centre.y, -centre.z, sphere.w };
+	}
+
+	m_Clusters.resize(s_ClusterCount);
+
+	if (parallel)
+	{
+		ThreadPool::Get().ParallelFor(s_GridZ, [this](uint32_t slice) { BuildSlice(slice); });
+	}
+	else
+	{
+		for (uint32_t slice = 0; slice < s_GridZ; slice++)
+		{
+			BuildSlice(slice);
+		}
+	}
+
+	// Slices wrote offsets relative to their own index lists, rebase them onto the combined list
+	uint32_t indexCount = 0;
+
+	for (uint32_t slice = 0; slice < s_GridZ; slice++)
+	{
+		indexCount += (uint32_t)m_Slices[slice].LightIndices.size();
+	}
+
+	m_LightIndices.resize(indexCount);
+
+	uint32_t offset = 0;
+
+	for (uint32_t slice = 0; slice < s_GridZ; slice++)
+	{
+		const std::vector<uint32_t>& sliceIndices = m_Slices[slice].LightIndices;
+
+		if (!sliceIndices.empty())
+		{
+			memcpy(&m_LightIndices[offset], sliceIndices.data(), sliceIndices.size() * sizeof(uint32_t));
+		}
+
+		Cluster* clusters = &m_Clusters[slice * s_TilesPerSlice];
+
+		for (uint32_t tile = 0; tile < s_TilesPerSlice; tile++)
+		{
+			clusters[tile].Offset += offset;
+		}
+
+		offset += (uint32_t)sliceIndices.size();
+	}
+}
+
+// Lights overlapping the depth range of the slice are gathered first so each tile only tests those, four at a time against the tile's view space box
+void LightClusterGrid::BuildSlice(uint32_t slice)
+{
+	SliceData& data = m_Slices[slice];
+
+	float sliceNear = m_Near * powf(m_Far / m_Near, (float)slice / (float)s_GridZ);
+	float sliceFar = m_Near * powf(m_Far / m_Near, (float)(slice + 1) / (float)s_GridZ);
+
+	// The first and last slices take everything in front of and behind the grid as the shader clamps to them
+	if (slice == 0)
+	{
+		sliceNear = 0.0f;
+	}
+
+	if (slice == s_GridZ - 1)
+	{
+		sliceFar = std::numeric_limits<float>::max();
+	}
+
+	data.X.clear();
+	data.Y.clear();
+	data.Z.clear();
+	data.RadiusSquared.clear();
+	data.Lights.clear();
+	data.LightIndices.clear();
+
+	for (uint32_t i = 0; i < (uint32_t)m_ViewSpheres.size(); i++)
+	{
+		const glm::vec4& sphere = m_ViewSpheres[i];
+
+		if (sphere.z + sphere.w < sliceNear || sphere.z - sphere.w > sliceFar)
+		{
+			continue;
+		}
+
+		data.X.push_back(sphere.x);
+		data.Y.push_back(sphere.y);
+		data.Z.push_back(sphere.z);
+		data.RadiusSquared.push_back(sphere.w * sphere.w);
+		data.Lights.push_back(i);
+	}
+
+	uint32_t lightCount = (uint32_t)data.Lights.size();
+
+	while (data.X.size() % s_BatchSize != 0)
+	{
+		data.X.push_back(0.0f);
+		data.Y.push_back(0.0f);
+		data.Z.push_back(0.0f);
+		data.RadiusSquared.push_back(-1.0f);
+	}
+
+	Cluster* clusters = &m_Clusters[slice * s_TilesPerSlice];
+
+	if (lightCount == 0)
+	{
+		for (uint32_t tile = 0; tile < s_TilesPerSlice; tile++)
+		{
+			clusters[tile] = { 0, 0 };
+		}
+
+		return;
+	}
+
+	// Tiles are bounded at the slice's real depths, the open ended first and last slices are bounded by the grid's near and far
+	float boundsNear = slice == 0 ? m_Near : sliceNear;
+	float boundsFar = slice == s_GridZ - 1 ? m_Far : sliceFar;
+
+	const __m128 zero = _mm_setzero_ps();
+
+	const __m128 minZ = _mm_set1_ps(sliceNear);
+	const __m128 maxZ = _mm_set1_ps(sliceFar);
+
+	for (uint32_t y = 0; y < s_GridY; y++)
+	{
+		float ndcMinY = (float)y / (float)s_GridY * 2.0f - 1.0f;
+		float ndcMaxY = (float)(y + 1) / (float)s_GridY * 2.0f - 1.0f;
+
+		float y0 = (ndcMinY + m_ProjectionOffset.y) / m_ProjectionScale.y;
+		float y1 = (ndcMaxY + m_ProjectionOffset.y) / m_ProjectionScale.y;
+
+		__m128 minY = _mm_set1_ps(std::min({ y0 * boundsNear, y0 * boundsFar, y1 * boundsNear, y1 * boundsFar }));
+		__m128 maxY = _mm_set1_ps(std::max({ y0 * boundsNear, y0 * boundsFar, y1 * boundsNear, y1 * boundsFar }));
+
+		for (uint32_t x = 0; x < s_GridX; x++)
+		{
+			float ndcMinX = (float)x / (float)s_GridX * 2.0f - 1.0f;
+			float ndcMaxX = (float)(x + 1) / (float)s_GridX * 2.0f - 1.0f;
+
+			float x0 = (ndcMinX + m_ProjectionOffset.x) / m_ProjectionScale.x;
+			float x1 = (ndcMaxX + m_ProjectionOffset.x) / m_ProjectionScale.x;
+
+			__m128 minX = _mm_set1_ps(std::min({ x0 * boundsNear, x0 * boundsFar, x1 * boundsNear, x1 * boundsFar }));
+			__m128 maxX = _mm_set1_ps(std::max({ x0 * boundsNear, x0 * boundsFar, x1 * boundsNear, x1 * boundsFar }));
+
+			Cluster& cluster = clusters[GetClusterIndex(x, y, 0)];
+
+			cluster.Offset = (uint32_t)data.LightIndices.size();
+
+			for (uint32_t batch = 0; batch < lightCount; batch += s_BatchSize)
+			{
+				__m128 centreX = _mm_loadu_ps(&data.X[batch]);
+				__m128 centreY = _mm_loadu_ps(&data.Y[batch]);
+				__m128 centreZ = _mm_loadu_ps(&data.Z[batch]);
+
+				// Distance from the sphere centre to the closest point of the box along each axis, zero when inside
+				__m128 dx = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minX, centreX), _mm_sub_ps(centreX, maxX)));
+				__m128 dy = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minY, centreY), _mm_sub_ps(centreY, maxY)));
+				__m128 dz = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minZ, centreZ), _mm_sub_ps(centreZ, maxZ)));
+
+				__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+				int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_loadu_ps(&data.RadiusSquared[batch])));
+
+				while (mask)
+				{
+					uint32_t lane = 0;
+
+					while (!((mask >> lane) & 1))
+					{
+						lane++;
+					}
+
+					mask &= ~(1 << lane);
+
+					data.LightIndices.push_back(data.Lights[batch + lane]);
+				}
+			}
+
+			cluster.Count = (uint32_t)data.LightIndices.size() - cluster.Offset;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Splits the view frustum into froxels (screen tiles by exponential depth slices) and bins light spheres into them
+// Pure CPU, the scene renderer uploads the result for the lighting shader to read the lights of each pixel's cluster
+class LightClusterGrid
+{
+
+public:
+
+	static constexpr uint32_t s_GridX = 16;
+	static constexpr uint32_t s_GridY = 9;
+	static constexpr uint32_t s_GridZ = 24;
+	static constexpr uint32_t s_ClusterCount = s_GridX * s_GridY * s_GridZ;
+
+	// Fraction of a light's peak intensity below which it is treated as having no effect
+	static constexpr float s_DefaultLightCutoff = 1.0f / 256.0f;
+
+	// Range of a cluster's lights in the light index list
+	struct Cluster
+	{
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	// Bins world space light spheres (xyz centre, w radius) into the clusters of a perspective view, slices are built across the thread pool when parallel is set
+	void Build(const glm::mat4& viewMatrix, const glm::mat4& projection, const std::vector<glm::vec4>& lightSpheres, bool parallel = true);
+
+	const std::vector<Cluster>& GetClusters() const { return m_Clusters; }
+	const std::vector<uint32_t>& GetLightIndices() const { return m_LightIndices; }
+
+	// A view depth d lies in slice floor(log(d) * scale - bias)
+	float GetDepthScale() const { return m_DepthScale; }
+	float GetDepthBias() const { return m_DepthBias; }
+
+	uint32_t GetSlice(float viewDepth) const;
+
+	static uint32_t GetClusterIndex(uint32_t x, uint32_t y, uint32_t slice) { return x + y * s_GridX + slice * s_GridX * s_GridY; }
+
+	// Distance at which a light using the attenuation of Lighting.glsl, 1 / (brightness + quadratic * d^2), falls below the cutoff
+	static float GetPointLightRadius(float brightness, float quadratic, float intensity, float cutoff = s_DefaultLightCutoff);
+
+private:
+
+	void BuildSlice(uint32_t slice);
+
+private:
+
+	// Light spheres of one slice as a structure of arrays, padded to the batch size with spheres that never intersect
+	struct SliceData
+	{
+		std::vector<float> X;
+		std::vector<float> Y;
+		std::vector<float> Z;
+		std::vector<float> RadiusSquared;
+		std::vector<uint32_t> Lights;
+
+		std::vector<uint32_t> LightIndices;
+	};
+
+	std::vector<glm::vec4> m_ViewSpheres;
+
+	float m_Near = 0.1f;
+	float m_Far = 1.0f;
+
+	float m_DepthScale = 0.0f;
+	float m_DepthBias = 0.0f;
+
+	// Projection terms mapping NDC x/y at a view depth back onto view space
+	glm::vec2 m_ProjectionScale = glm::vec2(1.0f);
+	glm::vec2 m_ProjectionOffset = glm::vec2(0.0f);
+
+	SliceData m_Slices[s_GridZ];
+
+	std::vector<Cluster> m_Clusters;
+	std::vector<uint32_t> m_LightIndices;
+};
\ No newline at end of file
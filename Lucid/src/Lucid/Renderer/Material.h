@@ -20,6 +20,7 @@ class Material : public RefCounted
 {
 
 	friend class MaterialInstance;
+	friend class RenderPacketBucket;
 
 public:
 
@@ -95,6 +96,7 @@ class MaterialInstance : public RefCounted
 {
 
 	friend class Material;
+	friend class RenderPacketBucket;
 
 public:
 
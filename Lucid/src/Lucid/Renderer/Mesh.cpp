@@ -22,8 +22,12 @@
 #include <imgui/imgui.h>
 
 #include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/MeshCache.h"
+#include "Lucid/Renderer/TextureLibrary.h"
 
-glm::mat4 Mat4FromAssimpMat4(const aiMatrix4x4& matrix)
+#include "Lucid/Core/ThreadPool.h"
+
+static glm::mat4 Mat4FromAssimpMat4(const aiMatrix4x4& matrix)
 {
 	glm::mat4 result;
 
@@ -48,6 +52,7 @@ aiProcess_ValidateDataStructure;    // Valid mesh structure
 // Create a new logger for logging assimp logstream data
 struct LogStream : public Assimp::LogStream
 {
+	// Called on the main thread, Assimp's default logger is global
 	static void Initialize()
 	{
 		if (Assimp::DefaultLogger::isNullLogger())
@@ -63,33 +68,100 @@ struct LogStream : public Assimp::LogStream
 	}
 };
 
-Mesh::Mesh(const std::string& filename)
+Mesh::Mesh(const std::string& filename, bool async)
 	: m_FilePath(filename)
 {
 	LogStream::Initialize();
 
-	LD_CORE_INFO("Loading mesh: {0}", filename.c_str());
+	m_MeshShader = Renderer::GetShaderLibrary()->Get("Buffer");
+	m_BaseMaterial = Ref<Material>::Create(m_MeshShader);
 
-	m_Importer = std::make_unique<Assimp::Importer>();
+	// The mesh library loads an asynchronous mesh on a worker thread and uploads it on the main thread once done
+	if (!async)
+	{
+		Load();
+		Upload();
+	}
+}
 
-	const aiScene* scene = m_Importer->ReadFile(filename, s_MeshImportFlags);
+Mesh::~Mesh()
+{
+}
 
-	// Get file extension
-	size_t found = m_FilePath.find_last_of(".");
-	std::string fileExtension = found != std::string::npos ? m_FilePath.substr(found, std::string::npos) : m_FilePath;
+void Mesh::Load()
+{
+	LD_CORE_INFO("Loading mesh: {0}", m_FilePath.c_str());
 
-	// Check if the scene has any meshes
-	if (!scene || !scene->HasMeshes())
+	m_Cache = MeshCacheFile::Open(m_FilePath, s_MeshImportFlags);
+
+	if (m_Cache)
 	{
-		LD_CORE_ERROR("Failed to load mesh file: {0}", filename);
+		LoadFromCache(m_MaterialDescriptions);
+
+		CreateTriangleCache(m_Cache->GetVertices(), m_Cache->GetIndices());
 	}
+	else if (Import(m_MaterialDescriptions))
+	{
+		MeshCacheFile::Write(m_FilePath, s_MeshImportFlags, m_Vertices, m_Indices, m_Submeshes, m_Nodes, m_MaterialDescriptions);
 
-	m_Scene = scene;
+		CreateTriangleCache(m_Vertices.data(), m_Indices.data());
+	}
 
-	m_MeshShader = Renderer::GetShaderLibrary()->Get("Buffer");
-	m_BaseMaterial = Ref<Material>::Create(m_MeshShader);
+	if (!m_Nodes.empty())
+	{
+		m_InverseTransform = glm::inverse(m_Nodes[0].LocalTransform);
+	}
 
-	m_InverseTransform = glm::inverse(Mat4FromAssimpMat4(scene->mRootNode->mTransformation));
+	DecodeTextures();
+}
+
+void Mesh::Upload()
+{
+	CreateMaterials();
+	CreateVertexArray();
+
+	m_MaterialDescriptions.clear();
+	m_MaterialMaps.clear();
+	m_LoadingTextures.clear();
+
+	m_Loaded = true;
+}
+
+// Lays the node hierarchy out breadth first so the children of every node sit next to each other
+static void BuildNodes(aiNode* root, std::vector<MeshNode>& nodes)
+{
+	std::vector<aiNode*> queue = { root };
+
+	for (size_t i = 0; i < queue.size(); i++)
+	{
+		aiNode* node = queue[i];
+
+		MeshNode& meshNode = nodes.emplace_back();
+		meshNode.Name = node->mName.C_Str();
+		meshNode.LocalTransform = Mat4FromAssimpMat4(node->mTransformation);
+		meshNode.FirstChild = (uint32_t)queue.size();
+		meshNode.ChildCount = node->mNumChildren;
+
+		for (uint32_t c = 0; c < node->mNumChildren; c++)
+		{
+			queue.push_back(node->mChildren[c]);
+		}
+	}
+}
+
+bool Mesh::Import(std::vector<MeshMaterialDescription>& materials)
+{
+	Assimp::Importer importer;
+
+	const aiScene* scene = importer.ReadFile(m_FilePath, s_MeshImportFlags);
+
+	// Check if the scene has any meshes
+	if (!scene || !scene->HasMeshes())
+	{
+		LD_CORE_ERROR("Failed to load mesh file: {0}", m_FilePath);
+
+		return false;
+	}
 
 	uint32_t vertexCount = 0;
 	uint32_t indexCount = 0;
@@ -163,209 +235,392 @@ Mesh::Mesh(const std::string& filename)
 
 			// Push the indices back to the index list
 			m_Indices.push_back(index);
-
-			m_TriangleCache[m].emplace_back(m_Vertices[index.V1 + submesh.BaseVertex], m_Vertices[index.V2 + submesh.BaseVertex], m_Vertices[index.V3 + submesh.BaseVertex]);
 		}
 	}
 
 	// Recursively traverse the meshes node hierarchy
 	TraverseNodes(scene->mRootNode);
 
-	// Check if materials exist
-	if (scene->HasMaterials())
+	BuildNodes(scene->mRootNode, m_Nodes);
+
+	// Get file extension
+	size_t found = m_FilePath.find_last_of(".");
+	std::string fileExtension = found != std::string::npos ? m_FilePath.substr(found, std::string::npos) : m_FilePath;
+
+	// Check what file format mesh is for correctly setting normals type
+	aiTextureType normalType = fileExtension == ".obj" ? aiTextureType_HEIGHT : aiTextureType_NORMALS;
+
+	LD_MESH_LOG("---- Materials - {0} ----", m_FilePath);
+
+	materials.resize(scene->mNumMaterials);
+
+	// For every material
+	for (uint32_t i = 0; i < scene->mNumMaterials; i++)
 	{
-		aiTextureType type;
+		auto aiMaterial = scene->mMaterials[i];
+		auto aiMaterialName = aiMaterial->GetName();
+
+		MeshMaterialDescription& material = materials[i];
+
+		LD_MESH_LOG("  {0} (Index = {1})", aiMaterialName.data, i);
+		LD_MESH_LOG("    TextureCount = {0}", aiMaterial->GetTextureCount(aiTextureType_DIFFUSE));
 
-		LD_MESH_LOG("---- Materials - {0} ----", filename);
+		aiColor3D aiColour;
+		aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColour);
 
-		m_Textures.resize(scene->mNumMaterials);
-		m_Materials.resize(scene->mNumMaterials);
+		material.DiffuseColour = { aiColour.r, aiColour.g, aiColour.b };
 
-		// For every material
-		for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+		float shininess = 1.0f;
+
+		if (aiMaterial->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS)
 		{
-			auto aiMaterial = scene->mMaterials[i];
-			auto aiMaterialName = aiMaterial->GetName();
+			material.Specular = 1.0f - glm::sqrt(shininess / 100.0f);
+		}
 
-			auto mi = Ref<MaterialInstance>::Create(m_BaseMaterial);
+		aiMaterial->Get(AI_MATKEY_SHININESS_STRENGTH, material.Glossiness);
 
-			m_Materials[i] = mi;
+		LD_MESH_LOG("    COLOUR = {0}, {1}, {2}", aiColour.r, aiColour.g, aiColour.b);
+		LD_MESH_LOG("    SPECULARITY = {0}", material.Specular);
 
-			LD_MESH_LOG("  {0} (Index = {1})", aiMaterialName.data, i);
+		aiString aiTexPath;
 
-			aiString aiTexPath;
+		if (aiMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &aiTexPath) == AI_SUCCESS)
+		{
+			material.DiffuseMap = aiTexPath.C_Str();
+		}
 
-			uint32_t textureCount = aiMaterial->GetTextureCount(aiTextureType_DIFFUSE);
+		if (aiMaterial->GetTexture(normalType, 0, &aiTexPath) == AI_SUCCESS)
+		{
+			material.NormalMap = aiTexPath.C_Str();
+		}
 
-			LD_MESH_LOG("    TextureCount = {0}", textureCount);
+		if (aiMaterial->GetTexture(aiTextureType_SPECULAR, 0, &aiTexPath) == AI_SUCCESS)
+		{
+			material.SpecularMap = aiTexPath.C_Str();
+		}
 
-			aiColor3D aiColour;
-			aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColour);
+		if (aiMaterial->GetTexture(aiTextureType_SHININESS, 0, &aiTexPath) == AI_SUCCESS)
+		{
+			material.GlossMap = aiTexPath.C_Str();
+		}
+	}
 
-			float specular = 1.0f;
-			float shininess = 1.0f;
-			float glossiness = 1.0f;
+	LD_MESH_LOG("------------------------");
 
-			if (aiMaterial->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS)
-			{
-				specular = 1.0f - glm::sqrt(shininess / 100.0f);
-			}
+	return true;
+}
 
-			if (aiMaterial->Get(AI_MATKEY_SHININESS_STRENGTH, glossiness) == AI_SUCCESS)
-			{
-				shininess = 1.0f - glm::sqrt(glossiness / 100.0f);
-			}
+void Mesh::LoadFromCache(std::vector<MeshMaterialDescription>& materials)
+{
+	const MeshCacheHeader& header = m_Cache->GetHeader();
 
-			LD_MESH_LOG("    COLOUR = {0}, {1}, {2}", aiColour.r, aiColour.g, aiColour.b);
-			LD_MESH_LOG("    SPECULARITY = {0}", specular);
+	const MeshCacheSubmesh* submeshes = m_Cache->GetSubmeshes();
 
-			bool hasDiffuseMap = aiMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &aiTexPath) == AI_SUCCESS;
+	m_Submeshes.resize(header.SubmeshCount);
 
-			if (hasDiffuseMap)
-			{
-				std::filesystem::path path = filename;
+	for (uint32_t i = 0; i < header.SubmeshCount; i++)
+	{
+		Submesh& submesh = m_Submeshes[i];
+		submesh.BaseVertex = submeshes[i].BaseVertex;
+		submesh.BaseIndex = submeshes[i].BaseIndex;
+		submesh.MaterialIndex = submeshes[i].MaterialIndex;
+		submesh.IndexCount = submeshes[i].IndexCount;
+		submesh.Transform = submeshes[i].Transform;
+		submesh.BoundingBox.Min = submeshes[i].BoundsMin;
+		submesh.BoundingBox.Max = submeshes[i].BoundsMax;
+		submesh.NodeName = m_Cache->GetString(submeshes[i].NodeName);
+		submesh.MeshName = m_Cache->GetString(submeshes[i].MeshName);
+	}
 
-				auto parentPath = path.parent_path();
-				parentPath /= std::string(aiTexPath.data);
+	const MeshCacheNode* nodes = m_Cache->GetNodes();
 
-				std::string texturePath = parentPath.string();
+	m_Nodes.resize(header.NodeCount);
 
-				LD_MESH_LOG("    Diffuse map path = {0}", texturePath);
+	for (uint32_t i = 0; i < header.NodeCount; i++)
+	{
+		MeshNode& node = m_Nodes[i];
+		node.Name = m_Cache->GetString(nodes[i].Name);
+		node.LocalTransform = nodes[i].LocalTransform;
+		node.FirstChild = nodes[i].FirstChild;
+		node.ChildCount = nodes[i].ChildCount;
+	}
 
-				auto texture = Texture2D::Create(texturePath, true);
+	const MeshCacheMaterial* cacheMaterials = m_Cache->GetMaterials();
 
-				if (texture->Loaded())
-				{
-					m_Textures[i] = texture;
-					
-					mi->Set("u_DiffuseTexture", m_Textures[i]);
-					mi->Set("u_DiffuseTexToggle", 1.0f);
-				}
-				else
-				{
-					LD_CORE_ERROR("Could not load texture: {0}", texturePath);
+	materials.resize(header.MaterialCount);
 
-					// Fallback to diffuse colour
-					mi->Set("u_DiffuseColour", glm::vec3{ aiColour.r, aiColour.g, aiColour.b });
-				}
-			}
-			else
-			{
-				mi->Set("u_DiffuseColour", glm::vec3{ aiColour.r, aiColour.g, aiColour.b });
+	for (uint32_t i = 0; i < header.MaterialCount; i++)
+	{
+		MeshMaterialDescription& material = materials[i];
+		material.DiffuseColour = cacheMaterials[i].DiffuseColour;
+		material.Specular = cacheMaterials[i].Specular;
+		material.Glossiness = cacheMaterials[i].Glossiness;
+		material.DiffuseMap = m_Cache->GetString(cacheMaterials[i].DiffuseMap);
+		material.NormalMap = m_Cache->GetString(cacheMaterials[i].NormalMap);
+		material.SpecularMap = m_Cache->GetString(cacheMaterials[i].SpecularMap);
+		material.GlossMap = m_Cache->GetString(cacheMaterials[i].GlossMap);
+	}
 
-				LD_MESH_LOG("    No diffuse map");
-			}
+	LD_CORE_INFO("Loaded mesh from cache: {0}", MeshCacheFile::GetCachePath(m_FilePath));
+}
 
-			// Normal maps
-			mi->Set("u_NormalTexToggle", 0.0f);
+// Resolves a texture path from the mesh file, which is relative to the mesh file's directory
+static std::string GetTexturePath(const std::string& meshPath, const std::string& texturePath)
+{
+	std::filesystem::path path = meshPath;
 
-			// Check what file format mesh is for correctly setting normals type
-			if (fileExtension == ".fbx")
-			{
-				type = aiTextureType_NORMALS;
-			}
-			else if (fileExtension == ".obj")
-			{
-				type = aiTextureType_HEIGHT;
-			}
+	auto parentPath = path.parent_path();
+	parentPath /= texturePath;
 
-			if (aiMaterial->GetTexture(type, 0, &aiTexPath) == AI_SUCCESS)
-			{
-				std::filesystem::path path = filename;
+	return parentPath.string();
+}
 
-				auto parentPath = path.parent_path();
-				parentPath /= std::string(aiTexPath.data);
+void Mesh::DecodeTextures()
+{
+	std::unordered_map<std::string, int32_t> textureIndices;
 
-				std::string texturePath = parentPath.string();
+	// Materials referencing the same file share one entry
+	auto addTexture = [&](const std::string& texturePath, const char* mapName, bool srgb, bool normalMap)
+	{
+		if (texturePath.empty())
+		{
+			return -1;
+		}
 
-				LD_MESH_LOG("    Normal map path = {0}", texturePath);
+		std::string path = GetTexturePath(m_FilePath, texturePath);
 
-				auto texture = Texture2D::Create(texturePath);
+		LD_MESH_LOG("    {0} map path = {1}", mapName, path);
 
-				if (texture->Loaded())
-				{
-					mi->Set("u_NormalTexture", texture);
-					mi->Set("u_NormalTexToggle", 1.0f);
-				}
-				else
-				{
-					LD_CORE_ERROR("    Could not load texture: {0}", texturePath);
-				}
-			}
-			else
-			{
-				LD_MESH_LOG("    No normal map");
-			}
+		std::string key = path + (srgb ? "|srgb" : "|linear");
 
-			// Specular map
-			if (aiMaterial->GetTexture(aiTextureType_SPECULAR, 0, &aiTexPath) == AI_SUCCESS)
-			{
-				std::filesystem::path path = filename;
+		auto it = textureIndices.find(key);
 
-				auto parentPath = path.parent_path();
-				parentPath /= std::string(aiTexPath.data);
+		if (it != textureIndices.end())
+		{
+			return it->second;
+		}
+
+		int32_t index = (int32_t)m_LoadingTextures.size();
 
-				std::string texturePath = parentPath.string();
+		MeshTexture& texture = m_LoadingTextures.emplace_back();
+		texture.Image.Path = path;
+		texture.Image.SRGB = srgb;
+		texture.Texture = TextureLibrary::Find(path, srgb);
 
-				LD_MESH_LOG("    Specular map path = {0}", texturePath);
+		MeshTextureSource& source = m_TextureSources.emplace_back();
+		source.Path = path;
+		source.SRGB = srgb;
+		source.NormalMap = normalMap;
 
-				auto texture = Texture2D::Create(texturePath);
+		textureIndices[key] = index;
 
-				if (texture->Loaded())
-				{
-					mi->Set("u_SpecularTexture", texture);
-					mi->Set("u_SpecularTexToggle", 1.0f);
-				}
-				else
-				{
-					LD_CORE_ERROR("    Could not load texture: {0}", texturePath);
-				}
+		return index;
+	};
+
+	m_MaterialMaps.resize(m_MaterialDescriptions.size());
+
+	for (size_t i = 0; i < m_MaterialDescriptions.size(); i++)
+	{
+		const MeshMaterialDescription& material = m_MaterialDescriptions[i];
+
+		MeshMaterialMaps& maps = m_MaterialMaps[i];
+		maps.DiffuseMap = addTexture(material.DiffuseMap, "Diffuse", true, false);
+		maps.NormalMap = addTexture(material.NormalMap, "Normal", false, true);
+		maps.SpecularMap = addTexture(material.SpecularMap, "Specular", false, false);
+		maps.GlossMap = addTexture(material.GlossMap, "Gloss", false, false);
+	}
+
+	std::vector<TextureImage*> decodes;
+
+	for (MeshTexture& texture : m_LoadingTextures)
+	{
+		if (!texture.Texture)
+		{
+			decodes.push_back(&texture.Image);
+		}
+	}
+
+	// Textures not in the library yet are decoded across the thread pool, so the time scales with cores rather than texture count
+	ThreadPool::Get().ParallelFor((uint32_t)decodes.size(), [&decodes](uint32_t i)
+	{
+		TextureImage& image = *decodes[i];
+
+		image = Texture2D::Decode(image.Path, image.SRGB);
+	});
+}
+
+void Mesh::CreateMaterials()
+{
+	// Decoded textures are uploaded into the library, the rest were found there while loading
+	for (MeshTexture& texture : m_LoadingTextures)
+	{
+		if (!texture.Texture)
+		{
+			texture.Texture = TextureLibrary::Add(texture.Image);
+		}
+
+		if (texture.Texture->Loaded())
+		{
+			m_MaterialTextures.push_back(texture.Texture);
+		}
+	}
+
+	m_Textures.resize(m_MaterialDescriptions.size());
+	m_Materials.resize(m_MaterialDescriptions.size());
+
+	// For every material
+	for (size_t i = 0; i < m_MaterialDescriptions.size(); i++)
+	{
+		const MeshMaterialDescription& material = m_MaterialDescriptions[i];
+		const MeshMaterialMaps& maps = m_MaterialMaps[i];
+
+		auto mi = Ref<MaterialInstance>::Create(m_BaseMaterial);
+
+		m_Materials[i] = mi;
+
+		if (maps.DiffuseMap >= 0)
+		{
+			const Ref<Texture2D>& texture = m_LoadingTextures[maps.DiffuseMap].Texture;
+
+			if (texture->Loaded())
+			{
+				m_Textures[i] = texture;
+
+				mi->Set("u_DiffuseTexture", m_Textures[i]);
+				mi->Set("u_DiffuseTexToggle", 1.0f);
 			}
 			else
 			{
-				LD_MESH_LOG("    No specular map");
+				LD_CORE_ERROR("Could not load texture: {0}", texture->GetPath());
 
-				mi->Set("u_Specular", specular);
+				// Fallback to diffuse colour
+				mi->Set("u_DiffuseColour", material.DiffuseColour);
 			}
+		}
+		else
+		{
+			mi->Set("u_DiffuseColour", material.DiffuseColour);
 
-			// Gloss map
-			if (aiMaterial->GetTexture(aiTextureType_SHININESS, 0, &aiTexPath) == AI_SUCCESS)
-			{
-				std::filesystem::path path = filename;
+			LD_MESH_LOG("    No diffuse map");
+		}
 
-				auto parentPath = path.parent_path();
-				parentPath /= std::string(aiTexPath.data);
+		// Normal maps
+		mi->Set("u_NormalTexToggle", 0.0f);
 
-				std::string texturePath = parentPath.string();
+		if (maps.NormalMap >= 0)
+		{
+			const Ref<Texture2D>& texture = m_LoadingTextures[maps.NormalMap].Texture;
 
-				LD_MESH_LOG("    Gloss map path = {0}", texturePath);
+			if (texture->Loaded())
+			{
+				mi->Set("u_NormalTexture", texture);
+				mi->Set("u_NormalTexToggle", 1.0f);
+			}
+			else
+			{
+				LD_CORE_ERROR("    Could not load texture: {0}", texture->GetPath());
+			}
+		}
+		else
+		{
+			LD_MESH_LOG("    No normal map");
+		}
 
-				auto texture = Texture2D::Create(texturePath);
+		// Specular map
+		if (maps.SpecularMap >= 0)
+		{
+			const Ref<Texture2D>& texture = m_LoadingTextures[maps.SpecularMap].Texture;
 
-				if (texture->Loaded())
-				{
-					mi->Set("u_GlossTexture", texture);
-					mi->Set("u_GlossTexToggle", 1.0f);
-				}
-				else
-				{
-					LD_CORE_ERROR("    Could not load texture: {0}", texturePath);
-				}
+			if (texture->Loaded())
+			{
+				mi->Set("u_SpecularTexture", texture);
+				mi->Set("u_SpecularTexToggle", 1.0f);
 			}
 			else
 			{
-				LD_MESH_LOG("    No gloss map");
+				LD_CORE_ERROR("    Could not load texture: {0}", texture->GetPath());
+			}
+		}
+		else
+		{
+			LD_MESH_LOG("    No specular map");
+
+			mi->Set("u_Specular", material.Specular);
+		}
 
-				mi->Set("u_Gloss", glossiness);
+		// Gloss map
+		if (maps.GlossMap >= 0)
+		{
+			const Ref<Texture2D>& texture = m_LoadingTextures[maps.GlossMap].Texture;
+
+			if (texture->Loaded())
+			{
+				mi->Set("u_GlossTexture", texture);
+				mi->Set("u_GlossTexToggle", 1.0f);
+			}
+			else
+			{
+				LD_CORE_ERROR("    Could not load texture: {0}", texture->GetPath());
 			}
 		}
+		else
+		{
+			LD_MESH_LOG("    No gloss map");
 
-		LD_MESH_LOG("------------------------");
+			mi->Set("u_Gloss", material.Glossiness);
+		}
 	}
+}
+
+void Mesh::CreateTriangleCache(const Vertex* vertices, const Index* indices)
+{
+	for (uint32_t m = 0; m < (uint32_t)m_Submeshes.size(); m++)
+	{
+		const Submesh& submesh = m_Submeshes[m];
+
+		std::vector<Triangle>& triangles = m_TriangleCache[m];
+		triangles.reserve(submesh.IndexCount / 3);
+
+		// Base index counts single indices, an Index holds the three of a face
+		const Index* faces = indices + submesh.BaseIndex / 3;
 
+		for (uint32_t i = 0; i < submesh.IndexCount / 3; i++)
+		{
+			const Index& index = faces[i];
+
+			triangles.emplace_back(vertices[index.V1 + submesh.BaseVertex], vertices[index.V2 + submesh.BaseVertex], vertices[index.V3 + submesh.BaseVertex]);
+		}
+	}
+}
+
+void Mesh::CreateVertexArray()
+{
 	m_VertexArray = VertexArray::Create();
 
-	auto vb = VertexBuffer::Create(m_Vertices.data(), m_Vertices.size() * sizeof(Vertex));
+	Ref<VertexBuffer> vb;
+	Ref<IndexBuffer> ib;
+
+	if (m_Cache)
+	{
+		const MeshCacheHeader& header = m_Cache->GetHeader();
+
+		vb = VertexBuffer::Create(header.VertexCount * sizeof(Vertex), VertexBufferUsage::Static);
+		ib = IndexBuffer::Create(header.IndexCount * sizeof(Index), VertexBufferUsage::Static);
+
+		// Uploaded straight from the mapped cache rather than copied into the buffers' local storage first, the buffers are created by the commands submitted above
+		Ref<MeshCacheFile> cache = m_Cache;
+
+		Renderer::Submit([vb, ib, cache]()
+		{
+			glNamedBufferSubData(vb->GetRendererID(), 0, vb->GetSize(), cache->GetVertices());
+			glNamedBufferSubData(ib->GetRendererID(), 0, ib->GetSize(), cache->GetIndices());
+		});
+	}
+	else
+	{
+		vb = VertexBuffer::Create(m_Vertices.data(), m_Vertices.size() * sizeof(Vertex));
+		ib = IndexBuffer::Create(m_Indices.data(), m_Indices.size() * sizeof(Index));
+	}
 
 	vb->SetLayout
 	({
@@ -377,15 +632,9 @@ Mesh::Mesh(const std::string& filename)
 	});
 
 	m_VertexArray->AddVertexBuffer(vb);
-
-	auto ib = IndexBuffer::Create(m_Indices.data(), m_Indices.size() * sizeof(Index));
 	m_VertexArray->SetIndexBuffer(ib);
 }
 
-Mesh::~Mesh()
-{
-}
-
 static std::string LevelToSpaces(uint32_t level)
 {
 	std::string result = "";
@@ -418,15 +667,58 @@ void Mesh::TraverseNodes(aiNode* node, const glm::mat4& parentTransform, uint32_
 	}
 }
 
+MeshMemoryUsage Mesh::GetMemoryUsage() const
+{
+	MeshMemoryUsage usage;
+
+	// A worker thread may still be writing the mesh
+	if (!m_Loaded)
+	{
+		return usage;
+	}
+
+	for (const auto& vertexBuffer : m_VertexArray->GetVertexBuffers())
+	{
+		usage.GeometryMemory += vertexBuffer->GetSize();
+	}
+
+	usage.GeometryMemory += m_VertexArray->GetIndexBuffer()->GetSize();
+
+	for (const auto& texture : m_MaterialTextures)
+	{
+		usage.TextureMemory += texture->GetMemorySize();
+	}
+
+	usage.SystemMemory += m_Vertices.capacity() * sizeof(Vertex);
+	usage.SystemMemory += m_Indices.capacity() * sizeof(Index);
+	usage.SystemMemory += m_Submeshes.capacity() * sizeof(Submesh);
+	usage.SystemMemory += m_Nodes.capacity() * sizeof(MeshNode);
+
+	for (const auto& [submesh, triangles] : m_TriangleCache)
+	{
+		usage.SystemMemory += triangles.capacity() * sizeof(Triangle);
+	}
+
+	if (m_Cache)
+	{
+		usage.MappedMemory = m_Cache->GetFileSize();
+	}
+
+	return usage;
+}
+
 void Mesh::DumpVertexBuffer()
 {
 	LD_MESH_LOG("------------------------------------------------------");
 	LD_MESH_LOG("Vertex Buffer Dump");
 	LD_MESH_LOG("Mesh: {0}", m_FilePath);
 
-	for (size_t i = 0; i < m_Vertices.size(); i++)
+	const Vertex* vertices = m_Cache ? m_Cache->GetVertices() : m_Vertices.data();
+	size_t vertexCount = m_Cache ? m_Cache->GetHeader().VertexCount : m_Vertices.size();
+
+	for (size_t i = 0; i < vertexCount; i++)
 	{
-		auto& vertex = m_Vertices[i];
+		auto& vertex = vertices[i];
 
 		LD_MESH_LOG("Vertex: {0}", i);
 		LD_MESH_LOG("Position: {0}, {1}, {2}", vertex.Position.x, vertex.Position.y, vertex.Position.z);
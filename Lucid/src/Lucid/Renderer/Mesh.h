@@ -12,12 +12,8 @@
 #include "Lucid/Core/Math/AABB.h"
 
 struct aiNode;
-struct aiScene;
 
-namespace Assimp
-{
-	class Importer;
-}
+class MeshCacheFile;
 
 struct Vertex
 {
@@ -67,12 +63,80 @@ public:
 	std::string MeshName;
 };
 
+// Node of a mesh's transform hierarchy, the children of a node are stored next to each other
+struct MeshNode
+{
+	std::string Name;
+
+	glm::mat4 LocalTransform;
+
+	uint32_t FirstChild = 0;
+	uint32_t ChildCount = 0;
+};
+
+// Material properties read from the source file, texture paths are relative to the source file's directory and empty when the material has none
+struct MeshMaterialDescription
+{
+	glm::vec3 DiffuseColour = { 0.0f, 0.0f, 0.0f };
+
+	float Specular = 1.0f;
+	float Glossiness = 1.0f;
+
+	std::string DiffuseMap;
+	std::string NormalMap;
+	std::string SpecularMap;
+	std::string GlossMap;
+};
+
+// Memory held by a mesh, in bytes
+struct MeshMemoryUsage
+{
+	// Vertex and index buffers
+	uint64_t GeometryMemory = 0;
+
+	// Textures of the mesh's materials, a texture shared with other meshes through the texture library counts towards each of them
+	uint64_t TextureMemory = 0;
+
+	// Vertices, indices and triangles kept on the CPU
+	uint64_t SystemMemory = 0;
+
+	// Binary cache mapped into the address space, only the pages read are resident
+	uint64_t MappedMemory = 0;
+};
+
+// A texture the materials of a loading mesh reference, found in the texture library or else decoded while the mesh loads and uploaded with its materials
+struct MeshTexture
+{
+	TextureImage Image;
+
+	Ref<Texture2D> Texture;
+};
+
+// Image file the materials sample, kept after loading so the editor can cook it
+struct MeshTextureSource
+{
+	std::string Path;
+
+	bool SRGB = false;
+	bool NormalMap = false;
+};
+
+// Indices of a material's maps into the loading mesh's textures, -1 when the material has none
+struct MeshMaterialMaps
+{
+	int32_t DiffuseMap = -1;
+	int32_t NormalMap = -1;
+	int32_t SpecularMap = -1;
+	int32_t GlossMap = -1;
+};
+
 class Mesh : public RefCounted
 {
 
 public:
 
-	Mesh(const std::string& filename);
+	// An asynchronous mesh is created empty and filled in by the mesh library, see MeshLibrary::LoadAsync
+	Mesh(const std::string& filename, bool async = false);
 	~Mesh();
 
 	void DumpVertexBuffer();
@@ -87,28 +151,60 @@ public:
 
 	const std::vector<Ref<Texture2D>>& GetTextures() const { return m_Textures; }
 
+	Ref<VertexArray> GetVertexArray() { return m_VertexArray; }
+
 	const std::string& GetFilePath() const { return m_FilePath; }
 
 	const std::vector<Triangle> GetTriangleCache(uint32_t index) const { return m_TriangleCache.at(index); }
 
+	// Transform hierarchy of the source file, the root node comes first
+	const std::vector<MeshNode>& GetNodes() const { return m_Nodes; }
+
+	// True when the mesh was loaded from its binary cache rather than imported through Assimp
+	bool IsCached() const { return m_Cache; }
+
+	MeshMemoryUsage GetMemoryUsage() const;
+
+	// Every image file the materials reference, filled once the mesh is loaded
+	const std::vector<MeshTextureSource>& GetTextureSources() const { return m_TextureSources; }
+
+	// False while an asynchronous load is in flight, the mesh has no submeshes, materials or buffers until then
+	bool IsLoaded() const { return m_Loaded; }
+
 private:
 
+	// Reads the geometry and decodes the textures, touches nothing on the renderer so it can run on a worker thread
+	void Load();
+
+	// Creates the materials, textures and buffers from what Load read, on the main thread
+	void Upload();
+
+	bool Import(std::vector<MeshMaterialDescription>& materials);
+	void LoadFromCache(std::vector<MeshMaterialDescription>& materials);
+
 	void TraverseNodes(aiNode* node, const glm::mat4& parentTransform = glm::mat4(1.0f), uint32_t level = 0);
 
+	void DecodeTextures();
+
+	void CreateMaterials();
+	void CreateTriangleCache(const Vertex* vertices, const Index* indices);
+	void CreateVertexArray();
+
 private:
 
 	std::vector<Submesh> m_Submeshes;
 
-	std::unique_ptr<Assimp::Importer> m_Importer;
+	std::vector<MeshNode> m_Nodes;
 
-	glm::mat4 m_InverseTransform;
+	glm::mat4 m_InverseTransform = glm::mat4(1.0f);
 
 	Ref<VertexArray> m_VertexArray;
 
+	// Filled when the mesh is imported, a cached mesh reads its vertices and indices straight from the mapped cache file
 	std::vector<Vertex> m_Vertices;
 	std::vector<Index> m_Indices;
 
-	const aiScene* m_Scene;
+	Ref<MeshCacheFile> m_Cache;
 
 	// Materials
 	Ref<Shader> m_MeshShader;
@@ -117,12 +213,24 @@ private:
 	std::vector<Ref<Texture2D>> m_Textures;
 	std::vector<Ref<Texture2D>> m_NormalMaps;
 
+	// Every texture the materials reference
+	std::vector<Ref<Texture2D>> m_MaterialTextures;
+	std::vector<MeshTextureSource> m_TextureSources;
+
 	std::vector<Ref<MaterialInstance>> m_Materials;
 
+	// Filled by Load and released once uploaded
+	std::vector<MeshMaterialDescription> m_MaterialDescriptions;
+	std::vector<MeshMaterialMaps> m_MaterialMaps;
+	std::vector<MeshTexture> m_LoadingTextures;
+
 	std::unordered_map<uint32_t, std::vector<Triangle>> m_TriangleCache;
 
 	std::string m_FilePath;
 
+	bool m_Loaded = false;
+
 	friend class Renderer;
 	friend class SceneHierarchy;
+	friend class MeshLibrary;
 };
\ No newline at end of file
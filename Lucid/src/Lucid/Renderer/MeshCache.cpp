@@ -0,0 +1,307 @@
+#include "ldpch.h"
+
+#include "MeshCache.h"
+
+#include "Lucid/Core/FileSystem.h"
+
+static constexpr uint64_t s_MeshCacheAlignment = 16;
+
+// A section lies within the file
+static bool IsSectionValid(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize)
+{
+	return offset % s_MeshCacheAlignment == 0 && offset <= fileSize && count * elementSize <= fileSize - offset;
+}
+
+// Every submesh, index and node stays within the tables it refers to, so a damaged cache cannot make the mesh read out of bounds
+static bool AreTablesValid(const MeshCacheHeader& header, const uint8_t* data)
+{
+	const Index* indices = (const Index*)(data + header.IndexOffset);
+	const MeshCacheSubmesh* submeshes = (const MeshCacheSubmesh*)(data + header.SubmeshOffset);
+	const MeshCacheNode* nodes = (const MeshCacheNode*)(data + header.NodeOffset);
+
+	for (uint32_t i = 0; i < header.SubmeshCount; i++)
+	{
+		const MeshCacheSubmesh& submesh = submeshes[i];
+
+		// Base index and index count count single indices, the index table holds faces of three
+		if (submesh.BaseIndex % 3 != 0 || submesh.IndexCount % 3 != 0 || submesh.MaterialIndex >= header.MaterialCount)
+		{
+			return false;
+		}
+
+		uint64_t firstFace = submesh.BaseIndex / 3;
+		uint64_t faceCount = submesh.IndexCount / 3;
+
+		if (firstFace + faceCount > header.IndexCount || submesh.BaseVertex > header.VertexCount)
+		{
+			return false;
+		}
+
+		uint64_t vertexCount = header.VertexCount - submesh.BaseVertex;
+
+		for (uint64_t face = firstFace; face < firstFace + faceCount; face++)
+		{
+			const Index& index = indices[face];
+
+			if (index.V1 >= vertexCount || index.V2 >= vertexCount || index.V3 >= vertexCount)
+			{
+				return false;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < header.NodeCount; i++)
+	{
+		const MeshCacheNode& node = nodes[i];
+
+		// Nodes are stored breadth first, children always come after their parent so the hierarchy cannot loop
+		if (node.ChildCount > 0 && (node.FirstChild <= i || (uint64_t)node.FirstChild + node.ChildCount > header.NodeCount))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::string MeshCacheFile::GetCachePath(const std::string& sourcePath)
+{
+	return sourcePath + ".ldmesh";
+}
+
+Ref<MeshCacheFile> MeshCacheFile::Open(const std::string& sourcePath, uint32_t importFlags)
+{
+	uint64_t sourceSize = 0;
+	int64_t sourceTimestamp = 0;
+
+	if (!FileSystem::GetFileInfo(sourcePath, sourceSize, sourceTimestamp))
+	{
+		return nullptr;
+	}
+
+	std::string cachePath = GetCachePath(sourcePath);
+
+	Ref<MeshCacheFile> cache = Ref<MeshCacheFile>::Create();
+
+	if (!cache->m_File.Open(cachePath))
+	{
+		return nullptr;
+	}
+
+	uint64_t fileSize = cache->m_File.GetSize();
+
+	if (fileSize < sizeof(MeshCacheHeader))
+	{
+		LD_CORE_WARN("Mesh cache {0} is truncated", cachePath);
+
+		return nullptr;
+	}
+
+	const MeshCacheHeader* header = (const MeshCacheHeader*)cache->m_File.GetData();
+
+	if (header->Magic != s_MeshCacheMagic || header->Version != s_MeshCacheVersion || header->VertexSize != sizeof(Vertex) || header->ImportFlags != importFlags)
+	{
+		LD_CORE_INFO("Mesh cache {0} was written by a different version, reimporting", cachePath);
+
+		return nullptr;
+	}
+
+	bool valid = IsSectionValid(header->VertexOffset, header->VertexCount, sizeof(Vertex), fileSize)
+		&& IsSectionValid(header->IndexOffset, header->IndexCount, sizeof(Index), fileSize)
+		&& IsSectionValid(header->SubmeshOffset, header->SubmeshCount, sizeof(MeshCacheSubmesh), fileSize)
+		&& IsSectionValid(header->NodeOffset, header->NodeCount, sizeof(MeshCacheNode), fileSize)
+		&& IsSectionValid(header->MaterialOffset, header->MaterialCount, sizeof(MeshCacheMaterial), fileSize)
+		&& IsSectionValid(header->StringsOffset, header->StringsSize, 1, fileSize);
+
+	if (!valid)
+	{
+		LD_CORE_WARN("Mesh cache {0} is corrupt, reimporting", cachePath);
+
+		return nullptr;
+	}
+
+	// Copies and checkouts change the timestamp without changing the contents, only those pay for hashing the source
+	if (header->SourceSize != sourceSize)
+	{
+		return nullptr;
+	}
+
+	bool timestampChanged = header->SourceTimestamp != sourceTimestamp;
+
+	if (timestampChanged && header->SourceHash != FileSystem::HashFile(sourcePath))
+	{
+		return nullptr;
+	}
+
+	if (!AreTablesValid(*header, cache->m_File.GetData()))
+	{
+		LD_CORE_WARN("Mesh cache {0} is corrupt, reimporting", cachePath);
+
+		return nullptr;
+	}
+
+	// The contents still match, taking the source's new timestamp means later loads skip the hash again
+	// The mapping does not share write access so it is dropped while the header is patched
+	if (timestampChanged)
+	{
+		cache->m_File.Close();
+
+		if (!FileSystem::PatchFile(cachePath, offsetof(MeshCacheHeader, SourceTimestamp), &sourceTimestamp, sizeof(sourceTimestamp)))
+		{
+			LD_CORE_WARN("Could not update the source timestamp of mesh cache {0}", cachePath);
+		}
+
+		if (!cache->m_File.Open(cachePath) || cache->m_File.GetSize() != fileSize)
+		{
+			return nullptr;
+		}
+
+		header = (const MeshCacheHeader*)cache->m_File.GetData();
+	}
+
+	cache->m_Header = header;
+
+	return cache;
+}
+
+std::string MeshCacheFile::GetString(uint32_t offset) const
+{
+	if (offset == s_MeshCacheNoString || offset >= m_Header->StringsSize)
+	{
+		return std::string();
+	}
+
+	const char* strings = (const char*)(m_File.GetData() + m_Header->StringsOffset);
+
+	// Strings are null terminated, the last one is bounded by the blob in case the file was cut short
+	return std::string(strings + offset, strnlen(strings + offset, m_Header->StringsSize - offset));
+}
+
+bool MeshCacheFile::Write(const std::string& sourcePath, uint32_t importFlags, const std::vector<Vertex>& vertices, const std::vector<Index>& indices,
+	const std::vector<Submesh>& submeshes, const std::vector<MeshNode>& nodes, const std::vector<MeshMaterialDescription>& materials)
+{
+	MeshCacheHeader header = {};
+	header.Magic = s_MeshCacheMagic;
+	header.Version = s_MeshCacheVersion;
+	header.VertexSize = sizeof(Vertex);
+	header.ImportFlags = importFlags;
+
+	if (!FileSystem::GetFileInfo(sourcePath, header.SourceSize, header.SourceTimestamp))
+	{
+		return false;
+	}
+
+	header.SourceHash = FileSystem::HashFile(sourcePath);
+
+	std::vector<char> strings;
+
+	auto addString = [&strings](const std::string& string)
+	{
+		if (string.empty())
+		{
+			return s_MeshCacheNoString;
+		}
+
+		uint32_t offset = (uint32_t)strings.size();
+
+		strings.insert(strings.end(), string.begin(), string.end());
+		strings.push_back('\0');
+
+		return offset;
+	};
+
+	std::vector<MeshCacheSubmesh> cacheSubmeshes(submeshes.size());
+
+	for (size_t i = 0; i < submeshes.size(); i++)
+	{
+		const Submesh& submesh = submeshes[i];
+
+		MeshCacheSubmesh& cacheSubmesh = cacheSubmeshes[i];
+		cacheSubmesh.BaseVertex = submesh.BaseVertex;
+		cacheSubmesh.BaseIndex = submesh.BaseIndex;
+		cacheSubmesh.MaterialIndex = submesh.MaterialIndex;
+		cacheSubmesh.IndexCount = submesh.IndexCount;
+		cacheSubmesh.Transform = submesh.Transform;
+		cacheSubmesh.BoundsMin = submesh.BoundingBox.Min;
+		cacheSubmesh.BoundsMax = submesh.BoundingBox.Max;
+		cacheSubmesh.NodeName = addString(submesh.NodeName);
+		cacheSubmesh.MeshName = addString(submesh.MeshName);
+	}
+
+	std::vector<MeshCacheNode> cacheNodes(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		MeshCacheNode& cacheNode = cacheNodes[i];
+		cacheNode.LocalTransform = nodes[i].LocalTransform;
+		cacheNode.Name = addString(nodes[i].Name);
+		cacheNode.FirstChild = nodes[i].FirstChild;
+		cacheNode.ChildCount = nodes[i].ChildCount;
+		cacheNode.Padding = 0;
+	}
+
+	std::vector<MeshCacheMaterial> cacheMaterials(materials.size());
+
+	for (size_t i = 0; i < materials.size(); i++)
+	{
+		const MeshMaterialDescription& material = materials[i];
+
+		MeshCacheMaterial& cacheMaterial = cacheMaterials[i];
+		cacheMaterial.DiffuseColour = material.DiffuseColour;
+		cacheMaterial.Specular = material.Specular;
+		cacheMaterial.Glossiness = material.Glossiness;
+		cacheMaterial.DiffuseMap = addString(material.DiffuseMap);
+		cacheMaterial.NormalMap = addString(material.NormalMap);
+		cacheMaterial.SpecularMap = addString(material.SpecularMap);
+		cacheMaterial.GlossMap = addString(material.GlossMap);
+	}
+
+	header.VertexCount = (uint32_t)vertices.size();
+	header.IndexCount = (uint32_t)indices.size();
+	header.SubmeshCount = (uint32_t)cacheSubmeshes.size();
+	header.NodeCount = (uint32_t)cacheNodes.size();
+	header.MaterialCount = (uint32_t)cacheMaterials.size();
+	header.StringsSize = (uint32_t)strings.size();
+
+	struct Section
+	{
+		uint64_t* Offset;
+		const void* Data;
+		uint64_t Size;
+	};
+
+	Section sections[] =
+	{
+		{ &header.VertexOffset, vertices.data(), vertices.size() * sizeof(Vertex) },
+		{ &header.IndexOffset, indices.data(), indices.size() * sizeof(Index) },
+		{ &header.SubmeshOffset, cacheSubmeshes.data(), cacheSubmeshes.size() * sizeof(MeshCacheSubmesh) },
+		{ &header.NodeOffset, cacheNodes.data(), cacheNodes.size() * sizeof(MeshCacheNode) },
+		{ &header.MaterialOffset, cacheMaterials.data(), cacheMaterials.size() * sizeof(MeshCacheMaterial) },
+		{ &header.StringsOffset, strings.data(), strings.size() }
+	};
+
+	// The header's section offsets are filled in below, before anything is written
+	std::vector<FileSection> fileSections = { { 0, &header, sizeof(MeshCacheHeader) } };
+
+	uint64_t offset = FileSystem::AlignOffset(sizeof(MeshCacheHeader), s_MeshCacheAlignment);
+
+	for (Section& section : sections)
+	{
+		*section.Offset = offset;
+
+		fileSections.push_back({ offset, section.Data, section.Size });
+
+		offset = FileSystem::AlignOffset(offset + section.Size, s_MeshCacheAlignment);
+	}
+
+	std::string cachePath = GetCachePath(sourcePath);
+
+	if (!FileSystem::WriteFile(cachePath, fileSections))
+	{
+		return false;
+	}
+
+	LD_CORE_INFO("Wrote mesh cache {0} ({1} KB)", cachePath, offset / 1024);
+
+	return true;
+}
\ No newline at end of file
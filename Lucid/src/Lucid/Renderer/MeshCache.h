@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Lucid/Core/MappedFile.h"
+
+#include "Lucid/Renderer/Mesh.h"
+
+// Binary cache of an imported mesh, written next to the source file so later loads skip Assimp
+// Layout: header, vertex blob, index blob, submesh table, node table, material table and a string blob, every section 16 byte aligned
+// Vertices and indices are stored exactly as uploaded so they can be read straight out of the mapped file
+
+static constexpr uint32_t s_MeshCacheMagic = 0x434D444C; // "LDMC"
+static constexpr uint32_t s_MeshCacheVersion = 1;
+
+// String offset of a missing string
+static constexpr uint32_t s_MeshCacheNoString = 0xFFFFFFFF;
+
+struct MeshCacheHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+
+	// Layout and import settings the cache was written with, a mismatch means the cache is stale
+	uint32_t VertexSize;
+	uint32_t ImportFlags;
+
+	// The source file the cache was imported from
+	uint64_t SourceSize;
+	int64_t SourceTimestamp;
+	uint64_t SourceHash;
+
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	uint32_t SubmeshCount;
+	uint32_t NodeCount;
+	uint32_t MaterialCount;
+	uint32_t StringsSize;
+
+	uint64_t VertexOffset;
+	uint64_t IndexOffset;
+	uint64_t SubmeshOffset;
+	uint64_t NodeOffset;
+	uint64_t MaterialOffset;
+	uint64_t StringsOffset;
+};
+
+struct MeshCacheSubmesh
+{
+	uint32_t BaseVertex;
+	uint32_t BaseIndex;
+	uint32_t MaterialIndex;
+	uint32_t IndexCount;
+
+	glm::mat4 Transform;
+
+	glm::vec3 BoundsMin;
+	glm::vec3 BoundsMax;
+
+	uint32_t NodeName;
+	uint32_t MeshName;
+};
+
+struct MeshCacheNode
+{
+	glm::mat4 LocalTransform;
+
+	uint32_t Name;
+	uint32_t FirstChild;
+	uint32_t ChildCount;
+	uint32_t Padding;
+};
+
+struct MeshCacheMaterial
+{
+	glm::vec3 DiffuseColour;
+
+	float Specular;
+	float Glossiness;
+
+	uint32_t DiffuseMap;
+	uint32_t NormalMap;
+	uint32_t SpecularMap;
+	uint32_t GlossMap;
+};
+
+// Mapped mesh cache file, the tables point into the mapping and stay valid for the lifetime of the file
+class MeshCacheFile : public RefCounted
+{
+
+public:
+
+	// Maps the cache of a source file, null when there is none or it no longer matches the source
+	// A cache matches when the source's size and timestamp are unchanged, or when the timestamp moved but the contents hash the same
+	// In the second case the cache takes the new timestamp so the source is only hashed once
+	static Ref<MeshCacheFile> Open(const std::string& sourcePath, uint32_t importFlags);
+
+	// Writes the cache of a freshly imported source file, replacing any stale one
+	static bool Write(const std::string& sourcePath, uint32_t importFlags, const std::vector<Vertex>& vertices, const std::vector<Index>& indices,
+		const std::vector<Submesh>& submeshes, const std::vector<MeshNode>& nodes, const std::vector<MeshMaterialDescription>& materials);
+
+	static std::string GetCachePath(const std::string& sourcePath);
+
+	const MeshCacheHeader& GetHeader() const { return *m_Header; }
+
+	uint64_t GetFileSize() const { return m_File.GetSize(); }
+
+	const Vertex* GetVertices() const { return (const Vertex*)(m_File.GetData() + m_Header->VertexOffset); }
+	const Index* GetIndices() const { return (const Index*)(m_File.GetData() + m_Header->IndexOffset); }
+
+	const MeshCacheSubmesh* GetSubmeshes() const { return (const MeshCacheSubmesh*)(m_File.GetData() + m_Header->SubmeshOffset); }
+	const MeshCacheNode* GetNodes() const { return (const MeshCacheNode*)(m_File.GetData() + m_Header->NodeOffset); }
+	const MeshCacheMaterial* GetMaterials() const { return (const MeshCacheMaterial*)(m_File.GetData() + m_Header->MaterialOffset); }
+
+	// Empty for s_MeshCacheNoString
+	std::string GetString(uint32_t offset) const;
+
+private:
+
+	MappedFile m_File;
+
+	const MeshCacheHeader* m_Header = nullptr;
+};
\ No newline at end of file
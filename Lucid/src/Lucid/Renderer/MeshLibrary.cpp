@@ -0,0 +1,156 @@
+#include "ldpch.h"
+
+#include "MeshLibrary.h"
+
+#include <mutex>
+#include <unordered_set>
+
+#include "Lucid/Core/FileSystem.h"
+#include "Lucid/Core/ThreadPool.h"
+
+struct MeshLibraryData
+{
+	std::unordered_map<std::string, Ref<Mesh>> Meshes;
+
+	// Meshes a worker finished loading, waiting for Update to upload them
+	std::mutex LoadedMutex;
+	std::vector<Ref<Mesh>> Loaded;
+
+	uint32_t PendingLoads = 0;
+};
+
+static MeshLibraryData s_Data;
+
+Ref<Mesh> MeshLibrary::Load(const std::string& filepath)
+{
+	std::string canonicalPath = FileSystem::GetCanonicalPath(filepath);
+
+	auto it = s_Data.Meshes.find(canonicalPath);
+
+	if (it != s_Data.Meshes.end())
+	{
+		return it->second;
+	}
+
+	Ref<Mesh> mesh = Ref<Mesh>::Create(filepath);
+
+	s_Data.Meshes[canonicalPath] = mesh;
+
+	return mesh;
+}
+
+Ref<Mesh> MeshLibrary::LoadAsync(const std::string& filepath)
+{
+	std::string canonicalPath = FileSystem::GetCanonicalPath(filepath);
+
+	auto it = s_Data.Meshes.find(canonicalPath);
+
+	if (it != s_Data.Meshes.end())
+	{
+		return it->second;
+	}
+
+	Ref<Mesh> mesh = Ref<Mesh>::Create(filepath, true);
+
+	s_Data.Meshes[canonicalPath] = mesh;
+	s_Data.PendingLoads++;
+
+	// The job's reference keeps the mesh from being released while it loads, the mesh is handed back rather than released on the worker
+	ThreadPool::Get().Enqueue([mesh]() mutable
+	{
+		mesh->Load();
+
+		std::lock_guard<std::mutex> lock(s_Data.LoadedMutex);
+
+		s_Data.Loaded.push_back(mesh);
+	});
+
+	return mesh;
+}
+
+void MeshLibrary::Update()
+{
+	std::vector<Ref<Mesh>> loaded;
+
+	{
+		std::lock_guard<std::mutex> lock(s_Data.LoadedMutex);
+
+		loaded.swap(s_Data.Loaded);
+	}
+
+	for (Ref<Mesh>& mesh : loaded)
+	{
+		mesh->Upload();
+
+		s_Data.PendingLoads--;
+	}
+
+	ReleaseUnused();
+}
+
+uint32_t MeshLibrary::GetPendingLoads()
+{
+	return s_Data.PendingLoads;
+}
+
+void MeshLibrary::ReleaseUnused()
+{
+	for (auto it = s_Data.Meshes.begin(); it != s_Data.Meshes.end();)
+	{
+		// A mesh still loading is also referenced by its job
+		if (it->second->GetRefCount() == 1)
+		{
+			LD_CORE_INFO("Unloading mesh: {0}", it->second->GetFilePath());
+
+			it = s_Data.Meshes.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+std::vector<MeshAsset> MeshLibrary::GetAssets()
+{
+	std::vector<MeshAsset> assets;
+	assets.reserve(s_Data.Meshes.size());
+
+	for (const auto& [path, mesh] : s_Data.Meshes)
+	{
+		MeshAsset& asset = assets.emplace_back();
+		asset.Path = path;
+		asset.References = mesh->GetRefCount() - 1;
+		asset.Loaded = mesh->IsLoaded();
+		asset.Memory = mesh->GetMemoryUsage();
+	}
+
+	std::sort(assets.begin(), assets.end(), [](const MeshAsset& a, const MeshAsset& b) { return a.Path < b.Path; });
+
+	return assets;
+}
+
+std::vector<MeshTextureSource> MeshLibrary::GetTextureSources()
+{
+	std::vector<MeshTextureSource> sources;
+	std::unordered_set<std::string> paths;
+
+	for (const auto& [path, mesh] : s_Data.Meshes)
+	{
+		if (!mesh->IsLoaded())
+		{
+			continue;
+		}
+
+		for (const MeshTextureSource& source : mesh->GetTextureSources())
+		{
+			// A file has one cooked texture, the first material to reference it decides how it is cooked
+			if (paths.insert(FileSystem::GetCanonicalPath(source.Path)).second)
+			{
+				sources.push_back(source);
+			}
+		}
+	}
+
+	return sources;
+}
\ No newline at end of file
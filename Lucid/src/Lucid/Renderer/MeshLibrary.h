@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Lucid/Renderer/Mesh.h"
+
+// A mesh held by the library
+struct MeshAsset
+{
+	// Canonical path the mesh is keyed by
+	std::string Path;
+
+	// Handles held outside the library
+	uint32_t References = 0;
+
+	// False while the mesh is loading asynchronously
+	bool Loaded = false;
+
+	MeshMemoryUsage Memory;
+};
+
+// Shared meshes keyed by canonical path, every entity using a file gets the same mesh rather than importing its own copy
+// The library holds a reference of its own, a mesh is unloaded once that is the only one left
+class MeshLibrary
+{
+
+public:
+
+	// Returns the mesh of a file, loading it on first use
+	// A mesh requested asynchronously before may still be loading, check Mesh::IsLoaded
+	static Ref<Mesh> Load(const std::string& filepath);
+
+	// Returns the mesh of a file straight away, on first use it is empty and loads on the thread pool
+	// Import, cache reads and texture decoding happen on a worker, the GL uploads are submitted by Update once the worker is done
+	static Ref<Mesh> LoadAsync(const std::string& filepath);
+
+	// Uploads meshes whose asynchronous load finished and unloads unused meshes, called once a frame on the main thread
+	static void Update();
+
+	// Unloads meshes that are no longer referenced outside the library
+	static void ReleaseUnused();
+
+	// Asynchronous loads not yet uploaded
+	static uint32_t GetPendingLoads();
+
+	static std::vector<MeshAsset> GetAssets();
+
+	// Image files referenced by the loaded meshes, each file once
+	static std::vector<MeshTextureSource> GetTextureSources();
+};
\ No newline at end of file
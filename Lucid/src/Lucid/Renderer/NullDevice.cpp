@@ -0,0 +1,535 @@
+#include "ldpch.h"
+
+#include "NullDevice.h"
+
+#include <atomic>
+#include <fstream>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+// Every OpenGL function the null device provides, named without the gl prefix so the glad macros are never expanded
+// Functions missing from this list stay null and will fault if called while the null device is active
+#define LD_NULL_DEVICE_FUNCTIONS(X) \
+	X(ActiveTexture) \
+	X(AttachShader) \
+	X(BeginQuery) \
+	X(BindBuffer) \
+	X(BindBufferBase) \
+	X(BindBufferRange) \
+	X(BindFramebuffer) \
+	X(BindTexture) \
+	X(BindTextureUnit) \
+	X(BindVertexArray) \
+	X(BlendEquation) \
+	X(BlendEquationi) \
+	X(BlendFunc) \
+	X(BlendFunci) \
+	X(BlitNamedFramebuffer) \
+	X(CheckFramebufferStatus) \
+	X(CheckNamedFramebufferStatus) \
+	X(Clear) \
+	X(ClearColor) \
+	X(ClearDepth) \
+	X(ClearNamedFramebufferfv) \
+	X(ClearStencil) \
+	X(ClientWaitSync) \
+	X(ColorMask) \
+	X(CompileShader) \
+	X(CompressedTextureSubImage2D) \
+	X(CreateBuffers) \
+	X(CreateFramebuffers) \
+	X(CreateProgram) \
+	X(CreateQueries) \
+	X(CreateShader) \
+	X(CreateTextures) \
+	X(CreateVertexArrays) \
+	X(CullFace) \
+	X(DebugMessageCallback) \
+	X(DeleteBuffers) \
+	X(DeleteFramebuffers) \
+	X(DeleteProgram) \
+	X(DeleteQueries) \
+	X(DeleteShader) \
+	X(DeleteSync) \
+	X(DeleteTextures) \
+	X(DeleteVertexArrays) \
+	X(DepthFunc) \
+	X(DepthMask) \
+	X(DetachShader) \
+	X(Disable) \
+	X(Disablei) \
+	X(DispatchCompute) \
+	X(DrawBuffers) \
+	X(DrawElements) \
+	X(DrawElementsBaseVertex) \
+	X(DrawElementsInstancedBaseVertex) \
+	X(Enable) \
+	X(Enablei) \
+	X(EnableVertexAttribArray) \
+	X(EndQuery) \
+	X(FenceSync) \
+	X(FlushMappedNamedBufferRange) \
+	X(FramebufferTexture) \
+	X(FrontFace) \
+	X(GenBuffers) \
+	X(GenerateMipmap) \
+	X(GenerateTextureMipmap) \
+	X(GenFramebuffers) \
+	X(GenQueries) \
+	X(GenTextures) \
+	X(GenVertexArrays) \
+	X(GetError) \
+	X(GetFloatv) \
+	X(GetIntegerv) \
+	X(GetProgramInfoLog) \
+	X(GetProgramiv) \
+	X(GetQueryObjectiv) \
+	X(GetQueryObjectui64v) \
+	X(GetQueryObjectuiv) \
+	X(GetShaderInfoLog) \
+	X(GetShaderiv) \
+	X(GetString) \
+	X(GetStringi) \
+	X(GetUniformLocation) \
+	X(LineWidth) \
+	X(LinkProgram) \
+	X(MapNamedBufferRange) \
+	X(MemoryBarrier) \
+	X(NamedBufferData) \
+	X(NamedBufferStorage) \
+	X(NamedBufferSubData) \
+	X(NamedFramebufferDrawBuffers) \
+	X(NamedFramebufferTexture) \
+	X(QueryCounter) \
+	X(ReadBuffer) \
+	X(ReadPixels) \
+	X(Scissor) \
+	X(ShaderSource) \
+	X(StencilFunc) \
+	X(StencilMask) \
+	X(StencilOp) \
+	X(StencilOpSeparate) \
+	X(TexImage2D) \
+	X(TexImage2DMultisample) \
+	X(TexParameteri) \
+	X(TexStorage2DMultisample) \
+	X(TextureBarrier) \
+	X(TextureParameterf) \
+	X(TextureParameteri) \
+	X(TextureStorage2D) \
+	X(TextureStorage2DMultisample) \
+	X(TextureSubImage2D) \
+	X(Uniform1f) \
+	X(Uniform1i) \
+	X(Uniform1iv) \
+	X(Uniform2f) \
+	X(Uniform3f) \
+	X(Uniform4f) \
+	X(UniformMatrix3fv) \
+	X(UniformMatrix4fv) \
+	X(UnmapNamedBuffer) \
+	X(UseProgram) \
+	X(VertexAttribDivisor) \
+	X(VertexAttribIPointer) \
+	X(VertexAttribPointer) \
+	X(Viewport)
+
+enum NullDeviceFunction : uint32_t
+{
+	#define LD_NULL_DEVICE_ENUM(name) NullDeviceFunction_##name,
+	LD_NULL_DEVICE_FUNCTIONS(LD_NULL_DEVICE_ENUM)
+	#undef LD_NULL_DEVICE_ENUM
+
+	NullDeviceFunction_Count
+};
+
+static const char* s_FunctionNames[NullDeviceFunction_Count] =
+{
+	#define LD_NULL_DEVICE_NAME(name) "gl" #name,
+	LD_NULL_DEVICE_FUNCTIONS(LD_NULL_DEVICE_NAME)
+	#undef LD_NULL_DEVICE_NAME
+};
+
+struct NullDeviceData
+{
+	bool Initialized = false;
+	bool RecordCallStream = false;
+
+	std::atomic<uint32_t> CallCounts[NullDeviceFunction_Count] = {};
+	std::atomic<uint32_t> FrameCount{ 0 };
+
+	std::vector<uint32_t> CallStream;
+
+	// Object names are shared between all object types, 0 is never handed out
+	GLuint NextObjectName = 1;
+
+	// Backing memory for mapped buffers, keyed by buffer name
+	std::unordered_map<GLuint, std::vector<uint8_t>> MappedBuffers;
+};
+
+static NullDeviceData s_Data;
+
+static void RecordCall(uint32_t function)
+{
+	s_Data.CallCounts[function]++;
+
+	if (s_Data.RecordCallStream)
+	{
+		s_Data.CallStream.push_back(function);
+	}
+}
+
+#pragma region Stubs
+
+// Generic stub generated from the glad function pointer type so the calling convention and arguments always match
+template<uint32_t Function, typename T>
+struct NullFunction;
+
+template<uint32_t Function, typename R, typename... Args>
+struct NullFunction<Function, R(APIENTRYP)(Args...)>
+{
+	static R APIENTRY Call(Args...)
+	{
+		RecordCall(Function);
+
+		return R();
+	}
+};
+
+template<uint32_t Function>
+static void APIENTRY NullGenObjects(GLsizei n, GLuint* names)
+{
+	RecordCall(Function);
+
+	for (GLsizei i = 0; i < n; i++)
+	{
+		names[i] = s_Data.NextObjectName++;
+	}
+}
+
+template<uint32_t Function>
+static void APIENTRY NullCreateTargetObjects(GLenum target, GLsizei n, GLuint* names)
+{
+	NullGenObjects<Function>(n, names);
+}
+
+static GLuint APIENTRY NullCreateShader(GLenum type)
+{
+	RecordCall(NullDeviceFunction_CreateShader);
+
+	return s_Data.NextObjectName++;
+}
+
+static GLuint APIENTRY NullCreateProgram()
+{
+	RecordCall(NullDeviceFunction_CreateProgram);
+
+	return s_Data.NextObjectName++;
+}
+
+// Shaders always compile and link, info logs are always empty
+template<uint32_t Function>
+static void APIENTRY NullGetObjectiv(GLuint object, GLenum pname, GLint* params)
+{
+	RecordCall(Function);
+
+	switch (pname)
+	{
+		case GL_COMPILE_STATUS:
+		case GL_LINK_STATUS:
+		case GL_VALIDATE_STATUS:
+		{
+			*params = GL_TRUE;
+
+			break;
+		}
+		default:
+		{
+			*params = 0;
+
+			break;
+		}
+	}
+}
+
+template<uint32_t Function>
+static void APIENTRY NullGetInfoLog(GLuint object, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	RecordCall(Function);
+
+	if (length)
+	{
+		*length = 0;
+	}
+
+	if (infoLog && bufSize > 0)
+	{
+		infoLog[0] = '\0';
+	}
+}
+
+static const GLubyte* APIENTRY NullGetString(GLenum name)
+{
+	RecordCall(NullDeviceFunction_GetString);
+
+	switch (name)
+	{
+		case GL_VENDOR:		return (const GLubyte*)"Lucid";
+		case GL_RENDERER:	return (const GLubyte*)"Null Device";
+		case GL_VERSION:	return (const GLubyte*)"4.5 Null";
+	}
+
+	return (const GLubyte*)"";
+}
+
+// Only the extensions the engine checks for, as a desktop driver would report them
+static const GLubyte* APIENTRY NullGetStringi(GLenum name, GLuint index)
+{
+	RecordCall(NullDeviceFunction_GetStringi);
+
+	return (const GLubyte*)(name == GL_EXTENSIONS && index == 0 ? "GL_EXT_texture_compression_s3tc" : "");
+}
+
+// Reports conservative limits so code sized from capabilities behaves as it would on a typical GPU
+static void APIENTRY NullGetIntegerv(GLenum pname, GLint* data)
+{
+	RecordCall(NullDeviceFunction_GetIntegerv);
+
+	switch (pname)
+	{
+		case GL_MAX_SAMPLES:						*data = 8; break;
+		case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:	*data = 32; break;
+		case GL_MAX_TEXTURE_SIZE:					*data = 16384; break;
+		case GL_NUM_EXTENSIONS:						*data = 1; break;
+		default:									*data = 0; break;
+	}
+}
+
+static void APIENTRY NullGetFloatv(GLenum pname, GLfloat* data)
+{
+	RecordCall(NullDeviceFunction_GetFloatv);
+
+	*data = pname == GL_MAX_TEXTURE_MAX_ANISOTROPY ? 16.0f : 0.0f;
+}
+
+static GLint APIENTRY NullGetUniformLocation(GLuint program, const GLchar* name)
+{
+	RecordCall(NullDeviceFunction_GetUniformLocation);
+
+	return 0;
+}
+
+static GLenum APIENTRY NullCheckFramebufferStatus(GLenum target)
+{
+	RecordCall(NullDeviceFunction_CheckFramebufferStatus);
+
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static GLenum APIENTRY NullCheckNamedFramebufferStatus(GLuint framebuffer, GLenum target)
+{
+	RecordCall(NullDeviceFunction_CheckNamedFramebufferStatus);
+
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void* APIENTRY NullMapNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+	RecordCall(NullDeviceFunction_MapNamedBufferRange);
+
+	std::vector<uint8_t>& memory = s_Data.MappedBuffers[buffer];
+
+	if (memory.size() < (size_t)(offset + length))
+	{
+		memory.resize((size_t)(offset + length));
+	}
+
+	return memory.data() + offset;
+}
+
+static void APIENTRY NullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	RecordCall(NullDeviceFunction_DeleteBuffers);
+
+	for (GLsizei i = 0; i < n; i++)
+	{
+		s_Data.MappedBuffers.erase(buffers[i]);
+	}
+}
+
+// Queries complete immediately and measure nothing
+template<uint32_t Function, typename T>
+static void APIENTRY NullGetQueryObject(GLuint id, GLenum pname, T* params)
+{
+	RecordCall(Function);
+
+	*params = pname == GL_QUERY_RESULT_AVAILABLE ? 1 : 0;
+}
+
+static GLsync APIENTRY NullFenceSync(GLenum condition, GLbitfield flags)
+{
+	RecordCall(NullDeviceFunction_FenceSync);
+
+	return (GLsync)(uintptr_t)s_Data.NextObjectName++;
+}
+
+static GLenum APIENTRY NullClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+	RecordCall(NullDeviceFunction_ClientWaitSync);
+
+	return GL_ALREADY_SIGNALED;
+}
+
+#pragma endregion
+
+// Points every glad function pointer the engine uses at a stub, no context or driver is needed afterwards
+void NullDevice::Init()
+{
+	LD_CORE_ASSERT(!s_Data.Initialized, "Null device is already initialised!");
+
+	#define LD_NULL_DEVICE_INSTALL(name) glad_gl##name = NullFunction<NullDeviceFunction_##name, decltype(glad_gl##name)>::Call;
+	LD_NULL_DEVICE_FUNCTIONS(LD_NULL_DEVICE_INSTALL)
+	#undef LD_NULL_DEVICE_INSTALL
+
+	// Calls that return data the engine depends on
+	glad_glGenBuffers = NullGenObjects<NullDeviceFunction_GenBuffers>;
+	glad_glGenFramebuffers = NullGenObjects<NullDeviceFunction_GenFramebuffers>;
+	glad_glGenQueries = NullGenObjects<NullDeviceFunction_GenQueries>;
+	glad_glGenTextures = NullGenObjects<NullDeviceFunction_GenTextures>;
+	glad_glGenVertexArrays = NullGenObjects<NullDeviceFunction_GenVertexArrays>;
+	glad_glCreateBuffers = NullGenObjects<NullDeviceFunction_CreateBuffers>;
+	glad_glCreateFramebuffers = NullGenObjects<NullDeviceFunction_CreateFramebuffers>;
+	glad_glCreateVertexArrays = NullGenObjects<NullDeviceFunction_CreateVertexArrays>;
+	glad_glCreateQueries = NullCreateTargetObjects<NullDeviceFunction_CreateQueries>;
+	glad_glCreateTextures = NullCreateTargetObjects<NullDeviceFunction_CreateTextures>;
+	glad_glCreateShader = NullCreateShader;
+	glad_glCreateProgram = NullCreateProgram;
+	glad_glGetShaderiv = NullGetObjectiv<NullDeviceFunction_GetShaderiv>;
+	glad_glGetProgramiv = NullGetObjectiv<NullDeviceFunction_GetProgramiv>;
+	glad_glGetShaderInfoLog = NullGetInfoLog<NullDeviceFunction_GetShaderInfoLog>;
+	glad_glGetProgramInfoLog = NullGetInfoLog<NullDeviceFunction_GetProgramInfoLog>;
+	glad_glGetString = NullGetString;
+	glad_glGetStringi = NullGetStringi;
+	glad_glGetIntegerv = NullGetIntegerv;
+	glad_glGetFloatv = NullGetFloatv;
+	glad_glGetUniformLocation = NullGetUniformLocation;
+	glad_glCheckFramebufferStatus = NullCheckFramebufferStatus;
+	glad_glCheckNamedFramebufferStatus = NullCheckNamedFramebufferStatus;
+	glad_glMapNamedBufferRange = NullMapNamedBufferRange;
+	glad_glDeleteBuffers = NullDeleteBuffers;
+	glad_glGetQueryObjectiv = NullGetQueryObject<NullDeviceFunction_GetQueryObjectiv, GLint>;
+	glad_glGetQueryObjectuiv = NullGetQueryObject<NullDeviceFunction_GetQueryObjectuiv, GLuint>;
+	glad_glGetQueryObjectui64v = NullGetQueryObject<NullDeviceFunction_GetQueryObjectui64v, GLuint64>;
+	glad_glFenceSync = NullFenceSync;
+	glad_glClientWaitSync = NullClientWaitSync;
+
+	s_Data.Initialized = true;
+
+	LD_CORE_INFO("Null device initialised, {0} OpenGL functions stubbed", (uint32_t)NullDeviceFunction_Count);
+}
+
+bool NullDevice::IsInitialized()
+{
+	return s_Data.Initialized;
+}
+
+// Called where a real device would present, counts frames and marks the boundary in the call stream
+void NullDevice::EndFrame()
+{
+	s_Data.FrameCount++;
+
+	if (s_Data.RecordCallStream)
+	{
+		s_Data.CallStream.push_back(s_FrameMarker);
+	}
+}
+
+void NullDevice::SetCallStreamRecording(bool enabled)
+{
+	s_Data.RecordCallStream = enabled;
+}
+
+bool NullDevice::IsRecordingCallStream()
+{
+	return s_Data.RecordCallStream;
+}
+
+const std::vector<uint32_t>& NullDevice::GetCallStream()
+{
+	return s_Data.CallStream;
+}
+
+void NullDevice::ClearCallStream()
+{
+	s_Data.CallStream.clear();
+}
+
+// Writes the call stream as one function name per line, frames are separated by a marker line so streams can be diffed between builds
+bool NullDevice::WriteCallStream(const std::string& filepath)
+{
+	std::ofstream out(filepath, std::ios::out | std::ios::trunc);
+
+	if (!out)
+	{
+		LD_CORE_ERROR("Could not open call stream file '{0}'", filepath);
+
+		return false;
+	}
+
+	uint32_t frame = 0;
+
+	for (uint32_t function : s_Data.CallStream)
+	{
+		if (function == s_FrameMarker)
+		{
+			out << "-- Frame " << frame++ << " --\n";
+		}
+		else
+		{
+			out << s_FunctionNames[function] << "\n";
+		}
+	}
+
+	return true;
+}
+
+uint32_t NullDevice::GetCallCount(const std::string& functionName)
+{
+	for (uint32_t i = 0; i < NullDeviceFunction_Count; i++)
+	{
+		if (functionName == s_FunctionNames[i])
+		{
+			return s_Data.CallCounts[i];
+		}
+	}
+
+	return 0;
+}
+
+uint64_t NullDevice::GetTotalCallCount()
+{
+	uint64_t total = 0;
+
+	for (uint32_t i = 0; i < NullDeviceFunction_Count; i++)
+	{
+		total += s_Data.CallCounts[i];
+	}
+
+	return total;
+}
+
+uint32_t NullDevice::GetFrameCount()
+{
+	return s_Data.FrameCount;
+}
+
+const char* NullDevice::GetFunctionName(uint32_t function)
+{
+	if (function == s_FrameMarker)
+	{
+		return "EndFrame";
+	}
+
+	return function < NullDeviceFunction_Count ? s_FunctionNames[function] : "Unknown";
+}
\ No newline at end of file
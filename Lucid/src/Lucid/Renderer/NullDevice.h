@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Replaces the OpenGL function pointers with stubs that record every call and hand out simulated object names
+// Lets the renderer, scene renderer and asset loading run headless at full CPU cost with no driver underneath
+class NullDevice
+{
+
+public:
+
+	// Marks the end of a frame in the call stream
+	static constexpr uint32_t s_FrameMarker = 0xFFFFFFFF;
+
+	static void Init();
+	static bool IsInitialized();
+
+	static void EndFrame();
+
+	static void SetCallStreamRecording(bool enabled);
+	static bool IsRecordingCallStream();
+
+	// Call stream holds one function index per call, must only be read while the render thread is idle
+	static const std::vector<uint32_t>& GetCallStream();
+	static void ClearCallStream();
+	static bool WriteCallStream(const std::string& filepath);
+
+	static uint32_t GetCallCount(const std::string& functionName);
+	static uint64_t GetTotalCallCount();
+	static uint32_t GetFrameCount();
+
+	static const char* GetFunctionName(uint32_t function);
+};
\ No newline at end of file
@@ -2,57 +2,247 @@
 
 #include "RenderCommandQueue.h"
 
+#include <mutex>
+
 #define LD_RENDER_TRACE(...) LD_CORE_TRACE(__VA_ARGS__)
 
-RenderCommandQueue::RenderCommandQueue()
+// Chunks handed between queues when command lists are stitched together, shared so they are reused rather than reallocated each frame
+static std::mutex s_ChunkPoolMutex;
+static std::vector<std::pair<uint8_t*, uint32_t>> s_ChunkPool;
+
+// Rounds an offset up to the next multiple of a power of two alignment
+static uint32_t AlignUp(uint32_t offset, uint32_t alignment)
 {
-	// Set command buffer to store 10MB of data
-	m_CommandBuffer = new uint8_t[10 * 1024 * 1024];
-	m_CommandBufferPtr = m_CommandBuffer;
-	memset(m_CommandBuffer, 0, 10 * 1024 * 1024);
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// Size of the region a chunk is reserved in, VirtualAlloc hands out memory at this granularity
+static uint32_t GetAllocationGranularity()
+{
+	static uint32_t granularity = 0;
+
+	if (!granularity)
+	{
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+
+		granularity = info.dwAllocationGranularity;
+	}
+
+	return granularity;
+}
+
+RenderCommandQueue::RenderCommandQueue(uint32_t chunkSize)
+	: m_ChunkSize(chunkSize)
+{
+	// Nothing is allocated until the first command is recorded
 }
 
 RenderCommandQueue::~RenderCommandQueue()
 {
-	delete[] m_CommandBuffer;
+	for (CommandChunk& chunk : m_Chunks)
+	{
+		VirtualFree(chunk.Data, 0, MEM_RELEASE);
+	}
 }
 
-void* RenderCommandQueue::Allocate(RenderCommandFn fn, uint32_t size)
+void* RenderCommandQueue::Allocate(RenderCommandFn fn, uint32_t size, uint32_t alignment)
 {
-	*(RenderCommandFn*)m_CommandBufferPtr = fn;
-	m_CommandBufferPtr += sizeof(RenderCommandFn);
+	LD_CORE_ASSERT(alignment && (alignment & (alignment - 1)) == 0, "Render command alignment must be a power of two!");
+
+	if (alignment < alignof(CommandHeader))
+	{
+		alignment = alignof(CommandHeader);
+	}
+
+	// Worst case size of the command if it has to start a new chunk
+	uint32_t requiredSize = AlignUp((uint32_t)sizeof(CommandHeader), alignment) + AlignUp(size, alignof(CommandHeader));
 
-	*(uint32_t*)m_CommandBufferPtr = size;
-	m_CommandBufferPtr += sizeof(uint32_t);
+	if (m_Chunks.empty())
+	{
+		m_CurrentChunk = AcquireChunk(requiredSize);
+	}
 
-	void* memory = m_CommandBufferPtr;
-	m_CommandBufferPtr += size;
+	uint32_t headerOffset = AlignUp(m_Chunks[m_CurrentChunk].Offset, alignof(CommandHeader));
+	uint32_t payloadOffset = AlignUp(headerOffset + sizeof(CommandHeader), alignment);
+	uint32_t endOffset = AlignUp(payloadOffset + size, alignof(CommandHeader));
+
+	// Command doesn't fit, move on to the next chunk with enough space
+	if (endOffset > m_Chunks[m_CurrentChunk].Capacity)
+	{
+		m_CurrentChunk = AcquireChunk(requiredSize);
+
+		headerOffset = 0;
+		payloadOffset = AlignUp(sizeof(CommandHeader), alignment);
+		endOffset = AlignUp(payloadOffset + size, alignof(CommandHeader));
+	}
+
+	CommandChunk& chunk = m_Chunks[m_CurrentChunk];
+
+	CommandHeader* header = (CommandHeader*)(chunk.Data + headerOffset);
+	header->Function = fn;
+	header->PayloadOffset = payloadOffset - headerOffset;
+	header->Stride = endOffset - headerOffset;
+
+	chunk.Offset = endOffset;
 
 	m_CommandCount++;
 
-	return memory;
+	return chunk.Data + payloadOffset;
+}
+
+// Returns the index of the first chunk after the current one that can hold the required size, creating one if needed
+uint32_t RenderCommandQueue::AcquireChunk(uint32_t requiredSize)
+{
+	uint32_t first = m_Chunks.empty() ? 0 : m_CurrentChunk + 1;
+
+	// Reuse chunks from previous frames, any that are too small are left empty and skipped during execution
+	for (uint32_t i = first; i < (uint32_t)m_Chunks.size(); i++)
+	{
+		if (m_Chunks[i].Capacity >= requiredSize)
+		{
+			return i;
+		}
+	}
+
+	CommandChunk chunk;
+
+	// Take a chunk released by a stitched command list before reserving a new one
+	{
+		std::lock_guard<std::mutex> lock(s_ChunkPoolMutex);
+
+		for (size_t i = 0; i < s_ChunkPool.size(); i++)
+		{
+			if (s_ChunkPool[i].second >= requiredSize)
+			{
+				chunk.Data = s_ChunkPool[i].first;
+				chunk.Capacity = s_ChunkPool[i].second;
+
+				s_ChunkPool.erase(s_ChunkPool.begin() + i);
+
+				break;
+			}
+		}
+	}
+
+	if (!chunk.Data)
+	{
+		uint32_t capacity = AlignUp(requiredSize > m_ChunkSize ? requiredSize : m_ChunkSize, GetAllocationGranularity());
+
+		// Pages are committed up front, only physical residency waits for first touch so memory that is never written to stays off the working set
+		chunk.Data = (uint8_t*)VirtualAlloc(nullptr, capacity, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		chunk.Capacity = capacity;
+
+		LD_CORE_ASSERT(chunk.Data, "Failed to allocate render command chunk!");
+	}
+
+	m_Chunks.push_back(chunk);
+
+	m_Stats.ChunkCount = (uint32_t)m_Chunks.size();
+	m_Stats.BytesReserved += chunk.Capacity;
+
+	return (uint32_t)m_Chunks.size() - 1;
+}
+
+// Moves every recorded chunk of another queue into this one, the other queue's commands execute after everything recorded so far
+void RenderCommandQueue::Append(RenderCommandQueue& other)
+{
+	LD_CORE_ASSERT(&other != this, "Cannot append a render command queue to itself!");
+
+	if (other.IsEmpty())
+	{
+		return;
+	}
+
+	uint32_t insertIndex = m_Chunks.empty() ? 0 : m_CurrentChunk + 1;
+
+	for (uint32_t i = 0; i < (uint32_t)other.m_Chunks.size(); )
+	{
+		CommandChunk chunk = other.m_Chunks[i];
+
+		if (chunk.Offset == 0)
+		{
+			i++;
+
+			continue;
+		}
+
+		chunk.Pooled = true;
+
+		m_Chunks.insert(m_Chunks.begin() + insertIndex, chunk);
+		m_CurrentChunk = insertIndex++;
+
+		other.m_Chunks.erase(other.m_Chunks.begin() + i);
+		other.m_Stats.BytesReserved -= chunk.Capacity;
+	}
+
+	m_CommandCount += other.m_CommandCount;
+
+	other.m_Stats.ChunkCount = (uint32_t)other.m_Chunks.size();
+	other.m_CurrentChunk = 0;
+	other.m_CommandCount = 0;
 }
 
 void RenderCommandQueue::Execute()
 {
-	//LD_RENDER_TRACE("RenderCommandQueue::Execute -- {0} commands, {1} bytes", m_CommandCount, (m_CommandBufferPtr - m_CommandBuffer));
+	//LD_RENDER_TRACE("RenderCommandQueue::Execute -- {0} commands, {1} chunks", m_CommandCount, m_Chunks.size());
+
+	// Commands may submit further commands while executing, sizes are re-read so those are executed in the same pass
+	for (uint32_t i = 0; i < (uint32_t)m_Chunks.size(); i++)
+	{
+		uint32_t offset = 0;
+
+		while (offset < m_Chunks[i].Offset)
+		{
+			uint8_t* buffer = m_Chunks[i].Data + offset;
+
+			CommandHeader* header = (CommandHeader*)buffer;
+
+			header->Function(buffer + header->PayloadOffset);
+
+			offset += header->Stride;
+		}
+	}
+
+	Reset();
+}
+
+// Records memory usage for the frame and rewinds every chunk so it can be reused
+void RenderCommandQueue::Reset()
+{
+	uint32_t bytesUsed = 0;
 
-	// Starting memory location for command buffer
-	byte* buffer = m_CommandBuffer;
+	for (CommandChunk& chunk : m_Chunks)
+	{
+		bytesUsed += chunk.Offset;
+
+		chunk.Offset = 0;
+	}
 
-	for (uint32_t i = 0; i < m_CommandCount; i++)
+	// Return chunks that were appended from command lists to the shared pool
 	{
-		RenderCommandFn function = *(RenderCommandFn*)buffer;
+		std::lock_guard<std::mutex> lock(s_ChunkPoolMutex);
+
+		for (const CommandChunk& chunk : m_Chunks)
+		{
+			if (chunk.Pooled)
+			{
+				s_ChunkPool.emplace_back(chunk.Data, chunk.Capacity);
+			}
+		}
+	}
 
-		buffer += sizeof(RenderCommandFn);
+	m_Chunks.erase(std::remove_if(m_Chunks.begin(), m_Chunks.end(), [](const CommandChunk& chunk) { return chunk.Pooled; }), m_Chunks.end());
 
-		uint32_t size = *(uint32_t*)buffer;
+	m_Stats.ChunkCount = (uint32_t)m_Chunks.size();
 
-		buffer += sizeof(uint32_t);
-		function(buffer);
-		buffer += size;
+	m_Stats.CommandCount = m_CommandCount;
+	m_Stats.BytesUsed = bytesUsed;
+	if (bytesUsed > m_Stats.HighWaterMark)
+	{
+		m_Stats.HighWaterMark = bytesUsed;
 	}
 
-	m_CommandBufferPtr = m_CommandBuffer;
+	m_CurrentChunk = 0;
 	m_CommandCount = 0;
 }
\ No newline at end of file
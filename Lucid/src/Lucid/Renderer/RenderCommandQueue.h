@@ -1,5 +1,17 @@
 #pragma once
 
+// Memory usage of a render command queue, the high-water mark is the most memory a single frame has needed
+struct RenderCommandQueueStats
+{
+	uint32_t CommandCount = 0;
+	uint32_t BytesUsed = 0;
+	uint32_t HighWaterMark = 0;
+
+	uint32_t ChunkCount = 0;
+	uint32_t BytesReserved = 0;
+};
+
+// Growable command arena made from page-backed chunks, chunks are allocated on demand and reused every frame
 class RenderCommandQueue
 {
 
@@ -7,16 +19,60 @@ public:
 
 	typedef void(*RenderCommandFn)(void*);
 
-	RenderCommandQueue();
+	RenderCommandQueue(uint32_t chunkSize = s_DefaultChunkSize);
 	~RenderCommandQueue();
 
-	void* Allocate(RenderCommandFn func, uint32_t size);
+	RenderCommandQueue(const RenderCommandQueue&) = delete;
+	RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
+
+	void* Allocate(RenderCommandFn func, uint32_t size, uint32_t alignment = alignof(std::max_align_t));
 
 	void Execute();
 
+	void Append(RenderCommandQueue& other);
+
+	bool IsEmpty() const { return m_CommandCount == 0; }
+
+	const RenderCommandQueueStats& GetStats() const { return m_Stats; }
+
+public:
+
+	static constexpr uint32_t s_DefaultChunkSize = 64 * 1024;
+
+private:
+
+	// Written before every command, the payload follows at an offset that satisfies its alignment
+	struct CommandHeader
+	{
+		RenderCommandFn Function;
+
+		uint32_t PayloadOffset;
+		uint32_t Stride;
+	};
+
+	struct CommandChunk
+	{
+		uint8_t* Data = nullptr;
+
+		uint32_t Capacity = 0;
+		uint32_t Offset = 0;
+
+		// Chunk was appended from another queue and goes back to the shared chunk pool once executed
+		bool Pooled = false;
+	};
+
+	uint32_t AcquireChunk(uint32_t requiredSize);
+
+	void Reset();
+
 private:
 
-	uint8_t* m_CommandBuffer;
-	uint8_t* m_CommandBufferPtr;
+	std::vector<CommandChunk> m_Chunks;
+
+	uint32_t m_ChunkSize;
+	uint32_t m_CurrentChunk = 0;
+
 	uint32_t m_CommandCount = 0;
+
+	RenderCommandQueueStats m_Stats;
 };
\ No newline at end of file
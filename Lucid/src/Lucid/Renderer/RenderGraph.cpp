@@ -0,0 +1,327 @@
+#include "ldpch.h"
+
+#include "RenderGraph.h"
+
+#include <chrono>
+
+#include <glad/glad.h>
+
+#include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderProfiler.h"
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Read(RenderGraphResource resource, int32_t textureUnit, RenderGraphAccess access)
+{
+	LD_CORE_ASSERT(resource < m_Graph.m_Resources.size(), "Unknown render graph resource");
+
+	m_Graph.m_Passes[m_Pass].Reads.push_back({ resource, access, textureUnit });
+
+	return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Write(RenderGraphResource resource, RenderGraphAccess access)
+{
+	LD_CORE_ASSERT(resource < m_Graph.m_Resources.size(), "Unknown render graph resource");
+
+	m_Graph.m_Passes[m_Pass].Writes.push_back({ resource, access, -1 });
+
+	return *this;
+}
+
+void RenderGraph::Reset()
+{
+	m_Resources.clear();
+	m_Passes.clear();
+}
+
+RenderGraphResource RenderGraph::ImportTexture(const char* name, const Ref<Framebuffer>& framebuffer, uint32_t attachment, bool depth)
+{
+	m_Resources.push_back({ name, framebuffer, attachment, depth, nullptr, false });
+
+	return (RenderGraphResource)m_Resources.size() - 1;
+}
+
+RenderGraphResource RenderGraph::ImportBuffer(const char* name, const Ref<StorageBuffer>& buffer)
+{
+	m_Resources.push_back({ name, nullptr, 0, false, buffer, false });
+
+	return (RenderGraphResource)m_Resources.size() - 1;
+}
+
+void RenderGraph::SetOutput(RenderGraphResource resource)
+{
+	m_Resources[resource].Output = true;
+}
+
+RenderGraphPassBuilder RenderGraph::AddPass(const char* name, const Ref<RenderPass>& renderPass, std::function<void()> execute, bool clear)
+{
+	Pass pass;
+	pass.Name = name;
+	pass.RenderPass = renderPass;
+	pass.Clear = clear;
+	pass.Execute = std::move(execute);
+
+	m_Passes.push_back(std::move(pass));
+
+	return RenderGraphPassBuilder(*this, (uint32_t)m_Passes.size() - 1);
+}
+
+// Walks the passes backwards tracking which resources are still waiting on a writer, a pass is live if it writes one of them
+// A live pass satisfies the resources it writes and then needs everything it reads, so a read-modify-write keeps the earlier writer alive
+void RenderGraph::Cull(std::vector<bool>& alive) const
+{
+	std::vector<bool> needed(m_Resources.size(), false);
+
+	for (size_t i = 0; i < m_Resources.size(); i++)
+	{
+		needed[i] = m_Resources[i].Output;
+	}
+
+	alive.assign(m_Passes.size(), false);
+
+	for (size_t i = m_Passes.size(); i-- > 0;)
+	{
+		const Pass& pass = m_Passes[i];
+
+		for (const ResourceUse& write : pass.Writes)
+		{
+			if (needed[write.Resource])
+			{
+				alive[i] = true;
+
+				break;
+			}
+		}
+
+		if (!alive[i])
+		{
+			continue;
+		}
+
+		for (const ResourceUse& write : pass.Writes)
+		{
+			needed[write.Resource] = false;
+		}
+
+		for (const ResourceUse& read : pass.Reads)
+		{
+			needed[read.Resource] = true;
+		}
+	}
+}
+
+// A transient attachment lives from the first to the last live pass that uses it, graph outputs live past the last pass
+// Attachments with disjoint lifetimes can share a pooled texture, attachments of culled passes get none
+void RenderGraph::AllocateTransients(const std::vector<bool>& alive) const
+{
+	std::vector<int32_t> firstPass(m_Resources.size(), -1);
+	std::vector<int32_t> lastPass(m_Resources.size(), -1);
+
+	for (size_t i = 0; i < m_Passes.size(); i++)
+	{
+		if (!alive[i])
+		{
+			continue;
+		}
+
+		for (const std::vector<ResourceUse>* uses : { &m_Passes[i].Reads, &m_Passes[i].Writes })
+		{
+			for (const ResourceUse& use : *uses)
+			{
+				if (firstPass[use.Resource] < 0)
+				{
+					firstPass[use.Resource] = (int32_t)i;
+				}
+
+				lastPass[use.Resource] = (int32_t)i;
+			}
+		}
+	}
+
+	std::vector<RenderGraphResource> transients;
+
+	for (size_t i = 0; i < m_Resources.size(); i++)
+	{
+		const Resource& resource = m_Resources[i];
+
+		if (resource.Framebuffer && firstPass[i] >= 0 && resource.Framebuffer->GetSpecification().m_AttachmentSpecs.at(resource.Attachment).Transient)
+		{
+			if (resource.Output)
+			{
+				lastPass[i] = (int32_t)m_Passes.size();
+			}
+
+			transients.push_back((RenderGraphResource)i);
+		}
+	}
+
+	// The pool reuses textures greedily, which needs the allocations in order of first use
+	std::stable_sort(transients.begin(), transients.end(), [&firstPass](RenderGraphResource a, RenderGraphResource b)
+	{
+		return firstPass[a] < firstPass[b];
+	});
+
+	FramebufferPool& pool = *FramebufferPool::GetGlobal();
+
+	pool.BeginFrame();
+
+	for (RenderGraphResource index : transients)
+	{
+		const Resource& resource = m_Resources[index];
+
+		Ref<Framebuffer> framebuffer = resource.Framebuffer;
+		const FramebufferSpecification& spec = framebuffer->GetSpecification();
+
+		Ref<TransientTexture> texture = pool.AllocateBuffer(spec.m_AttachmentSpecs.at(resource.Attachment), spec.Width, spec.Height, firstPass[index], lastPass[index]);
+
+		framebuffer->SetTransientAttachment(resource.Attachment, texture, pool.GetFrame());
+	}
+
+	pool.EndFrame();
+}
+
+// Writes through the framebuffer are visible to later commands without a barrier, storage writes are not
+// Sampling a texture the same pass renders to needs a texture barrier instead
+uint32_t RenderGraph::GetBarriers(const Pass& pass, const std::vector<int32_t>& lastWriteAccess, bool& textureBarrier) const
+{
+	uint32_t barriers = 0;
+
+	textureBarrier = false;
+
+	for (const ResourceUse& read : pass.Reads)
+	{
+		if (lastWriteAccess[read.Resource] == (int32_t)RenderGraphAccess::Storage)
+		{
+			switch (read.Access)
+			{
+				case RenderGraphAccess::RenderTarget:
+				{
+					barriers |= GL_FRAMEBUFFER_BARRIER_BIT;
+
+					break;
+				}
+				case RenderGraphAccess::Texture:
+				{
+					barriers |= GL_TEXTURE_FETCH_BARRIER_BIT;
+
+					break;
+				}
+				case RenderGraphAccess::Storage:
+				{
+					barriers |= GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+
+					break;
+				}
+			}
+		}
+
+		if (read.Access == RenderGraphAccess::Texture)
+		{
+			for (const ResourceUse& write : pass.Writes)
+			{
+				if (write.Resource == read.Resource && write.Access == RenderGraphAccess::RenderTarget)
+				{
+					textureBarrier = true;
+				}
+			}
+		}
+	}
+
+	return barriers;
+}
+
+void RenderGraph::Execute()
+{
+	std::vector<bool> alive;
+
+	Cull(alive);
+
+	AllocateTransients(alive);
+
+	// Access of the last live pass to write each resource this frame, -1 when not yet written
+	std::vector<int32_t> lastWriteAccess(m_Resources.size(), -1);
+
+	m_PassStats.resize(m_Passes.size());
+
+	for (size_t i = 0; i < m_Passes.size(); i++)
+	{
+		const Pass& pass = m_Passes[i];
+
+		RenderGraphPassStats& stats = m_PassStats[i];
+		stats = {};
+		stats.Name = pass.Name;
+		stats.Culled = !alive[i];
+
+		if (stats.Culled)
+		{
+			continue;
+		}
+
+		auto recordStart = std::chrono::high_resolution_clock::now();
+
+		RenderProfiler::BeginScope(pass.Name);
+
+		bool textureBarrier = false;
+
+		stats.Barriers = GetBarriers(pass, lastWriteAccess, textureBarrier);
+
+		if (stats.Barriers || textureBarrier)
+		{
+			uint32_t barriers = stats.Barriers;
+
+			Renderer::Submit([barriers, textureBarrier]()
+			{
+				if (barriers)
+				{
+					glMemoryBarrier(barriers);
+				}
+
+				if (textureBarrier)
+				{
+					glTextureBarrier();
+				}
+			});
+		}
+
+		if (pass.RenderPass)
+		{
+			Renderer::BeginRenderPass(pass.RenderPass, pass.Clear);
+		}
+
+		for (const ResourceUse& read : pass.Reads)
+		{
+			const Resource& resource = m_Resources[read.Resource];
+
+			if (resource.Buffer)
+			{
+				resource.Buffer->Bind();
+			}
+			else if (read.TextureUnit >= 0)
+			{
+				if (resource.Depth)
+				{
+					resource.Framebuffer->BindDepthAttachment(resource.Attachment, read.TextureUnit);
+				}
+				else
+				{
+					resource.Framebuffer->BindColourAttachment(resource.Attachment, read.TextureUnit);
+				}
+			}
+		}
+
+		pass.Execute();
+
+		if (pass.RenderPass)
+		{
+			Renderer::EndRenderPass();
+		}
+
+		RenderProfiler::EndScope();
+
+		for (const ResourceUse& write : pass.Writes)
+		{
+			lastWriteAccess[write.Resource] = (int32_t)write.Access;
+		}
+
+		stats.RecordTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - recordStart).count();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Lucid/Core/Base.h"
+
+#include "Lucid/Renderer/Framebuffer.h"
+#include "Lucid/Renderer/RenderPass.h"
+#include "Lucid/Renderer/StorageBuffer.h"
+
+// How a pass touches a resource, decides the barrier a later pass needs before reading it
+enum class RenderGraphAccess
+{
+	// Written through the bound framebuffer, or read as a blit source
+	RenderTarget = 0,
+
+	// Sampled through a texture unit
+	Texture = 1,
+
+	// Shader storage buffer or image load/store
+	Storage = 2
+};
+
+typedef uint32_t RenderGraphResource;
+
+struct RenderGraphPassStats
+{
+	const char* Name = nullptr;
+
+	bool Culled = false;
+
+	// Milliseconds spent recording the pass on the main thread
+	float RecordTime = 0.0f;
+
+	// glMemoryBarrier bits issued before the pass
+	uint32_t Barriers = 0;
+};
+
+class RenderGraph;
+
+// Declares the resources of the pass it was returned for, valid until the next pass is added
+class RenderGraphPassBuilder
+{
+
+public:
+
+	RenderGraphPassBuilder(RenderGraph& graph, uint32_t pass)
+		: m_Graph(graph), m_Pass(pass) {}
+
+	// Textures are bound to the given unit and buffers to their binding before the pass runs, a unit of -1 only declares the dependency
+	RenderGraphPassBuilder& Read(RenderGraphResource resource, int32_t textureUnit = -1, RenderGraphAccess access = RenderGraphAccess::Texture);
+	RenderGraphPassBuilder& Write(RenderGraphResource resource, RenderGraphAccess access = RenderGraphAccess::RenderTarget);
+
+private:
+
+	RenderGraph& m_Graph;
+	uint32_t m_Pass;
+};
+
+// Frame graph of render passes and the framebuffer attachments and storage buffers they read and write, rebuilt every frame
+// Passes run in the order they were added, a pass is culled when nothing read by a later live pass or by the graph outputs is written by it
+class RenderGraph
+{
+
+public:
+
+	void Reset();
+
+	RenderGraphResource ImportTexture(const char* name, const Ref<Framebuffer>& framebuffer, uint32_t attachment, bool depth = false);
+	RenderGraphResource ImportBuffer(const char* name, const Ref<StorageBuffer>& buffer);
+
+	// Resources used after the graph has run, their writers are never culled
+	void SetOutput(RenderGraphResource resource);
+
+	// The render pass is begun before and ended after the pass runs, passes that switch targets themselves pass null
+	RenderGraphPassBuilder AddPass(const char* name, const Ref<RenderPass>& renderPass, std::function<void()> execute, bool clear = true);
+
+	// Culls unused passes, assigns pooled textures to transient attachments from the lifetimes of the rest then records them with their barriers and bindings
+	void Execute();
+
+	const std::vector<RenderGraphPassStats>& GetPassStats() const { return m_PassStats; }
+
+private:
+
+	struct Resource
+	{
+		const char* Name;
+
+		Ref<Framebuffer> Framebuffer;
+		uint32_t Attachment;
+		bool Depth;
+
+		Ref<StorageBuffer> Buffer;
+
+		bool Output;
+	};
+
+	struct ResourceUse
+	{
+		RenderGraphResource Resource;
+		RenderGraphAccess Access;
+		int32_t TextureUnit;
+	};
+
+	struct Pass
+	{
+		const char* Name;
+
+		Ref<RenderPass> RenderPass;
+		bool Clear;
+
+		std::function<void()> Execute;
+
+		std::vector<ResourceUse> Reads;
+		std::vector<ResourceUse> Writes;
+	};
+
+	void Cull(std::vector<bool>& alive) const;
+
+	void AllocateTransients(const std::vector<bool>& alive) const;
+
+	uint32_t GetBarriers(const Pass& pass, const std::vector<int32_t>& lastWriteAccess, bool& textureBarrier) const;
+
+private:
+
+	std::vector<Resource> m_Resources;
+	std::vector<Pass> m_Passes;
+
+	std::vector<RenderGraphPassStats> m_PassStats;
+
+	friend class RenderGraphPassBuilder;
+};
\ No newline at end of file
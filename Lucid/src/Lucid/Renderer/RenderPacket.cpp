@@ -0,0 +1,563 @@
+#include "ldpch.h"
+
+#include "RenderPacket.h"
+
+#include <chrono>
+#include <mutex>
+
+#include <glad/glad.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderState.h"
+
+struct RenderPacketStatsData
+{
+	// Counters of the frame being executed, only touched by the render thread
+	RenderPacketStats FrameStats;
+
+	// Counters of the last completed frame, read from the main thread
+	RenderPacketStats Stats;
+	std::mutex StatsMutex;
+};
+
+static RenderPacketStatsData s_StatsData;
+
+// Packets of one submesh are drawn instanced once there are at least this many of them
+static constexpr uint32_t s_MinInstanceCount = 2;
+
+// Shader storage binding the instanced shaders read their transforms from
+static constexpr uint32_t s_InstanceBufferBinding = 0;
+
+// Smallest instance buffer allocation, in bytes
+static constexpr uint32_t s_MinInstanceBufferSize = 64 * 1024;
+
+// Streamed buffer of instance transforms, only touched by the render thread
+struct InstanceBufferData
+{
+	RendererID Buffer = 0;
+	uint32_t Capacity = 0;
+};
+
+static InstanceBufferData s_InstanceBuffer;
+
+// Streams transforms into the instance buffer, the previous contents are orphaned so draws still reading them do not stall the upload
+static void UploadInstanceTransforms(const std::vector<glm::mat4>& transforms)
+{
+	uint32_t size = (uint32_t)(transforms.size() * sizeof(glm::mat4));
+
+	if (!s_InstanceBuffer.Buffer)
+	{
+		glCreateBuffers(1, &s_InstanceBuffer.Buffer);
+	}
+
+	if (size > s_InstanceBuffer.Capacity)
+	{
+		uint32_t capacity = s_InstanceBuffer.Capacity ? s_InstanceBuffer.Capacity : s_MinInstanceBufferSize;
+
+		while (capacity < size)
+		{
+			capacity *= 2;
+		}
+
+		s_InstanceBuffer.Capacity = capacity;
+	}
+
+	glNamedBufferData(s_InstanceBuffer.Buffer, s_InstanceBuffer.Capacity, nullptr, GL_STREAM_DRAW);
+	glNamedBufferSubData(s_InstanceBuffer.Buffer, 0, size, transforms.data());
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, s_InstanceBufferBinding, s_InstanceBuffer.Buffer);
+}
+
+// Sorts packets by key and draws them, state is only changed when it differs from the previous packet
+void RenderPacketList::Dispatch()
+{
+	uint32_t packetCount = (uint32_t)Packets.size();
+
+	auto sortStart = std::chrono::high_resolution_clock::now();
+
+	m_SortEntries.resize(packetCount);
+
+	for (uint32_t i = 0; i < packetCount; i++)
+	{
+		m_SortEntries[i] = { Packets[i].SortKey, i };
+	}
+
+	RadixSort(m_SortEntries, m_SortScratch);
+
+	s_StatsData.FrameStats.SortTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - sortStart).count();
+	s_StatsData.FrameStats.Packets += packetCount;
+	s_StatsData.FrameStats.Dispatches++;
+
+	BuildDrawGroups();
+
+	if (!m_InstanceTransforms.empty())
+	{
+		UploadInstanceTransforms(m_InstanceTransforms);
+	}
+
+	// Shader state is the shader index doubled plus one for its instanced variant, material uniforms are per program so switching re-uploads them
+	uint32_t currentShader = UINT32_MAX;
+	uint32_t currentMaterial = UINT32_MAX;
+	uint32_t currentVertexArray = UINT32_MAX;
+
+	int32_t transformLocation = -1;
+	int32_t instanceOffsetLocation = -1;
+
+	for (const DrawGroup& group : m_Groups)
+	{
+		const DrawPacket& packet = Packets[m_DrawEntries[group.FirstEntry]];
+		const PacketMaterial& material = Materials[packet.MaterialIndex];
+
+		PacketShader& shader = Shaders[material.ShaderIndex];
+		Ref<Shader>& program = group.Instanced ? shader.InstancedShader : shader.Shader;
+
+		// Shader
+		uint32_t shaderState = material.ShaderIndex * 2 + (group.Instanced ? 1 : 0);
+
+		if (shaderState != currentShader)
+		{
+			RenderState::UseProgram(program->GetRendererID());
+
+			if (group.Instanced)
+			{
+				if (!shader.InstanceOffsetResolved)
+				{
+					shader.InstanceOffsetLocation = glGetUniformLocation(program->GetRendererID(), "r_InstanceOffset");
+					shader.InstanceOffsetResolved = true;
+				}
+
+				instanceOffsetLocation = shader.InstanceOffsetLocation;
+			}
+			else
+			{
+				if (!shader.TransformResolved)
+				{
+					shader.TransformLocation = glGetUniformLocation(program->GetRendererID(), "u_Transform");
+					shader.TransformResolved = true;
+				}
+
+				transformLocation = shader.TransformLocation;
+			}
+
+			currentShader = shaderState;
+			currentMaterial = UINT32_MAX;
+		}
+
+		// Material
+		if (packet.MaterialIndex != currentMaterial)
+		{
+			if (material.VSUniformSize)
+			{
+				program->SetVSMaterialUniformBufferFromRenderThread(Memory(UniformStorage.data() + material.VSUniformOffset, material.VSUniformSize));
+			}
+
+			if (material.FSUniformSize)
+			{
+				program->SetFSMaterialUniformBufferFromRenderThread(Memory(UniformStorage.data() + material.FSUniformOffset, material.FSUniformSize));
+			}
+
+			for (uint32_t i = 0; i < material.TextureCount; i++)
+			{
+				const PacketTexture& texture = Textures[material.FirstTexture + i];
+
+				RenderState::BindTextureUnit(texture.Slot, texture.Texture->GetRendererID());
+			}
+
+			RenderState::SetDepthTest(material.DepthTest);
+
+			currentMaterial = packet.MaterialIndex;
+		}
+
+		// Vertex array
+		if (packet.VertexArrayIndex != currentVertexArray)
+		{
+			RenderState::BindVertexArray(VertexArrays[packet.VertexArrayIndex]->GetRendererID());
+
+			currentVertexArray = packet.VertexArrayIndex;
+		}
+
+		if (group.Instanced)
+		{
+			if (instanceOffsetLocation != -1)
+			{
+				glUniform1i(instanceOffsetLocation, group.InstanceOffset);
+			}
+
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, packet.IndexCount, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * packet.BaseIndex), group.Count, packet.BaseVertex);
+
+			s_StatsData.FrameStats.DrawCalls++;
+			s_StatsData.FrameStats.InstancedDrawCalls++;
+			s_StatsData.FrameStats.Instances += group.Count;
+
+			continue;
+		}
+
+		for (uint32_t i = 0; i < group.Count; i++)
+		{
+			const DrawPacket& groupPacket = Packets[m_DrawEntries[group.FirstEntry + i]];
+
+			if (transformLocation != -1)
+			{
+				glUniformMatrix4fv(transformLocation, 1, GL_FALSE, glm::value_ptr(groupPacket.Transform));
+			}
+
+			glDrawElementsBaseVertex(GL_TRIANGLES, groupPacket.IndexCount, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * groupPacket.BaseIndex), groupPacket.BaseVertex);
+
+			s_StatsData.FrameStats.DrawCalls++;
+		}
+	}
+}
+
+// Splits the sorted packets into runs that share material and vertex array, runs whose shader has an instanced variant are grouped by submesh
+void RenderPacketList::BuildDrawGroups()
+{
+	m_DrawEntries.clear();
+	m_Groups.clear();
+	m_InstanceTransforms.clear();
+
+	uint32_t entryCount = (uint32_t)m_SortEntries.size();
+	uint32_t runStart = 0;
+
+	while (runStart < entryCount)
+	{
+		const DrawPacket& first = Packets[m_SortEntries[runStart].Value];
+
+		// Key fields wrap so the indices themselves are compared
+		uint32_t runEnd = runStart + 1;
+
+		while (runEnd < entryCount)
+		{
+			const DrawPacket& packet = Packets[m_SortEntries[runEnd].Value];
+
+			if (packet.MaterialIndex != first.MaterialIndex || packet.VertexArrayIndex != first.VertexArrayIndex)
+			{
+				break;
+			}
+
+			runEnd++;
+		}
+
+		bool instanced = Instancing && runEnd - runStart >= s_MinInstanceCount && Shaders[Materials[first.MaterialIndex].ShaderIndex].InstancedShader;
+
+		if (instanced)
+		{
+			AddInstancedRun(runStart, runEnd);
+		}
+		else
+		{
+			m_Groups.push_back({ (uint32_t)m_DrawEntries.size(), runEnd - runStart, 0, false });
+
+			for (uint32_t i = runStart; i < runEnd; i++)
+			{
+				m_DrawEntries.push_back(m_SortEntries[i].Value);
+			}
+		}
+
+		runStart = runEnd;
+	}
+}
+
+// Groups a run by submesh in order of each submesh's nearest packet, submeshes with too few packets are drawn one at a time
+void RenderPacketList::AddInstancedRun(uint32_t runStart, uint32_t runEnd)
+{
+	uint32_t runSize = runEnd - runStart;
+
+	m_RunGroupIndices.clear();
+	m_RunGroups.resize(runSize);
+	m_RunGroupCounts.clear();
+
+	for (uint32_t i = 0; i < runSize; i++)
+	{
+		const DrawPacket& packet = Packets[m_SortEntries[runStart + i].Value];
+
+		uint64_t submesh = ((uint64_t)packet.BaseIndex << 32) | packet.BaseVertex;
+
+		auto it = m_RunGroupIndices.find(submesh);
+
+		if (it == m_RunGroupIndices.end())
+		{
+			it = m_RunGroupIndices.emplace(submesh, (uint32_t)m_RunGroupCounts.size()).first;
+
+			m_RunGroupCounts.push_back(0);
+		}
+
+		m_RunGroups[i] = it->second;
+		m_RunGroupCounts[it->second]++;
+	}
+
+	uint32_t firstGroup = (uint32_t)m_Groups.size();
+	uint32_t firstEntry = (uint32_t)m_DrawEntries.size();
+
+	// Counts become the insert position of each group in the draw entries
+	for (uint32_t count : m_RunGroupCounts)
+	{
+		m_Groups.push_back({ firstEntry, count, 0, count >= s_MinInstanceCount });
+
+		firstEntry += count;
+	}
+
+	m_DrawEntries.resize(firstEntry);
+
+	for (uint32_t i = 0; i < (uint32_t)m_RunGroupCounts.size(); i++)
+	{
+		m_RunGroupCounts[i] = m_Groups[firstGroup + i].FirstEntry;
+	}
+
+	for (uint32_t i = 0; i < runSize; i++)
+	{
+		m_DrawEntries[m_RunGroupCounts[m_RunGroups[i]]++] = m_SortEntries[runStart + i].Value;
+	}
+
+	for (uint32_t i = firstGroup; i < (uint32_t)m_Groups.size(); i++)
+	{
+		DrawGroup& group = m_Groups[i];
+
+		if (!group.Instanced)
+		{
+			continue;
+		}
+
+		group.InstanceOffset = (uint32_t)m_InstanceTransforms.size();
+
+		for (uint32_t j = 0; j < group.Count; j++)
+		{
+			m_InstanceTransforms.push_back(Packets[m_DrawEntries[group.FirstEntry + j]].Transform);
+		}
+	}
+}
+
+// Publishes the counters of the frame that just finished executing
+void RenderPacketList::EndFrame()
+{
+	std::lock_guard<std::mutex> lock(s_StatsData.StatsMutex);
+
+	s_StatsData.Stats = s_StatsData.FrameStats;
+	s_StatsData.FrameStats = {};
+}
+
+RenderPacketStats RenderPacketList::GetStats()
+{
+	std::lock_guard<std::mutex> lock(s_StatsData.StatsMutex);
+
+	return s_StatsData.Stats;
+}
+
+RenderPacketBucket::RenderPacketBucket(uint32_t pass)
+	: m_Pass(pass)
+{
+	Reset();
+}
+
+// Sets the view used to compute the depth part of each sort key
+void RenderPacketBucket::Begin(const glm::mat4& viewMatrix, float farClip)
+{
+	m_ViewMatrix = viewMatrix;
+	m_FarClip = farClip > 0.0f ? farClip : 1.0f;
+}
+
+// Registers the state of every visible submesh and reserves one packet each, transforms are written afterwards with SetTransform
+RenderPacketRange RenderPacketBucket::AddMesh(Ref<Mesh> mesh, Ref<MaterialInstance> overrideMaterial, const uint8_t* submeshVisibility)
+{
+	RenderPacketRange range;
+	range.First = (uint32_t)m_List->Packets.size();
+
+	uint32_t vertexArrayIndex = AddVertexArray(mesh->GetVertexArray());
+
+	const auto& materials = mesh->GetMaterials();
+	const auto& submeshes = mesh->GetSubmeshes();
+
+	for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++)
+	{
+		if (submeshVisibility && !submeshVisibility[i])
+		{
+			continue;
+		}
+
+		const Submesh& submesh = submeshes[i];
+
+		Ref<MaterialInstance> material = overrideMaterial ? overrideMaterial : materials[submesh.MaterialIndex];
+
+		uint32_t materialIndex = AddMaterial(material);
+		uint32_t shaderIndex = m_List->Materials[materialIndex].ShaderIndex;
+
+		DrawPacket packet;
+		packet.SortKey = RenderPacketKey::Encode(m_Pass, shaderIndex, materialIndex, vertexArrayIndex);
+		packet.MaterialIndex = materialIndex;
+		packet.VertexArrayIndex = vertexArrayIndex;
+		packet.IndexCount = submesh.IndexCount;
+		packet.BaseIndex = submesh.BaseIndex;
+		packet.BaseVertex = submesh.BaseVertex;
+		packet.Transform = submesh.Transform;
+
+		m_List->Packets.push_back(packet);
+	}
+
+	range.Count = (uint32_t)m_List->Packets.size() - range.First;
+
+	return range;
+}
+
+// Writes world transforms and view depth into a mesh's packets, only touches the given range so disjoint ranges can be written in parallel
+// Submesh visibility must match the one the range was added with
+void RenderPacketBucket::SetTransform(const RenderPacketRange& range, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshVisibility)
+{
+	const auto& submeshes = mesh->GetSubmeshes();
+
+	uint32_t packetIndex = range.First;
+
+	for (uint32_t i = 0; i < (uint32_t)submeshes.size(); i++)
+	{
+		if (submeshVisibility && !submeshVisibility[i])
+		{
+			continue;
+		}
+
+		LD_CORE_ASSERT(packetIndex < range.First + range.Count, "Packet range does not match mesh");
+
+		const Submesh& submesh = submeshes[i];
+
+		DrawPacket& packet = m_List->Packets[packetIndex++];
+		packet.Transform = transform * submesh.Transform;
+
+		glm::vec3 centre = (submesh.BoundingBox.Min + submesh.BoundingBox.Max) * 0.5f;
+		glm::vec4 viewPosition = m_ViewMatrix * packet.Transform * glm::vec4(centre, 1.0f);
+
+		uint32_t depth = RenderPacketKey::QuantiseDepth(-viewPosition.z / m_FarClip);
+
+		packet.SortKey = (packet.SortKey & ~RenderPacketKey::DepthMask) | ((uint64_t)depth << RenderPacketKey::DepthShift);
+	}
+}
+
+// Submits a single command that sorts and draws every recorded packet, the bucket starts a new list for the next flush
+void RenderPacketBucket::Flush()
+{
+	if (!m_List->Packets.empty())
+	{
+		m_List->Instancing = m_Instancing;
+
+		Ref<RenderPacketList> list = m_List;
+
+		Renderer::Submit([list]()
+		{
+			list->Dispatch();
+		});
+	}
+
+	m_LastPacketCount = (uint32_t)m_List->Packets.size();
+
+	Reset();
+}
+
+uint32_t RenderPacketBucket::AddShader(const Ref<Shader>& shader)
+{
+	auto it = m_ShaderIndices.find(shader.Raw());
+
+	if (it != m_ShaderIndices.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = (uint32_t)m_List->Shaders.size();
+
+	RenderPacketList::PacketShader packetShader;
+	packetShader.Shader = shader;
+
+	// Shaders with an "<name>Instanced" variant in the shader library can draw repeated submeshes with one call
+	Ref<ShaderLibrary> shaderLibrary = Renderer::GetShaderLibrary();
+
+	std::string instancedName = shader->GetName() + "Instanced";
+
+	if (shaderLibrary->Exists(instancedName))
+	{
+		packetShader.InstancedShader = shaderLibrary->Get(instancedName);
+	}
+
+	m_List->Shaders.push_back(packetShader);
+	m_ShaderIndices[shader.Raw()] = index;
+
+	return index;
+}
+
+// Copies a material's uniform values and textures into the list, instance textures are recorded after the base material's so they take precedence
+uint32_t RenderPacketBucket::AddMaterial(Ref<MaterialInstance> material)
+{
+	auto it = m_MaterialIndices.find(material.Raw());
+
+	if (it != m_MaterialIndices.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = (uint32_t)m_List->Materials.size();
+
+	RenderPacketList::PacketMaterial packetMaterial;
+	packetMaterial.ShaderIndex = AddShader(material->GetShader());
+
+	packetMaterial.VSUniformSize = material->m_VSUniformStorageBuffer ? material->m_VSUniformStorageBuffer.Size : 0;
+	packetMaterial.VSUniformOffset = CopyUniforms(material->m_VSUniformStorageBuffer);
+	packetMaterial.FSUniformSize = material->m_FSUniformStorageBuffer ? material->m_FSUniformStorageBuffer.Size : 0;
+	packetMaterial.FSUniformOffset = CopyUniforms(material->m_FSUniformStorageBuffer);
+
+	packetMaterial.FirstTexture = (uint32_t)m_List->Textures.size();
+
+	for (const auto* textures : { &material->m_Material->m_Textures, &material->m_Textures })
+	{
+		for (size_t slot = 0; slot < textures->size(); slot++)
+		{
+			if ((*textures)[slot])
+			{
+				m_List->Textures.push_back({ (uint32_t)slot, (*textures)[slot] });
+			}
+		}
+	}
+
+	packetMaterial.TextureCount = (uint32_t)m_List->Textures.size() - packetMaterial.FirstTexture;
+	packetMaterial.DepthTest = material->GetFlag(MaterialFlag::DepthTest);
+
+	m_List->Materials.push_back(packetMaterial);
+	m_MaterialIndices[material.Raw()] = index;
+
+	return index;
+}
+
+uint32_t RenderPacketBucket::AddVertexArray(const Ref<VertexArray>& vertexArray)
+{
+	auto it = m_VertexArrayIndices.find(vertexArray.Raw());
+
+	if (it != m_VertexArrayIndices.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = (uint32_t)m_List->VertexArrays.size();
+
+	m_List->VertexArrays.push_back(vertexArray);
+	m_VertexArrayIndices[vertexArray.Raw()] = index;
+
+	return index;
+}
+
+uint32_t RenderPacketBucket::CopyUniforms(const Memory& buffer)
+{
+	uint32_t offset = (uint32_t)m_List->UniformStorage.size();
+
+	if (buffer)
+	{
+		m_List->UniformStorage.insert(m_List->UniformStorage.end(), buffer.Data, buffer.Data + buffer.Size);
+	}
+
+	return offset;
+}
+
+// The previous list may still be waiting on the render thread so a new one is started rather than cleared
+void RenderPacketBucket::Reset()
+{
+	m_List = Ref<RenderPacketList>::Create();
+	m_List->Packets.reserve(m_LastPacketCount);
+
+	m_ShaderIndices.clear();
+	m_MaterialIndices.clear();
+	m_VertexArrayIndices.clear();
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+#include "Lucid/Core/RadixSort.h"
+
+#include "Lucid/Renderer/Mesh.h"
+
+// 64-bit sort key, packets are drawn in ascending key order so state changes are grouped by pass, shader, material and vertex array before depth
+// | Pass (4) | Shader (12) | Material (16) | Vertex array (12) | Depth (20) |
+struct RenderPacketKey
+{
+	static constexpr uint32_t PassBits = 4;
+	static constexpr uint32_t ShaderBits = 12;
+	static constexpr uint32_t MaterialBits = 16;
+	static constexpr uint32_t VertexArrayBits = 12;
+	static constexpr uint32_t DepthBits = 20;
+
+	static constexpr uint32_t DepthShift = 0;
+	static constexpr uint32_t VertexArrayShift = DepthShift + DepthBits;
+	static constexpr uint32_t MaterialShift = VertexArrayShift + VertexArrayBits;
+	static constexpr uint32_t ShaderShift = MaterialShift + MaterialBits;
+	static constexpr uint32_t PassShift = ShaderShift + ShaderBits;
+
+	static constexpr uint64_t DepthMask = ((1ull << DepthBits) - 1) << DepthShift;
+
+	// Indices wider than their field wrap, this only affects how well packets are grouped and never which state a packet is drawn with
+	static uint64_t Encode(uint32_t pass, uint32_t shader, uint32_t material, uint32_t vertexArray, uint32_t depth = 0)
+	{
+		return ((uint64_t)(pass & ((1u << PassBits) - 1)) << PassShift) |
+			((uint64_t)(shader & ((1u << ShaderBits) - 1)) << ShaderShift) |
+			((uint64_t)(material & ((1u << MaterialBits) - 1)) << MaterialShift) |
+			((uint64_t)(vertexArray & ((1u << VertexArrayBits) - 1)) << VertexArrayShift) |
+			((uint64_t)(depth & ((1u << DepthBits) - 1)) << DepthShift);
+	}
+
+	// Quantises a normalised [0, 1] depth into the depth field
+	static uint32_t QuantiseDepth(float depth)
+	{
+		depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+
+		return (uint32_t)(depth * (float)((1u << DepthBits) - 1));
+	}
+};
+
+// Plain data describing a single submesh draw, state is referenced by index into the tables of the packet list it was recorded into
+struct DrawPacket
+{
+	uint64_t SortKey;
+
+	uint32_t MaterialIndex;
+	uint32_t VertexArrayIndex;
+
+	uint32_t IndexCount;
+	uint32_t BaseIndex;
+	uint32_t BaseVertex;
+
+	glm::mat4 Transform;
+};
+
+// Range of packets recorded for one mesh
+struct RenderPacketRange
+{
+	uint32_t First = 0;
+	uint32_t Count = 0;
+};
+
+// Packets dispatched and time spent sorting them on the render thread, counted per frame
+struct RenderPacketStats
+{
+	uint32_t Dispatches = 0;
+	uint32_t Packets = 0;
+
+	uint32_t DrawCalls = 0;
+	uint32_t InstancedDrawCalls = 0;
+	uint32_t Instances = 0;
+
+	// Milliseconds
+	float SortTime = 0.0f;
+};
+
+// Packets and the state they reference for a single flush, owned by the dispatch command until it has executed on the render thread
+class RenderPacketList : public RefCounted
+{
+
+public:
+
+	struct PacketShader
+	{
+		Ref<Shader> Shader;
+
+		int32_t TransformLocation = -1;
+		bool TransformResolved = false;
+
+		// Variant that reads transforms from the instance buffer, null when the shader has none
+		Ref<::Shader> InstancedShader;
+
+		int32_t InstanceOffsetLocation = -1;
+		bool InstanceOffsetResolved = false;
+	};
+
+	// Material values are copied when the material is first recorded so later writes from the main thread cannot race the render thread
+	struct PacketMaterial
+	{
+		uint32_t ShaderIndex;
+
+		uint32_t VSUniformOffset;
+		uint32_t VSUniformSize;
+		uint32_t FSUniformOffset;
+		uint32_t FSUniformSize;
+
+		uint32_t FirstTexture;
+		uint32_t TextureCount;
+
+		bool DepthTest;
+	};
+
+	struct PacketTexture
+	{
+		uint32_t Slot;
+
+		Ref<Texture2D> Texture;
+	};
+
+	void Dispatch();
+
+	static void EndFrame();
+
+	static RenderPacketStats GetStats();
+
+public:
+
+	std::vector<PacketShader> Shaders;
+	std::vector<PacketMaterial> Materials;
+	std::vector<Ref<VertexArray>> VertexArrays;
+	std::vector<PacketTexture> Textures;
+
+	std::vector<byte> UniformStorage;
+
+	std::vector<DrawPacket> Packets;
+
+	// Packets sharing material, vertex array and submesh are merged into instanced draws
+	bool Instancing = true;
+
+private:
+
+	// Consecutive packets in draw order drawn with one state setup, instanced groups are drawn with a single call
+	struct DrawGroup
+	{
+		uint32_t FirstEntry;
+		uint32_t Count;
+
+		uint32_t InstanceOffset;
+		bool Instanced;
+	};
+
+	void BuildDrawGroups();
+	void AddInstancedRun(uint32_t runStart, uint32_t runEnd);
+
+private:
+
+	std::vector<RadixSortEntry> m_SortEntries;
+	std::vector<RadixSortEntry> m_SortScratch;
+
+	// Packet indices in draw order
+	std::vector<uint32_t> m_DrawEntries;
+	std::vector<DrawGroup> m_Groups;
+
+	std::vector<glm::mat4> m_InstanceTransforms;
+
+	// Submesh to group lookup of the run being grouped
+	std::unordered_map<uint64_t, uint32_t> m_RunGroupIndices;
+	std::vector<uint32_t> m_RunGroups;
+	std::vector<uint32_t> m_RunGroupCounts;
+};
+
+// Records meshes as typed draw packets instead of render command closures, Flush submits one command that sorts and draws every packet
+// AddMesh registers state and must be called from one thread, SetTransform may be called from several threads for disjoint ranges
+class RenderPacketBucket
+{
+
+public:
+
+	RenderPacketBucket(uint32_t pass = 0);
+
+	void Begin(const glm::mat4& viewMatrix, float farClip);
+
+	// Submesh visibility holds one entry per submesh, submeshes marked 0 get no packet, null records every submesh
+	RenderPacketRange AddMesh(Ref<Mesh> mesh, Ref<MaterialInstance> overrideMaterial = nullptr, const uint8_t* submeshVisibility = nullptr);
+	void SetTransform(const RenderPacketRange& range, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshVisibility = nullptr);
+
+	void Flush();
+
+	void SetInstancing(bool enabled) { m_Instancing = enabled; }
+
+	uint32_t GetPacketCount() const { return (uint32_t)m_List->Packets.size(); }
+
+private:
+
+	uint32_t AddShader(const Ref<Shader>& shader);
+	uint32_t AddMaterial(Ref<MaterialInstance> material);
+	uint32_t AddVertexArray(const Ref<VertexArray>& vertexArray);
+
+	uint32_t CopyUniforms(const Memory& buffer);
+
+	void Reset();
+
+private:
+
+	uint32_t m_Pass;
+
+	glm::mat4 m_ViewMatrix = glm::mat4(1.0f);
+	float m_FarClip = 1.0f;
+
+	bool m_Instancing = true;
+
+	Ref<RenderPacketList> m_List;
+
+	std::unordered_map<const void*, uint32_t> m_ShaderIndices;
+	std::unordered_map<const void*, uint32_t> m_MaterialIndices;
+	std::unordered_map<const void*, uint32_t> m_VertexArrayIndices;
+
+	// Packet count of the previous flush, used to size the next list up front
+	uint32_t m_LastPacketCount = 0;
+};
\ No newline at end of file
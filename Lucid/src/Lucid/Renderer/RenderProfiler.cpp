@@ -0,0 +1,307 @@
+#include "ldpch.h"
+
+#include "RenderProfiler.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include <glad/glad.h>
+
+#include "Lucid/Renderer/Renderer.h"
+
+// Frames between writing a frame's timestamps and reading them back
+static constexpr uint32_t s_QueryLatency = 3;
+
+// A slot is reused once its read back has executed, which trails recording by the latency plus the queued frames
+static constexpr uint32_t s_FrameSlots = s_QueryLatency + Renderer::s_RenderCommandQueueCount;
+
+// Frames kept for the rolling averages and the CSV export
+static constexpr uint32_t s_HistoryFrames = 120;
+
+using ProfilerClock = std::chrono::high_resolution_clock;
+
+struct ProfilerScope
+{
+	std::string Name;
+	uint32_t Depth = 0;
+
+	// Main thread
+	ProfilerClock::time_point RecordBegin;
+	float RecordTime = 0.0f;
+
+	// Render thread
+	ProfilerClock::time_point ExecuteBegin;
+	ProfilerClock::time_point ExecuteEnd;
+};
+
+struct ProfilerFrame
+{
+	uint64_t Index = 0;
+
+	std::vector<ProfilerScope> Scopes;
+
+	// Begin and end timestamp query of every scope, created on the render thread
+	std::vector<RendererID> Queries;
+};
+
+struct ProfilerSample
+{
+	uint32_t Scope;
+
+	float GPUTime;
+	float RecordTime;
+	float ExecuteTime;
+};
+
+struct ResolvedFrame
+{
+	uint64_t Index = 0;
+
+	std::vector<std::string> Names;
+	std::vector<uint32_t> Depths;
+	std::vector<ProfilerSample> Samples;
+};
+
+struct RenderProfilerData
+{
+	ProfilerFrame Frames[s_FrameSlots];
+
+	uint64_t FrameIndex = 0;
+
+	// Indices of the open scopes of the current frame
+	std::vector<uint32_t> ScopeStack;
+
+	// Written by the render thread, read by the main thread
+	std::mutex HistoryMutex;
+	std::deque<ResolvedFrame> History;
+	uint32_t DroppedFrames = 0;
+};
+
+static RenderProfilerData s_Data;
+
+// Render thread, reads back the timestamps of a frame if the GPU has written all of them
+static void ResolveFrame(ProfilerFrame& frame)
+{
+	uint32_t scopeCount = (uint32_t)frame.Scopes.size();
+
+	if (scopeCount == 0)
+	{
+		return;
+	}
+
+	// Timestamps complete in order, the last one being available means every earlier one is too
+	GLint available = 0;
+	glGetQueryObjectiv(frame.Queries[scopeCount * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+	if (!available)
+	{
+		std::lock_guard<std::mutex> lock(s_Data.HistoryMutex);
+
+		s_Data.DroppedFrames++;
+
+		return;
+	}
+
+	ResolvedFrame resolved;
+	resolved.Index = frame.Index;
+
+	for (uint32_t i = 0; i < scopeCount; i++)
+	{
+		const ProfilerScope& scope = frame.Scopes[i];
+
+		GLuint64 begin = 0;
+		GLuint64 end = 0;
+
+		glGetQueryObjectui64v(frame.Queries[i * 2], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(frame.Queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+
+		ProfilerSample sample;
+		sample.Scope = i;
+		sample.GPUTime = (float)(end - begin) / 1000000.0f;
+		sample.RecordTime = scope.RecordTime;
+		sample.ExecuteTime = std::chrono::duration<float, std::milli>(scope.ExecuteEnd - scope.ExecuteBegin).count();
+
+		resolved.Names.push_back(scope.Name);
+		resolved.Depths.push_back(scope.Depth);
+		resolved.Samples.push_back(sample);
+	}
+
+	std::lock_guard<std::mutex> lock(s_Data.HistoryMutex);
+
+	s_Data.History.push_back(std::move(resolved));
+
+	if (s_Data.History.size() > s_HistoryFrames)
+	{
+		s_Data.History.pop_front();
+	}
+}
+
+void RenderProfiler::BeginFrame()
+{
+	LD_CORE_ASSERT(s_Data.ScopeStack.empty(), "Profiler scopes were left open");
+
+	s_Data.FrameIndex++;
+
+	// Read back the frame whose timestamps should have landed by now
+	if (s_Data.FrameIndex > s_QueryLatency)
+	{
+		ProfilerFrame* resolveFrame = &s_Data.Frames[(s_Data.FrameIndex - s_QueryLatency) % s_FrameSlots];
+
+		Renderer::Submit([resolveFrame]()
+		{
+			ResolveFrame(*resolveFrame);
+		});
+	}
+
+	ProfilerFrame& frame = s_Data.Frames[s_Data.FrameIndex % s_FrameSlots];
+	frame.Index = s_Data.FrameIndex;
+	frame.Scopes.clear();
+}
+
+void RenderProfiler::BeginScope(const std::string& name)
+{
+	ProfilerFrame* frame = &s_Data.Frames[s_Data.FrameIndex % s_FrameSlots];
+
+	uint32_t index = (uint32_t)frame->Scopes.size();
+
+	ProfilerScope& scope = frame->Scopes.emplace_back();
+	scope.Name = name;
+	scope.Depth = (uint32_t)s_Data.ScopeStack.size();
+	scope.RecordBegin = ProfilerClock::now();
+
+	s_Data.ScopeStack.push_back(index);
+
+	Renderer::Submit([frame, index]()
+	{
+		if (frame->Queries.size() < (index + 1) * 2)
+		{
+			size_t first = frame->Queries.size();
+
+			frame->Queries.resize((index + 1) * 2);
+
+			glCreateQueries(GL_TIMESTAMP, (GLsizei)(frame->Queries.size() - first), &frame->Queries[first]);
+		}
+
+		frame->Scopes[index].ExecuteBegin = ProfilerClock::now();
+
+		glQueryCounter(frame->Queries[index * 2], GL_TIMESTAMP);
+	});
+}
+
+void RenderProfiler::EndScope()
+{
+	LD_CORE_ASSERT(!s_Data.ScopeStack.empty(), "No open profiler scope");
+
+	ProfilerFrame* frame = &s_Data.Frames[s_Data.FrameIndex % s_FrameSlots];
+
+	uint32_t index = s_Data.ScopeStack.back();
+	s_Data.ScopeStack.pop_back();
+
+	ProfilerScope& scope = frame->Scopes[index];
+	scope.RecordTime = std::chrono::duration<float, std::milli>(ProfilerClock::now() - scope.RecordBegin).count();
+
+	Renderer::Submit([frame, index]()
+	{
+		glQueryCounter(frame->Queries[index * 2 + 1], GL_TIMESTAMP);
+
+		frame->Scopes[index].ExecuteEnd = ProfilerClock::now();
+	});
+}
+
+std::vector<RenderProfilerResult> RenderProfiler::GetResults()
+{
+	std::lock_guard<std::mutex> lock(s_Data.HistoryMutex);
+
+	std::vector<RenderProfilerResult> results;
+
+	if (s_Data.History.empty())
+	{
+		return results;
+	}
+
+	// Scopes are matched by name and depth against the latest frame, scopes that come and go are averaged over the frames they ran in
+	const ResolvedFrame& latest = s_Data.History.back();
+
+	std::unordered_map<std::string, uint32_t> resultIndices;
+	std::vector<uint32_t> sampleCounts;
+
+	for (size_t i = 0; i < latest.Names.size(); i++)
+	{
+		RenderProfilerResult result;
+		result.Name = latest.Names[i];
+		result.Depth = latest.Depths[i];
+
+		resultIndices[result.Name + "/" + std::to_string(result.Depth)] = (uint32_t)results.size();
+
+		results.push_back(result);
+		sampleCounts.push_back(0);
+	}
+
+	for (const ResolvedFrame& frame : s_Data.History)
+	{
+		for (const ProfilerSample& sample : frame.Samples)
+		{
+			auto it = resultIndices.find(frame.Names[sample.Scope] + "/" + std::to_string(frame.Depths[sample.Scope]));
+
+			if (it == resultIndices.end())
+			{
+				continue;
+			}
+
+			RenderProfilerResult& result = results[it->second];
+			result.GPUTime += sample.GPUTime;
+			result.RecordTime += sample.RecordTime;
+			result.ExecuteTime += sample.ExecuteTime;
+
+			sampleCounts[it->second]++;
+		}
+	}
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		float count = (float)std::max(sampleCounts[i], 1u);
+
+		results[i].GPUTime /= count;
+		results[i].RecordTime /= count;
+		results[i].ExecuteTime /= count;
+	}
+
+	return results;
+}
+
+uint32_t RenderProfiler::GetDroppedFrames()
+{
+	std::lock_guard<std::mutex> lock(s_Data.HistoryMutex);
+
+	return s_Data.DroppedFrames;
+}
+
+bool RenderProfiler::ExportCSV(const std::string& filepath)
+{
+	std::ofstream stream(filepath);
+
+	if (!stream)
+	{
+		LD_CORE_ERROR("Could not open {0} to export render profile", filepath);
+
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(s_Data.HistoryMutex);
+
+	stream << "Frame,Scope,Depth,GPU (ms),Record (ms),Execute (ms)\n";
+
+	for (const ResolvedFrame& frame : s_Data.History)
+	{
+		for (const ProfilerSample& sample : frame.Samples)
+		{
+			stream << frame.Index << ",\"" << frame.Names[sample.Scope] << "\"," << frame.Depths[sample.Scope] << ","
+				<< sample.GPUTime << "," << sample.RecordTime << "," << sample.ExecuteTime << "\n";
+		}
+	}
+
+	LD_CORE_INFO("Exported {0} frames of render profile to {1}", s_Data.History.size(), filepath);
+
+	return true;
+}
\ No newline at end of file
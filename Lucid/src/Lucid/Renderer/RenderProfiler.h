@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Lucid/Core/Base.h"
+
+// Timings of one profiler scope, milliseconds
+struct RenderProfilerResult
+{
+	std::string Name;
+
+	// Nesting level of the scope, zero for top level scopes
+	uint32_t Depth = 0;
+
+	// Between the GL timestamps written at the start and end of the scope
+	float GPUTime = 0.0f;
+
+	// Spent on the main thread recording the scope's commands
+	float RecordTime = 0.0f;
+
+	// Spent on the render thread executing the scope's commands
+	float ExecuteTime = 0.0f;
+};
+
+// Scoped GPU and CPU timing of render passes
+// GPU time comes from timestamp queries that are read back a few frames later and only once available, so the renderer never waits on them
+// Scopes must be opened and closed on the main thread between calls to BeginFrame
+class RenderProfiler
+{
+
+public:
+
+	static void BeginFrame();
+
+	static void BeginScope(const std::string& name);
+	static void EndScope();
+
+	// Averages over the frames in the history, in the scope order of the most recent frame
+	static std::vector<RenderProfilerResult> GetResults();
+
+	// Frames whose queries were not available in time and were left out of the history
+	static uint32_t GetDroppedFrames();
+
+	// Writes every frame in the history as one row per scope
+	static bool ExportCSV(const std::string& filepath);
+};
+
+// Opens a profiler scope for its lifetime
+class RenderProfilerScope
+{
+
+public:
+
+	RenderProfilerScope(const std::string& name) { RenderProfiler::BeginScope(name); }
+	~RenderProfilerScope() { RenderProfiler::EndScope(); }
+};
\ No newline at end of file
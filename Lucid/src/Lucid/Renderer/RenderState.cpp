@@ -0,0 +1,263 @@
+#include "ldpch.h"
+
+#include "RenderState.h"
+
+#include <mutex>
+
+#include <glad/glad.h>
+
+// Texture units above this are passed straight through to GL
+static constexpr uint32_t s_MaxCachedTextureUnits = 32;
+
+// Cached value that never matches a real GL value, forces the next change through
+static constexpr uint32_t s_UnknownState = 0xFFFFFFFF;
+
+// Values currently bound in GL as far as the cache knows
+struct RenderStateCache
+{
+	uint32_t Program = s_UnknownState;
+	uint32_t VertexArray = s_UnknownState;
+	uint32_t TextureUnits[s_MaxCachedTextureUnits];
+
+	uint32_t DepthTest = s_UnknownState;
+
+	uint32_t Blend = s_UnknownState;
+	uint32_t BlendEquation = s_UnknownState;
+	uint32_t BlendSource = s_UnknownState;
+	uint32_t BlendDestination = s_UnknownState;
+
+	uint32_t DrawFramebuffer = s_UnknownState;
+	uint32_t ReadFramebuffer = s_UnknownState;
+
+	RenderStateCache()
+	{
+		for (uint32_t i = 0; i < s_MaxCachedTextureUnits; i++)
+		{
+			TextureUnits[i] = s_UnknownState;
+		}
+	}
+};
+
+struct RenderStateData
+{
+	RenderStateCache Cache;
+
+	// Counters of the frame being executed, only touched by the render thread
+	RenderStateStats FrameStats;
+
+	// Counters of the last completed frame, read from the main thread
+	RenderStateStats Stats;
+	std::mutex StatsMutex;
+};
+
+static RenderStateData s_Data;
+
+// Updates a cached value, returns false when the value already matched and the change can be skipped
+static bool SetState(uint32_t& cached, uint32_t value, RenderStateType type)
+{
+	if (cached == value)
+	{
+		s_Data.FrameStats.Skipped[(uint32_t)type]++;
+
+		return false;
+	}
+
+	cached = value;
+
+	s_Data.FrameStats.Issued[(uint32_t)type]++;
+
+	return true;
+}
+
+uint32_t RenderStateStats::GetTotalIssued() const
+{
+	uint32_t total = 0;
+
+	for (uint32_t i = 0; i < (uint32_t)RenderStateType::Count; i++)
+	{
+		total += Issued[i];
+	}
+
+	return total;
+}
+
+uint32_t RenderStateStats::GetTotalSkipped() const
+{
+	uint32_t total = 0;
+
+	for (uint32_t i = 0; i < (uint32_t)RenderStateType::Count; i++)
+	{
+		total += Skipped[i];
+	}
+
+	return total;
+}
+
+const char* RenderStateStats::GetTypeName(RenderStateType type)
+{
+	switch (type)
+	{
+		case RenderStateType::Program:		return "Program";
+		case RenderStateType::VertexArray:	return "Vertex Array";
+		case RenderStateType::Texture:		return "Texture";
+		case RenderStateType::DepthTest:	return "Depth Test";
+		case RenderStateType::Blend:		return "Blend";
+		case RenderStateType::Framebuffer:	return "Framebuffer";
+	}
+
+	return "Unknown";
+}
+
+void RenderState::UseProgram(RendererID program)
+{
+	if (SetState(s_Data.Cache.Program, program, RenderStateType::Program))
+	{
+		glUseProgram(program);
+	}
+}
+
+void RenderState::BindVertexArray(RendererID vertexArray)
+{
+	if (SetState(s_Data.Cache.VertexArray, vertexArray, RenderStateType::VertexArray))
+	{
+		glBindVertexArray(vertexArray);
+	}
+}
+
+void RenderState::BindTextureUnit(uint32_t unit, RendererID texture)
+{
+	if (unit >= s_MaxCachedTextureUnits)
+	{
+		s_Data.FrameStats.Issued[(uint32_t)RenderStateType::Texture]++;
+
+		glBindTextureUnit(unit, texture);
+
+		return;
+	}
+
+	if (SetState(s_Data.Cache.TextureUnits[unit], texture, RenderStateType::Texture))
+	{
+		glBindTextureUnit(unit, texture);
+	}
+}
+
+void RenderState::SetDepthTest(bool enabled)
+{
+	if (SetState(s_Data.Cache.DepthTest, enabled, RenderStateType::DepthTest))
+	{
+		if (enabled)
+		{
+			glEnable(GL_DEPTH_TEST);
+		}
+		else
+		{
+			glDisable(GL_DEPTH_TEST);
+		}
+	}
+}
+
+void RenderState::SetBlend(bool enabled)
+{
+	if (SetState(s_Data.Cache.Blend, enabled, RenderStateType::Blend))
+	{
+		if (enabled)
+		{
+			glEnable(GL_BLEND);
+		}
+		else
+		{
+			glDisable(GL_BLEND);
+		}
+	}
+}
+
+void RenderState::SetBlendEquation(uint32_t mode)
+{
+	if (SetState(s_Data.Cache.BlendEquation, mode, RenderStateType::Blend))
+	{
+		glBlendEquation(mode);
+	}
+}
+
+void RenderState::SetBlendFunc(uint32_t source, uint32_t destination)
+{
+	if (s_Data.Cache.BlendSource == source && s_Data.Cache.BlendDestination == destination)
+	{
+		s_Data.FrameStats.Skipped[(uint32_t)RenderStateType::Blend]++;
+
+		return;
+	}
+
+	s_Data.Cache.BlendSource = source;
+	s_Data.Cache.BlendDestination = destination;
+
+	s_Data.FrameStats.Issued[(uint32_t)RenderStateType::Blend]++;
+
+	glBlendFunc(source, destination);
+}
+
+void RenderState::SetBlendFunc(uint32_t buffer, uint32_t source, uint32_t destination)
+{
+	s_Data.Cache.BlendSource = s_UnknownState;
+	s_Data.Cache.BlendDestination = s_UnknownState;
+
+	s_Data.FrameStats.Issued[(uint32_t)RenderStateType::Blend]++;
+
+	glBlendFunci(buffer, source, destination);
+}
+
+// Binds a framebuffer to both the draw and read targets
+void RenderState::BindFramebuffer(RendererID framebuffer)
+{
+	if (s_Data.Cache.DrawFramebuffer == framebuffer && s_Data.Cache.ReadFramebuffer == framebuffer)
+	{
+		s_Data.FrameStats.Skipped[(uint32_t)RenderStateType::Framebuffer]++;
+
+		return;
+	}
+
+	s_Data.Cache.DrawFramebuffer = framebuffer;
+	s_Data.Cache.ReadFramebuffer = framebuffer;
+
+	s_Data.FrameStats.Issued[(uint32_t)RenderStateType::Framebuffer]++;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void RenderState::BindDrawFramebuffer(RendererID framebuffer)
+{
+	if (SetState(s_Data.Cache.DrawFramebuffer, framebuffer, RenderStateType::Framebuffer))
+	{
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	}
+}
+
+void RenderState::BindReadFramebuffer(RendererID framebuffer)
+{
+	if (SetState(s_Data.Cache.ReadFramebuffer, framebuffer, RenderStateType::Framebuffer))
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	}
+}
+
+// Forgets every cached value, called after GL objects are created or deleted and after third party code has rendered
+void RenderState::Invalidate()
+{
+	s_Data.Cache = RenderStateCache();
+}
+
+// Publishes the counters of the frame that just finished executing
+void RenderState::EndFrame()
+{
+	std::lock_guard<std::mutex> lock(s_Data.StatsMutex);
+
+	s_Data.Stats = s_Data.FrameStats;
+	s_Data.FrameStats = {};
+}
+
+RenderStateStats RenderState::GetStats()
+{
+	std::lock_guard<std::mutex> lock(s_Data.StatsMutex);
+
+	return s_Data.Stats;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Lucid/Core/Base.h"
+
+// GL state tracked by the render state cache
+enum class RenderStateType
+{
+	Program = 0,
+	VertexArray,
+	Texture,
+	DepthTest,
+	Blend,
+	Framebuffer,
+	Count
+};
+
+// State changes issued to GL and state changes skipped because the cached value already matched, counted per frame
+struct RenderStateStats
+{
+	uint32_t Issued[(uint32_t)RenderStateType::Count] = {};
+	uint32_t Skipped[(uint32_t)RenderStateType::Count] = {};
+
+	uint32_t GetTotalIssued() const;
+	uint32_t GetTotalSkipped() const;
+
+	static const char* GetTypeName(RenderStateType type);
+};
+
+// Render thread cache of bound GL state, changes that match the cached value are filtered out before reaching the driver
+// Every change to tracked state must go through here, anything that changes it behind the cache's back must call Invalidate
+class RenderState
+{
+
+public:
+
+	static void UseProgram(RendererID program);
+	static void BindVertexArray(RendererID vertexArray);
+	static void BindTextureUnit(uint32_t unit, RendererID texture);
+
+	static void SetDepthTest(bool enabled);
+
+	static void SetBlend(bool enabled);
+	static void SetBlendEquation(uint32_t mode);
+	static void SetBlendFunc(uint32_t source, uint32_t destination);
+
+	// Blend function of a single draw buffer, leaves the cached function for all draw buffers unknown
+	static void SetBlendFunc(uint32_t buffer, uint32_t source, uint32_t destination);
+
+	static void BindFramebuffer(RendererID framebuffer);
+	static void BindDrawFramebuffer(RendererID framebuffer);
+	static void BindReadFramebuffer(RendererID framebuffer);
+
+	static void Invalidate();
+
+	static void EndFrame();
+
+	static RenderStateStats GetStats();
+};
\ No newline at end of file
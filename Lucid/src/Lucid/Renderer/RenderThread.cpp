@@ -0,0 +1,164 @@
+#include "ldpch.h"
+
+#include <glfw/glfw3.h>
+
+#include "RenderThread.h"
+
+#include "Lucid/Renderer/Renderer.h"
+
+// Set on the render thread once it starts, used to route commands submitted during execution back into the executing queue
+static thread_local bool s_IsRenderThread = false;
+
+RenderThread::RenderThread(ThreadingPolicy policy)
+	: m_ThreadingPolicy(policy)
+{
+}
+
+RenderThread::~RenderThread()
+{
+	if (m_Running)
+	{
+		Terminate();
+	}
+}
+
+// Starts the render thread, the window's context must not be current on the calling thread as ownership moves to the render thread
+void RenderThread::Run(GLFWwindow* window)
+{
+	if (m_ThreadingPolicy != ThreadingPolicy::MultiThreaded)
+	{
+		return;
+	}
+
+	m_Window = window;
+	m_Running = true;
+
+	m_Thread = std::thread(RenderThreadFunc, this);
+}
+
+// Executes any outstanding frame, stops the render thread and waits for it to release the context
+void RenderThread::Terminate()
+{
+	if (m_ThreadingPolicy != ThreadingPolicy::MultiThreaded || !m_Running)
+	{
+		return;
+	}
+
+	// The last frame recorded is only handed over once the render thread is done with the one before it
+	BlockUntilRenderComplete();
+
+	Pump();
+
+	m_Running = false;
+
+	Kick();
+
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+}
+
+// Blocks the calling thread until the render thread reaches the requested state
+void RenderThread::Wait(State waitForState)
+{
+	std::unique_lock<std::mutex> lock(m_StateMutex);
+
+	m_StateCondition.wait(lock, [this, waitForState]() { return m_State == waitForState; });
+}
+
+// Blocks the calling thread until the render thread reaches the requested state, then moves it to a new state
+void RenderThread::WaitAndSet(State waitForState, State setToState)
+{
+	std::unique_lock<std::mutex> lock(m_StateMutex);
+
+	m_StateCondition.wait(lock, [this, waitForState]() { return m_State == waitForState; });
+
+	m_State = setToState;
+
+	m_StateCondition.notify_all();
+}
+
+void RenderThread::Set(State setToState)
+{
+	std::lock_guard<std::mutex> lock(m_StateMutex);
+
+	m_State = setToState;
+
+	m_StateCondition.notify_all();
+}
+
+// Swaps the submission and render command queues, the queue recorded this frame becomes the queue the render thread executes next
+void RenderThread::NextFrame()
+{
+	Renderer::SwapQueues();
+}
+
+// Frame fence, returns once the render thread has finished executing the previous frame
+void RenderThread::BlockUntilRenderComplete()
+{
+	if (m_ThreadingPolicy != ThreadingPolicy::MultiThreaded)
+	{
+		return;
+	}
+
+	Wait(State::Idle);
+}
+
+// Signals the render thread to start executing the render queue
+void RenderThread::Kick()
+{
+	if (m_ThreadingPolicy == ThreadingPolicy::MultiThreaded)
+	{
+		Set(State::Kick);
+	}
+	else
+	{
+		Renderer::WaitAndRender();
+	}
+}
+
+// Executes everything that has been recorded so far and waits for it to complete
+void RenderThread::Pump()
+{
+	NextFrame();
+	Kick();
+	BlockUntilRenderComplete();
+}
+
+bool RenderThread::IsCurrentThreadRenderThread()
+{
+	return s_IsRenderThread;
+}
+
+void RenderThread::RenderThreadFunc(RenderThread* renderThread)
+{
+	s_IsRenderThread = true;
+
+	// The render thread owns the OpenGL context for its whole lifetime, headless applications have no context to own
+	if (renderThread->m_Window)
+	{
+		glfwMakeContextCurrent(renderThread->m_Window);
+	}
+
+	while (true)
+	{
+		renderThread->WaitAndSet(State::Kick, State::Busy);
+
+		if (!renderThread->m_Running)
+		{
+			renderThread->Set(State::Idle);
+
+			break;
+		}
+
+		Renderer::WaitAndRender();
+
+		renderThread->Set(State::Idle);
+	}
+
+	if (renderThread->m_Window)
+	{
+		glfwMakeContextCurrent(nullptr);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+struct GLFWwindow;
+
+// Defines where render commands are executed, single-threaded executes them on the main thread once per frame
+enum class ThreadingPolicy
+{
+	None = 0,
+	SingleThreaded,
+	MultiThreaded
+};
+
+// Dedicated render thread that owns the OpenGL context, the main thread records frame N + 1 while the render thread executes frame N
+class RenderThread
+{
+
+public:
+
+	enum class State
+	{
+		Idle = 0,
+		Busy,
+		Kick
+	};
+
+	RenderThread(ThreadingPolicy policy);
+	~RenderThread();
+
+	void Run(GLFWwindow* window);
+	void Terminate();
+
+	void Wait(State waitForState);
+	void WaitAndSet(State waitForState, State setToState);
+	void Set(State setToState);
+
+	void NextFrame();
+	void BlockUntilRenderComplete();
+	void Kick();
+	void Pump();
+
+	bool IsRunning() const { return m_Running; }
+
+	ThreadingPolicy GetThreadingPolicy() const { return m_ThreadingPolicy; }
+
+	static bool IsCurrentThreadRenderThread();
+
+private:
+
+	static void RenderThreadFunc(RenderThread* renderThread);
+
+private:
+
+	ThreadingPolicy m_ThreadingPolicy;
+
+	GLFWwindow* m_Window = nullptr;
+
+	std::thread m_Thread;
+
+	std::mutex m_StateMutex;
+	std::condition_variable m_StateCondition;
+
+	State m_State = State::Idle;
+
+	std::atomic<bool> m_Running{ false };
+};
\ No newline at end of file
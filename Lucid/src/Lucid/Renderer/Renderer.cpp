@@ -6,17 +6,31 @@
 
 #include "Lucid/Renderer/SceneRenderer.h"
 #include "Lucid/Renderer/Renderer2D.h"
+#include "Lucid/Renderer/RenderPacket.h"
+#include "Lucid/Renderer/RenderState.h"
 
 struct RendererData
 {
 	Ref<RenderPass> m_ActiveRenderPass;
-	RenderCommandQueue m_CommandQueue;
+	RenderCommandQueue m_CommandQueues[Renderer::s_RenderCommandQueueCount];
 	Ref<ShaderLibrary> m_ShaderLibrary;
 	Ref<VertexArray> m_FullscreenQuadVertexArray;
+
+	ThreadingPolicy m_ThreadingPolicy = ThreadingPolicy::SingleThreaded;
+	RendererAPIType m_API = RendererAPIType::OpenGL;
+
+	// Index of the command queue the main thread is currently recording into
+	std::atomic<uint32_t> m_RenderCommandQueueSubmissionIndex{ 0 };
 };
 
 static RendererData s_Data;
 
+// Queue currently being executed on this thread, commands submitted while executing (e.g. from ImGui or resource destructors) are appended to it
+static thread_local RenderCommandQueue* s_ExecutingCommandQueue = nullptr;
+
+// Command list the calling thread is recording into, takes priority over the frame queue
+static thread_local CommandList* s_RecordingCommandList = nullptr;
+
 static void GLAPIENTRY OpenGLErrorLog(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
 {
 	switch (severity)
@@ -62,15 +76,15 @@ static void InitOpenGL()
 	// Generate and bind vertex array
 	unsigned int vao;
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	RenderState::BindVertexArray(vao);
 
 	// Enable depth-testing by default and set winding-order of indices
-	glEnable(GL_DEPTH_TEST);
+	RenderState::SetDepthTest(true);
 	glFrontFace(GL_CCW);
 
 	// Enable blending and set blending operate (over blending)
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RenderState::SetBlend(true);
+	RenderState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Set and log renderer capabilities
 	auto& caps = RendererCapabilities::GetCapabilities();
@@ -88,6 +102,17 @@ static void InitOpenGL()
 
 	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &caps.MaxTextureUnits);
 
+	int extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+	for (int i = 0; i < extensionCount; i++)
+	{
+		if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_EXT_texture_compression_s3tc") == 0)
+		{
+			caps.TextureCompressionS3TC = true;
+		}
+	}
+
 	GLenum error = glGetError();
 
 	// Ensure OpenGL successfully initialized
@@ -109,6 +134,7 @@ void Renderer::Init()
 	Renderer::Submit([]() { InitOpenGL(); });
 
 	Renderer::GetShaderLibrary()->Load("assets/shaders/Buffer.glsl");
+	Renderer::GetShaderLibrary()->Load("assets/shaders/BufferInstanced.glsl");
 	Renderer::GetShaderLibrary()->Load("assets/shaders/Lighting.glsl");
 
 	SceneRenderer::Init();
@@ -190,7 +216,7 @@ void Renderer::DrawIndexed(uint32_t count, PrimitiveType type, bool depthTest)
 	{
 		if (!depthTest)
 		{
-			glDisable(GL_DEPTH_TEST);
+			RenderState::SetDepthTest(false);
 		}
 
 		GLenum glPrimitiveType = 0;
@@ -215,7 +241,7 @@ void Renderer::DrawIndexed(uint32_t count, PrimitiveType type, bool depthTest)
 
 		if (!depthTest)
 		{
-			glEnable(GL_DEPTH_TEST);
+			RenderState::SetDepthTest(true);
 		}
 	});
 }
@@ -228,13 +254,99 @@ Ref<ShaderLibrary> Renderer::GetShaderLibrary()
 // Executes all render commands (in sequential order) that are waiting in the render command queue
 void Renderer::ExecuteRenderCommands()
 {
-	s_Data.m_CommandQueue.Execute();
+	RenderCommandQueue& queue = s_Data.m_CommandQueues[GetRenderQueueSubmissionIndex()];
+
+	s_ExecutingCommandQueue = &queue;
+	queue.Execute();
+	s_ExecutingCommandQueue = nullptr;
+
+	RenderState::EndFrame();
+	RenderPacketList::EndFrame();
+}
+
+void Renderer::SetThreadingPolicy(ThreadingPolicy policy)
+{
+	s_Data.m_ThreadingPolicy = policy;
+}
+
+ThreadingPolicy Renderer::GetThreadingPolicy()
+{
+	return s_Data.m_ThreadingPolicy;
+}
+
+void Renderer::SetAPI(RendererAPIType api)
+{
+	s_Data.m_API = api;
+}
+
+RendererAPIType Renderer::GetAPI()
+{
+	return s_Data.m_API;
+}
+
+// Moves recording on to the next command queue, must only be called while the render thread is idle
+void Renderer::SwapQueues()
+{
+	s_Data.m_RenderCommandQueueSubmissionIndex = (s_Data.m_RenderCommandQueueSubmissionIndex + 1) % s_RenderCommandQueueCount;
+}
+
+// Executes the most recently recorded command queue, called from the render thread once it has been kicked
+void Renderer::WaitAndRender()
+{
+	RenderCommandQueue& queue = s_Data.m_CommandQueues[GetRenderQueueIndex()];
+
+	s_ExecutingCommandQueue = &queue;
+	queue.Execute();
+	s_ExecutingCommandQueue = nullptr;
+
+	RenderState::EndFrame();
+	RenderPacketList::EndFrame();
 }
 
-// Retrieves the current state of the render command queue
+uint32_t Renderer::GetRenderQueueIndex()
+{
+	return (s_Data.m_RenderCommandQueueSubmissionIndex + s_RenderCommandQueueCount - 1) % s_RenderCommandQueueCount;
+}
+
+uint32_t Renderer::GetRenderQueueSubmissionIndex()
+{
+	return s_Data.m_RenderCommandQueueSubmissionIndex;
+}
+
+// Memory usage of the submission queue as of its last execution, safe to read from the main thread
+const RenderCommandQueueStats& Renderer::GetRenderCommandQueueStats()
+{
+	return s_Data.m_CommandQueues[GetRenderQueueSubmissionIndex()].GetStats();
+}
+
+void Renderer::SetRecordingCommandList(CommandList* commandList)
+{
+	s_RecordingCommandList = commandList;
+}
+
+// Stitches a recorded command list into the frame queue, must be called from the main thread once the list has finished recording
+void Renderer::SubmitCommandList(Ref<CommandList> commandList)
+{
+	LD_CORE_ASSERT(!commandList->IsRecording(), "Command list is still recording!");
+	LD_CORE_ASSERT(!s_RecordingCommandList, "Cannot submit a command list while recording into another!");
+
+	GetRenderCommandQueue().Append(commandList->GetCommandQueue());
+}
+
+// Retrieves the command queue that submitted commands are recorded into
 RenderCommandQueue& Renderer::GetRenderCommandQueue()
 {
-	return s_Data.m_CommandQueue;
+	if (s_RecordingCommandList)
+	{
+		return s_RecordingCommandList->GetCommandQueue();
+	}
+
+	if (s_ExecutingCommandQueue)
+	{
+		return *s_ExecutingCommandQueue;
+	}
+
+	return s_Data.m_CommandQueues[GetRenderQueueSubmissionIndex()];
 }
 
 void Renderer::BeginRenderPass(Ref<RenderPass> renderPass, bool clear)
@@ -295,14 +407,22 @@ void Renderer::SubmitFullscreenQuad(Ref<MaterialInstance> material)
 	Renderer::DrawIndexed(6, PrimitiveType::Triangles, depthTest);
 }
 
-void Renderer::SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<MaterialInstance> overrideMaterial)
+// Submits every submesh of a mesh, submeshes marked 0 in the optional visibility array are skipped
+void Renderer::SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<MaterialInstance> overrideMaterial, const uint8_t* submeshVisibility)
 {
 	mesh->m_VertexArray->Bind();
 
 	const auto& materials = mesh->GetMaterials();
 
-	for (Submesh& submesh : mesh->m_Submeshes)
+	for (uint32_t i = 0; i < (uint32_t)mesh->m_Submeshes.size(); i++)
 	{
+		if (submeshVisibility && !submeshVisibility[i])
+		{
+			continue;
+		}
+
+		Submesh& submesh = mesh->m_Submeshes[i];
+
 		// Material
 		auto material = overrideMaterial ? overrideMaterial : materials[submesh.MaterialIndex];
 		auto shader = material->GetShader();
@@ -312,14 +432,7 @@ void Renderer::SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<Materi
 
 		Renderer::Submit([submesh, material]()
 		{
-			if (material->GetFlag(MaterialFlag::DepthTest))
-			{
-				glEnable(GL_DEPTH_TEST);
-			}
-			else
-			{
-				glDisable(GL_DEPTH_TEST);
-			}
+			RenderState::SetDepthTest(material->GetFlag(MaterialFlag::DepthTest));
 
 			glDrawElementsBaseVertex(GL_TRIANGLES, submesh.IndexCount, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * submesh.BaseIndex), submesh.BaseVertex);
 		});
@@ -3,11 +3,22 @@
 #include <glm/glm.hpp>
 
 #include "Lucid/Renderer/RenderCommandQueue.h"
+#include "Lucid/Renderer/RenderThread.h"
+#include "Lucid/Renderer/CommandList.h"
 #include "Lucid/Renderer/RenderPass.h"
 #include "Lucid/Renderer/ShaderLibrary.h"
 #include "Lucid/Renderer/Mesh.h"
 
 #include "Lucid/Core/Math/AABB.h"
+#include "Lucid/Core/Memory.h"
+
+// Backend render commands are issued to, the null backend runs without a GPU or window
+enum class RendererAPIType
+{
+	None = 0,
+	OpenGL,
+	Null
+};
 
 enum class PrimitiveType
 {
@@ -26,6 +37,9 @@ struct RendererCapabilities
 	float MaxAnisotropy = 0.0f;
 	int MaxTextureUnits = 0;
 
+	// BC1 and BC3 come from EXT_texture_compression_s3tc, which no GL version makes core
+	bool TextureCompressionS3TC = false;
+
 	static RendererCapabilities& GetCapabilities()
 	{
 		static RendererCapabilities capabilities;
@@ -65,22 +79,72 @@ public:
 			pFunc->~FuncT();
 		};
 
-		auto storageBuffer = GetRenderCommandQueue().Allocate(renderCmd, sizeof(func));
+		auto storageBuffer = GetRenderCommandQueue().Allocate(renderCmd, sizeof(func), alignof(FuncT));
 		new (storageBuffer) FuncT(std::forward<FuncT>(func));
 	}
 
+	// Copies data into the command's payload at submit time and hands the copy to the function when the command executes
+	// For commands reading memory the main thread goes on writing to, with a render thread it records the next frame while this one executes
+	template<typename FuncT>
+	static void SubmitWithData(const void* data, uint32_t size, FuncT&& func)
+	{
+		struct Command
+		{
+			std::decay_t<FuncT> Func;
+			uint32_t Size;
+		};
+
+		auto renderCmd = [](void* ptr)
+		{
+			auto command = (Command*)ptr;
+			command->Func(Memory((byte*)ptr + sizeof(Command), command->Size));
+
+			command->~Command();
+		};
+
+		auto storageBuffer = (byte*)GetRenderCommandQueue().Allocate(renderCmd, sizeof(Command) + size, alignof(Command));
+		new (storageBuffer) Command{ std::forward<FuncT>(func), size };
+
+		if (size)
+		{
+			memcpy(storageBuffer + sizeof(Command), data, size);
+		}
+	}
+
 	static void ExecuteRenderCommands();
 
+	static void SetThreadingPolicy(ThreadingPolicy policy);
+	static ThreadingPolicy GetThreadingPolicy();
+
+	static void SetAPI(RendererAPIType api);
+	static RendererAPIType GetAPI();
+
+	static void SwapQueues();
+	static void WaitAndRender();
+
+	static uint32_t GetRenderQueueIndex();
+	static uint32_t GetRenderQueueSubmissionIndex();
+
+	static const RenderCommandQueueStats& GetRenderCommandQueueStats();
+
+	static void SetRecordingCommandList(CommandList* commandList);
+	static void SubmitCommandList(Ref<CommandList> commandList);
+
 	static void BeginRenderPass(Ref<RenderPass> renderPass, bool clear = true);
 	static void EndRenderPass();
 
 	static void SubmitQuad(Ref<MaterialInstance> material, const glm::mat4& transform = glm::mat4(1.0f));
 	static void SubmitFullscreenQuad(Ref<MaterialInstance> material);
-	static void SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<MaterialInstance> overrideMaterial = nullptr);
+	static void SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<MaterialInstance> overrideMaterial = nullptr, const uint8_t* submeshVisibility = nullptr);
 
 	static void DrawAABB(const AABB& aabb, const glm::mat4& transform, const glm::vec4& colour = glm::vec4(1.0f));
 	static void DrawAABB(Ref<Mesh> mesh, const glm::mat4& transform, const glm::vec4& colour = glm::vec4(1.0f));
 
+public:
+
+	// Number of command queues, the main thread records into one while the render thread executes another
+	static constexpr uint32_t s_RenderCommandQueueCount = 2;
+
 private:
 
 	static RenderCommandQueue& GetRenderCommandQueue();
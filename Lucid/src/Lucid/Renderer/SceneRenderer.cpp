@@ -2,15 +2,32 @@
 
 #include "SceneRenderer.h"
 
+#include <atomic>
+#include <chrono>
+
 #include <glad/glad.h>
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "Lucid/Renderer/CullingBounds.h"
+#include "Lucid/Renderer/GBufferPacking.h"
+#include "Lucid/Renderer/LightClusters.h"
 #include "Lucid/Renderer/Renderer.h"
 #include "Lucid/Renderer/Renderer2D.h"
+#include "Lucid/Renderer/RenderGraph.h"
+#include "Lucid/Renderer/RenderPacket.h"
+#include "Lucid/Renderer/RenderProfiler.h"
+#include "Lucid/Renderer/RenderState.h"
+#include "Lucid/Renderer/StorageBuffer.h"
 
 #include "Lucid/ImGui/EditorLayer.h"
 
+#include "Lucid/Core/RadixSort.h"
+#include "Lucid/Core/ThreadPool.h"
+
+// Frames of peel layer queries in flight, results are read back once available and at the earliest a frame after they were issued
+static constexpr uint32_t s_PeelQuerySlots = 3;
+
 struct SceneRendererData
 {
 	const Scene* ActiveScene = nullptr;
@@ -20,30 +37,95 @@ struct SceneRendererData
 		SceneRendererCamera SceneCamera;
 
 		DirectionalLight DirLight;
-		LightEnvironment LightEnv;
+
+		// Owned by the active scene, valid until the draw lists are flushed
+		const LightEnvironment* LightEnv = nullptr;
+		uint32_t LightSceneID = 0;
 
 	} SceneData;
 
 	Ref<Shader> LightingShader;
+	Ref<Shader> LightVolumeShader;
 	Ref<Shader> DualDepthPeelInitShader;
 	Ref<Shader> DualDepthPeelShader;
 	Ref<Shader> DualDepthPeelBlendShader;
 	Ref<Shader> DualDepthPeelCompositeShader;
+	Ref<Shader> WeightedBlendedShader;
+	Ref<Shader> WeightedBlendedResolveShader;
 	Ref<Shader> CompositeShader;
 
 	Ref<RenderPass> GeometryPass;
+	Ref<RenderPass> CompactGeometryPass;
 	Ref<RenderPass> LightingPass;
 	Ref<RenderPass> TransparencyPass;
+	Ref<RenderPass> WeightedBlendedPass;
 	Ref<RenderPass> CompositePass;
 
 	Ref<Framebuffer> TransparencyComposite;
 
+	// Occlusion queries around the back colour blend of every peel layer after the first, only touched on the render thread
+	struct PeelQuerySlot
+	{
+		std::vector<RendererID> Queries;
+		int LayerPeels = 0;
+		bool Pending = false;
+	};
+
+	PeelQuerySlot PeelQueries[s_PeelQuerySlots];
+
+	// Main thread, picks the slot of the next recorded transparency pass
+	uint32_t PeelQueryFrame = 0;
+
+	// Layer count the last resolved queries settled on, written on the render thread and read when recording
+	std::atomic<int> AdaptiveLayerPeels{ std::numeric_limits<int>::max() };
+
+	// Peel layers recorded this frame, including the initial depth pass
+	int ActiveLayerPeels = 0;
+
+	// Divisor of the peel target size last applied by SetViewportSize
+	uint32_t TransparencyResolution = 1;
+
+	// Rebuilt every flush from the passes and the options that decide what they read
+	RenderGraph Graph;
+
+	// Packed directional and point lights, re-uploaded only when the scene or its lights change
+	Ref<StorageBuffer> LightBuffer;
+	std::vector<byte> LightBufferData;
+
+	uint32_t LightBufferSceneID = 0;
+	uint32_t LightBufferVersion = 0;
+	DirectionalLight LightBufferDirLight;
+	bool LightBufferValid = false;
+
+	// World space point light bounds (xyz centre, w radius), rebuilt with the light buffer
+	std::vector<glm::vec4> LightSpheres;
+
+	// Point light lists per view space cluster, rebuilt when the camera or the lights change
+	LightClusterGrid LightClusters;
+	Ref<StorageBuffer> ClusterBuffer;
+	Ref<StorageBuffer> ClusterIndexBuffer;
+	std::vector<byte> ClusterBufferData;
+
+	glm::mat4 LightClusterViewMatrix;
+	glm::mat4 LightClusterProjection;
+	uint32_t LightClusterSceneID = 0;
+	uint32_t LightClusterVersion = 0;
+	bool LightClustersValid = false;
+
+	// Unit sphere drawn once per point light in light volume mode, with the centre and scaled radius of every light that passed culling
+	Ref<VertexArray> LightVolumeSphere;
+	std::vector<glm::vec4> LightVolumes;
+	std::vector<uint32_t> LightVolumeIndices;
+
 	struct DrawCommand
 	{
 		Ref<Mesh> Mesh;
 		Ref<MaterialInstance> Material;
 
 		glm::mat4 Transform;
+
+		// Index of the mesh's first submesh in the culling bounds and visibility arrays
+		uint32_t FirstSubmesh = 0;
 	};
 
 	std::vector<DrawCommand> MeshDrawList;
@@ -55,20 +137,703 @@ struct SceneRendererData
 	Ref<MaterialInstance> DualDepthPeel;
 	Ref<MaterialInstance> DualDepthPeelBlend;
 	Ref<MaterialInstance> DualDepthPeelComposite;
+	Ref<MaterialInstance> WeightedBlended;
+	Ref<MaterialInstance> WeightedBlendedResolve;
 
 	Ref<MaterialInstance> GridMaterial;
 	Ref<MaterialInstance> OutlineMaterial;
 
+	// One command list per draw list slice, reused for every draw list recorded in a frame
+	std::vector<Ref<CommandList>> CommandLists;
+
+	// Opaque geometry is recorded as sorted draw packets rather than per-draw render commands
+	RenderPacketBucket GeometryPackets{ 0 };
+	std::vector<RenderPacketRange> PacketRanges;
+
+	// World space submesh bounds of every draw list, culled against the camera frustum once per frame
+	CullingBounds SubmeshBounds;
+	std::vector<uint8_t> SubmeshVisibility;
+
+	// Scratch storage reused by draw list sorting
+	std::vector<RadixSortEntry> SortEntries;
+	std::vector<RadixSortEntry> SortScratch;
+	std::vector<DrawCommand> SortedDrawList;
+
+	SceneRendererStats Stats;
+
 	SceneRendererOptions Options;
 
+	// Size the scene is rendered at, the lower left corner of framebuffers allocated at the capacity
 	glm::vec2 ViewportSize;
+
+	// Framebuffers are only reallocated once the requested size has settled
+	glm::uvec2 FramebufferCapacity = { 0, 0 };
+	glm::uvec2 RequestedViewportSize = { 0, 0 };
+	std::chrono::steady_clock::time_point ViewportResizeTime;
 };
 
 static SceneRendererData s_Data;
 
+// GPU layout of the light buffer, matches the std430 LightBuffer block in Lighting.glsl
+struct GPUDirectionalLight
+{
+	glm::vec3 Direction;
+	float Brightness;
+
+	glm::vec3 Diffuse;
+	float Padding0;
+
+	glm::vec3 Ambient;
+	float Padding1;
+
+	glm::vec3 Specular;
+	float Padding2;
+};
+
+struct GPUPointLight
+{
+	glm::vec3 Position;
+	float Brightness;
+
+	glm::vec3 Diffuse;
+	float Quadratic;
+
+	glm::vec3 Specular;
+	float Radius;
+};
+
+struct GPULightBufferHeader
+{
+	GPUDirectionalLight DirectionalLight;
+
+	uint32_t PointLightCount;
+	uint32_t Padding[3];
+};
+
+static_assert(sizeof(GPUDirectionalLight) == 64 && sizeof(GPUPointLight) == 48 && sizeof(GPULightBufferHeader) == 80, "Light buffer layout does not match std430");
+
+// GPU layout of the cluster buffer header, followed by an (offset, count) pair per cluster into the cluster index buffer
+struct GPUClusterBufferHeader
+{
+	glm::mat4 ViewMatrix;
+
+	uint32_t GridSize[4];
+
+	float DepthScale;
+	float DepthBias;
+	float Padding[2];
+};
+
+static_assert(sizeof(GPUClusterBufferHeader) == 96 && sizeof(LightClusterGrid::Cluster) == 8, "Cluster buffer layout does not match std430");
+
+// Shader storage bindings of the light and cluster buffers, binding 0 is used by the instance buffer
+static constexpr uint32_t s_LightBufferBinding = 1;
+static constexpr uint32_t s_ClusterBufferBinding = 2;
+static constexpr uint32_t s_ClusterIndexBufferBinding = 3;
+
+// Seconds the requested viewport size has to stay unchanged before the framebuffers are reallocated
+static constexpr float s_ViewportSettleTime = 0.25f;
+
+// Tessellation of the light volume sphere
+static constexpr uint32_t s_LightVolumeRings = 12;
+static constexpr uint32_t s_LightVolumeSegments = 16;
+
+// Rounds up to a multiple of the largest power of two no greater than an eighth of the size, so the allocation is at most an eighth larger per axis
+static uint32_t GetFramebufferCapacity(uint32_t size)
+{
+	uint32_t step = 1;
+
+	while (step * 16 <= size)
+	{
+		step *= 2;
+	}
+
+	return (size + step - 1) / step * step;
+}
+
+// Smallest slice of a draw list worth recording on its own thread
+static constexpr uint32_t s_MinDrawCommandsPerList = 32;
+
+// Smallest number of submesh bounds worth culling on their own thread
+static constexpr uint32_t s_MinSubmeshesPerCullSlice = 256;
+
+// Number of slices a draw list is split into for parallel recording, lists that are too small to be worth splitting return 1
+static uint32_t GetDrawListSliceCount(uint32_t drawCount, uint32_t minPerSlice = s_MinDrawCommandsPerList)
+{
+	if (!s_Data.Options.ParallelRecording)
+	{
+		return 1;
+	}
+
+	uint32_t maxSlices = ThreadPool::Get().GetThreadCount() + 1;
+	uint32_t sliceCount = drawCount / minPerSlice;
+
+	if (sliceCount > maxSlices)
+	{
+		sliceCount = maxSlices;
+	}
+
+	return sliceCount < 1 ? 1 : sliceCount;
+}
+
+// Per submesh visibility of a draw command, null when culling is disabled so every submesh is drawn
+static const uint8_t* GetSubmeshVisibility(const SceneRendererData::DrawCommand& dc)
+{
+	return s_Data.Options.FrustumCulling ? s_Data.SubmeshVisibility.data() + dc.FirstSubmesh : nullptr;
+}
+
+// Records a draw list, large lists are split into slices that are recorded in parallel and stitched back together in slice order
+static void SubmitDrawList(const std::vector<SceneRendererData::DrawCommand>& drawList, Ref<MaterialInstance> overrideMaterial = nullptr)
+{
+	uint32_t drawCount = (uint32_t)drawList.size();
+	uint32_t sliceCount = GetDrawListSliceCount(drawCount);
+
+	if (sliceCount < 2)
+	{
+		for (auto& dc : drawList)
+		{
+			Renderer::SubmitMesh(dc.Mesh, dc.Transform, overrideMaterial, GetSubmeshVisibility(dc));
+		}
+
+		return;
+	}
+
+	while (s_Data.CommandLists.size() < sliceCount)
+	{
+		s_Data.CommandLists.push_back(CommandList::Create());
+	}
+
+	uint32_t sliceSize = (drawCount + sliceCount - 1) / sliceCount;
+
+	ThreadPool::Get().ParallelFor(sliceCount, [&](uint32_t slice)
+	{
+		uint32_t begin = slice * sliceSize;
+		uint32_t end = begin + sliceSize < drawCount ? begin + sliceSize : drawCount;
+
+		Ref<CommandList>& commandList = s_Data.CommandLists[slice];
+
+		commandList->Begin();
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			Renderer::SubmitMesh(drawList[i].Mesh, drawList[i].Transform, overrideMaterial, GetSubmeshVisibility(drawList[i]));
+		}
+
+		commandList->End();
+	});
+
+	// Stitch in slice order so the recorded frame is identical to a serial recording
+	for (uint32_t slice = 0; slice < sliceCount; slice++)
+	{
+		Renderer::SubmitCommandList(s_Data.CommandLists[slice]);
+	}
+}
+
+// Adds a draw list to a packet bucket, state is registered serially while transforms and sort depths are written across the thread pool
+static void AddDrawListPackets(RenderPacketBucket& bucket, const std::vector<SceneRendererData::DrawCommand>& drawList)
+{
+	uint32_t drawCount = (uint32_t)drawList.size();
+
+	s_Data.PacketRanges.resize(drawCount);
+
+	for (uint32_t i = 0; i < drawCount; i++)
+	{
+		s_Data.PacketRanges[i] = bucket.AddMesh(drawList[i].Mesh, nullptr, GetSubmeshVisibility(drawList[i]));
+	}
+
+	uint32_t sliceCount = GetDrawListSliceCount(drawCount);
+	uint32_t sliceSize = (drawCount + sliceCount - 1) / sliceCount;
+
+	auto writeSlice = [&](uint32_t slice)
+	{
+		uint32_t begin = slice * sliceSize;
+		uint32_t end = begin + sliceSize < drawCount ? begin + sliceSize : drawCount;
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			bucket.SetTransform(s_Data.PacketRanges[i], drawList[i].Mesh, drawList[i].Transform, GetSubmeshVisibility(drawList[i]));
+		}
+	};
+
+	if (sliceCount < 2)
+	{
+		writeSlice(0);
+	}
+	else
+	{
+		ThreadPool::Get().ParallelFor(sliceCount, writeSlice);
+	}
+}
+
+// Writes the world space bounds of every submesh in a draw list, slices of the list are written across the thread pool
+static void SetDrawListBounds(const std::vector<SceneRendererData::DrawCommand>& drawList)
+{
+	uint32_t drawCount = (uint32_t)drawList.size();
+	uint32_t sliceCount = GetDrawListSliceCount(drawCount);
+	uint32_t sliceSize = (drawCount + sliceCount - 1) / sliceCount;
+
+	auto writeSlice = [&](uint32_t slice)
+	{
+		uint32_t begin = slice * sliceSize;
+		uint32_t end = begin + sliceSize < drawCount ? begin + sliceSize : drawCount;
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const auto& submeshes = drawList[i].Mesh->GetSubmeshes();
+
+			for (uint32_t j = 0; j < (uint32_t)submeshes.size(); j++)
+			{
+				s_Data.SubmeshBounds.Set(drawList[i].FirstSubmesh + j, submeshes[j].BoundingBox, drawList[i].Transform * submeshes[j].Transform);
+			}
+		}
+	};
+
+	if (sliceCount < 2)
+	{
+		writeSlice(0);
+	}
+	else
+	{
+		ThreadPool::Get().ParallelFor(sliceCount, writeSlice);
+	}
+}
+
+// Maps a float onto an unsigned integer with the same ordering so it can be used as a radix sort key
+static uint32_t GetFloatSortKey(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(float));
+
+	return bits & 0x80000000 ? ~bits : bits | 0x80000000;
+}
+
+// Orders a draw list farthest first by the view depth of the centre of each mesh's submesh bounds
+static void SortDrawListBackToFront(std::vector<SceneRendererData::DrawCommand>& drawList, const glm::mat4& viewMatrix)
+{
+	uint32_t drawCount = (uint32_t)drawList.size();
+
+	s_Data.SortEntries.resize(drawCount);
+
+	for (uint32_t i = 0; i < drawCount; i++)
+	{
+		const auto& dc = drawList[i];
+		const auto& submeshes = dc.Mesh->GetSubmeshes();
+
+		glm::vec3 centre = glm::vec3(0.0f);
+
+		for (const Submesh& submesh : submeshes)
+		{
+			centre += glm::vec3(submesh.Transform * glm::vec4((submesh.BoundingBox.Min + submesh.BoundingBox.Max) * 0.5f, 1.0f));
+		}
+
+		if (!submeshes.empty())
+		{
+			centre /= (float)submeshes.size();
+		}
+
+		// View space looks down -z so the farthest mesh has the smallest z and sorts first
+		float viewDepth = (viewMatrix * dc.Transform * glm::vec4(centre, 1.0f)).z;
+
+		s_Data.SortEntries[i] = { GetFloatSortKey(viewDepth), i };
+	}
+
+	RadixSort(s_Data.SortEntries, s_Data.SortScratch);
+
+	s_Data.SortedDrawList.clear();
+
+	for (const RadixSortEntry& entry : s_Data.SortEntries)
+	{
+		s_Data.SortedDrawList.push_back(drawList[entry.Value]);
+	}
+
+	drawList.swap(s_Data.SortedDrawList);
+}
+
+// Geometry pass writing the g-buffer layout selected in the options
+static Ref<RenderPass> GetActiveGeometryPass()
+{
+	return s_Data.Options.CompactGBuffer ? s_Data.CompactGeometryPass : s_Data.GeometryPass;
+}
+
+// Binds the active g-buffer to the texture units of the Lighting.glsl and LightVolume.glsl samplers and sets how the shader should read it
+static void SetGBufferUniforms(const Ref<Shader>& shader)
+{
+	if (s_Data.Options.CompactGBuffer)
+	{
+		glm::mat4 viewProjection = s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix() * s_Data.SceneData.SceneCamera.ViewMatrix;
+
+		shader->SetMat4("u_InverseViewProjection", glm::inverse(viewProjection));
+	}
+
+	shader->SetInt("u_CompactGBuffer", s_Data.Options.CompactGBuffer ? 1 : 0);
+}
+
+// Packs the directional light and point lights into the light buffer, skipped when nothing has changed since the last upload
+static void UpdateLightBuffer()
+{
+	const DirectionalLight& dirLight = s_Data.SceneData.DirLight;
+	const LightEnvironment& lightEnv = *s_Data.SceneData.LightEnv;
+
+	if (s_Data.LightBufferValid && s_Data.LightBufferSceneID == s_Data.SceneData.LightSceneID && s_Data.LightBufferVersion == lightEnv.Version
+		&& memcmp(&s_Data.LightBufferDirLight, &dirLight, sizeof(DirectionalLight)) == 0)
+	{
+		return;
+	}
+
+	uint32_t pointLightCount = (uint32_t)lightEnv.PointLights.size();
+
+	s_Data.LightBufferData.resize(sizeof(GPULightBufferHeader) + pointLightCount * sizeof(GPUPointLight));
+
+	GPULightBufferHeader* header = (GPULightBufferHeader*)s_Data.LightBufferData.data();
+	*header = {};
+
+	header->DirectionalLight.Direction = dirLight.Direction;
+	header->DirectionalLight.Brightness = dirLight.Brightness;
+	header->DirectionalLight.Diffuse = dirLight.Diffuse;
+	header->DirectionalLight.Ambient = dirLight.Ambient;
+	header->DirectionalLight.Specular = dirLight.Specular;
+	header->PointLightCount = pointLightCount;
+
+	GPUPointLight* pointLights = (GPUPointLight*)(header + 1);
+
+	s_Data.LightSpheres.resize(pointLightCount);
+
+	for (uint32_t i = 0; i < pointLightCount; i++)
+	{
+		const PointLight& light = lightEnv.PointLights[i];
+
+		float intensity = std::max({ light.Diffuse.r, light.Diffuse.g, light.Diffuse.b, light.Specular.r, light.Specular.g, light.Specular.b });
+
+		s_Data.LightSpheres[i] = glm::vec4(light.Position, LightClusterGrid::GetPointLightRadius(light.Brightness, light.Quadratic, intensity));
+
+		pointLights[i].Position = light.Position;
+		pointLights[i].Brightness = light.Brightness;
+		pointLights[i].Diffuse = light.Diffuse;
+		pointLights[i].Quadratic = light.Quadratic;
+		pointLights[i].Specular = light.Specular;
+		pointLights[i].Radius = s_Data.LightSpheres[i].w;
+	}
+
+	s_Data.LightBuffer->SetData(s_Data.LightBufferData.data(), (uint32_t)s_Data.LightBufferData.size());
+
+	s_Data.LightBufferSceneID = s_Data.SceneData.LightSceneID;
+	s_Data.LightBufferVersion = lightEnv.Version;
+	s_Data.LightBufferDirLight = dirLight;
+	s_Data.LightBufferValid = true;
+}
+
+// Bins the point lights into the clusters of the current camera and uploads the lists, skipped when neither the view nor the lights have changed
+static void UpdateLightClusters()
+{
+	const glm::mat4& viewMatrix = s_Data.SceneData.SceneCamera.ViewMatrix;
+	const glm::mat4& projection = s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix();
+
+	s_Data.Stats.ClusterLightIndices = (uint32_t)s_Data.LightClusters.GetLightIndices().size();
+	s_Data.Stats.LightClusterTime = 0.0f;
+
+	if (s_Data.LightClustersValid && s_Data.LightClusterSceneID == s_Data.LightBufferSceneID && s_Data.LightClusterVersion == s_Data.LightBufferVersion
+		&& s_Data.LightClusterViewMatrix == viewMatrix && s_Data.LightClusterProjection == projection)
+	{
+		return;
+	}
+
+	auto clusterStart = std::chrono::high_resolution_clock::now();
+
+	LightClusterGrid& grid = s_Data.LightClusters;
+
+	grid.Build(viewMatrix, projection, s_Data.LightSpheres);
+
+	const std::vector<LightClusterGrid::Cluster>& clusters = grid.GetClusters();
+	const std::vector<uint32_t>& lightIndices = grid.GetLightIndices();
+
+	s_Data.ClusterBufferData.resize(sizeof(GPUClusterBufferHeader) + clusters.size() * sizeof(LightClusterGrid::Cluster));
+
+	GPUClusterBufferHeader* header = (GPUClusterBufferHeader*)s_Data.ClusterBufferData.data();
+	*header = {};
+
+	header->ViewMatrix = viewMatrix;
+	header->GridSize[0] = LightClusterGrid::s_GridX;
+	header->GridSize[1] = LightClusterGrid::s_GridY;
+	header->GridSize[2] = LightClusterGrid::s_GridZ;
+	header->DepthScale = grid.GetDepthScale();
+	header->DepthBias = grid.GetDepthBias();
+
+	memcpy(header + 1, clusters.data(), clusters.size() * sizeof(LightClusterGrid::Cluster));
+
+	s_Data.ClusterBuffer->SetData(s_Data.ClusterBufferData.data(), (uint32_t)s_Data.ClusterBufferData.size());
+
+	// An empty buffer cannot be bound, clusters with no lights never read from it
+	if (!lightIndices.empty())
+	{
+		s_Data.ClusterIndexBuffer->SetData(lightIndices.data(), (uint32_t)(lightIndices.size() * sizeof(uint32_t)));
+	}
+
+	s_Data.LightClusterViewMatrix = viewMatrix;
+	s_Data.LightClusterProjection = projection;
+	s_Data.LightClusterSceneID = s_Data.LightBufferSceneID;
+	s_Data.LightClusterVersion = s_Data.LightBufferVersion;
+	s_Data.LightClustersValid = true;
+
+	s_Data.Stats.ClusterLightIndices = (uint32_t)lightIndices.size();
+	s_Data.Stats.LightClusterTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - clusterStart).count();
+}
+
+// Render thread, turns the queries of a finished frame into the layer count later frames peel
+// A layer that blends nothing means every layer up to and including it is enough, if the last layer still blended there may be more so peel up to the bound again
+static bool ResolvePeelQueries(SceneRendererData::PeelQuerySlot& slot)
+{
+	if (slot.LayerPeels <= 1)
+	{
+		s_Data.AdaptiveLayerPeels = std::numeric_limits<int>::max();
+
+		return true;
+	}
+
+	// Queries complete in order, the last one being available means every earlier one is too
+	GLint available = 0;
+	glGetQueryObjectiv(slot.Queries[slot.LayerPeels - 2], GL_QUERY_RESULT_AVAILABLE, &available);
+
+	if (!available)
+	{
+		return false;
+	}
+
+	int layerPeels = std::numeric_limits<int>::max();
+
+	for (int i = 1; i < slot.LayerPeels; i++)
+	{
+		GLuint samplesPassed = 0;
+		glGetQueryObjectuiv(slot.Queries[i - 1], GL_QUERY_RESULT, &samplesPassed);
+
+		if (!samplesPassed)
+		{
+			layerPeels = i + 1;
+
+			break;
+		}
+	}
+
+	s_Data.AdaptiveLayerPeels = layerPeels;
+
+	return true;
+}
+
+// Render thread, resolves whatever earlier frames have finished without waiting on the rest then readies the queries of this frame
+static void BeginPeelQueries(uint32_t slotIndex, int layerPeels)
+{
+	for (uint32_t i = 1; i < s_PeelQuerySlots; i++)
+	{
+		SceneRendererData::PeelQuerySlot& slot = s_Data.PeelQueries[(slotIndex + i) % s_PeelQuerySlots];
+
+		if (slot.Pending && ResolvePeelQueries(slot))
+		{
+			slot.Pending = false;
+		}
+	}
+
+	// Results still missing after a full cycle of slots are dropped
+	SceneRendererData::PeelQuerySlot& slot = s_Data.PeelQueries[slotIndex];
+
+	if (slot.Queries.size() < (size_t)std::max(layerPeels - 1, 0))
+	{
+		size_t first = slot.Queries.size();
+
+		slot.Queries.resize(layerPeels - 1);
+
+		glCreateQueries(GL_ANY_SAMPLES_PASSED, (GLsizei)(slot.Queries.size() - first), &slot.Queries[first]);
+	}
+
+	slot.LayerPeels = layerPeels;
+	slot.Pending = true;
+}
+
+// UV sphere pushed out so its flat faces enclose the unit sphere, otherwise pixels at the very edge of a light's radius would be missed
+static Ref<VertexArray> CreateLightVolumeSphere()
+{
+	float scale = 1.0f / (cosf(glm::pi<float>() / s_LightVolumeSegments) * cosf(glm::pi<float>() / (2.0f * s_LightVolumeRings)));
+
+	std::vector<glm::vec3> vertices;
+	vertices.reserve((s_LightVolumeRings + 1) * (s_LightVolumeSegments + 1));
+
+	for (uint32_t ring = 0; ring <= s_LightVolumeRings; ring++)
+	{
+		float theta = glm::pi<float>() * ring / s_LightVolumeRings;
+
+		for (uint32_t segment = 0; segment <= s_LightVolumeSegments; segment++)
+		{
+			float phi = glm::two_pi<float>() * segment / s_LightVolumeSegments;
+
+			vertices.push_back(glm::vec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)) * scale);
+		}
+	}
+
+	// Counter-clockwise when seen from outside
+	std::vector<uint32_t> indices;
+	indices.reserve(s_LightVolumeRings * s_LightVolumeSegments * 6);
+
+	for (uint32_t ring = 0; ring < s_LightVolumeRings; ring++)
+	{
+		for (uint32_t segment = 0; segment < s_LightVolumeSegments; segment++)
+		{
+			uint32_t top = ring * (s_LightVolumeSegments + 1) + segment;
+			uint32_t bottom = top + s_LightVolumeSegments + 1;
+
+			indices.insert(indices.end(), { top, top + 1, bottom, top + 1, bottom + 1, bottom });
+		}
+	}
+
+	Ref<VertexArray> vertexArray = VertexArray::Create();
+
+	auto vertexBuffer = VertexBuffer::Create(vertices.data(), (uint32_t)(vertices.size() * sizeof(glm::vec3)));
+
+	vertexBuffer->SetLayout
+	({
+		{ ShaderDataType::Float3, "a_Position" }
+	});
+
+	auto indexBuffer = IndexBuffer::Create(indices.data(), (uint32_t)(indices.size() * sizeof(uint32_t)));
+
+	vertexArray->AddVertexBuffer(vertexBuffer);
+	vertexArray->SetIndexBuffer(indexBuffer);
+
+	return vertexArray;
+}
+
+// Draws a sphere per point light into the lighting target, the scene's depth and stencil must already be in it
+// Each light first counts depth test failures of its back and front faces in the stencil, pixels left non-zero have a surface inside the volume and are shaded additively
+static void SubmitLightVolumes()
+{
+	const glm::mat4& viewMatrix = s_Data.SceneData.SceneCamera.ViewMatrix;
+	const glm::mat4& projection = s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix();
+
+	glm::mat4 viewProjection = projection * viewMatrix;
+	glm::vec3 cameraPosition = glm::inverse(viewMatrix)[3];
+
+	float farClip = projection[3][2] / (projection[2][2] + 1.0f);
+
+	Frustum frustum(viewProjection);
+
+	s_Data.LightVolumes.clear();
+	s_Data.LightVolumeIndices.clear();
+
+	for (uint32_t i = 0; i < (uint32_t)s_Data.LightSpheres.size(); i++)
+	{
+		const glm::vec4& sphere = s_Data.LightSpheres[i];
+		glm::vec3 centre = glm::vec3(sphere);
+
+		if (sphere.w <= 0.0f)
+		{
+			continue;
+		}
+
+		// Lights without falloff have no finite radius, their volume only needs to enclose the view frustum
+		float radius = std::min(sphere.w, glm::length(centre - cameraPosition) + 2.0f * farClip);
+
+		if (!frustum.IntersectsBox(centre, glm::vec3(radius)))
+		{
+			continue;
+		}
+
+		s_Data.LightVolumes.push_back(glm::vec4(centre, radius));
+		s_Data.LightVolumeIndices.push_back(i);
+	}
+
+	s_Data.Stats.LightVolumes = (uint32_t)s_Data.LightVolumes.size();
+
+	s_Data.LightVolumeShader->Bind();
+
+	s_Data.LightVolumeShader->SetMat4("u_ViewProjectionMatrix", viewProjection);
+	s_Data.LightVolumeShader->SetVec3("u_CameraPosition", cameraPosition);
+
+	// Same texture units as the lighting shader, only the uniforms need setting again
+	if (s_Data.Options.CompactGBuffer)
+	{
+		s_Data.LightVolumeShader->SetMat4("u_InverseViewProjection", glm::inverse(viewProjection));
+		s_Data.LightVolumeShader->SetVec2("u_InverseViewportSize", 1.0f / s_Data.ViewportSize);
+	}
+
+	s_Data.LightVolumeShader->SetInt("u_CompactGBuffer", s_Data.Options.CompactGBuffer ? 1 : 0);
+
+	Ref<Shader> shader = s_Data.LightVolumeShader;
+	Ref<VertexArray> sphere = s_Data.LightVolumeSphere;
+
+	Renderer::Submit([shader, sphere, volumes = s_Data.LightVolumes, lightIndices = s_Data.LightVolumeIndices]()
+	{
+		int32_t volumeLocation = glGetUniformLocation(shader->GetRendererID(), "u_LightVolume");
+		int32_t lightIndexLocation = glGetUniformLocation(shader->GetRendererID(), "u_LightIndex");
+
+		uint32_t indexCount = sphere->GetIndexBuffer()->GetCount();
+
+		RenderState::BindVertexArray(sphere->GetRendererID());
+
+		// The background marking used by the directional pass is replaced by per light counts
+		glStencilMask(0xFF);
+		glClear(GL_STENCIL_BUFFER_BIT);
+
+		// Volumes crossing the near or far plane are clamped rather than clipped so they still mark the stencil
+		glEnable(GL_DEPTH_CLAMP);
+		glDepthMask(GL_FALSE);
+		glCullFace(GL_FRONT);
+
+		RenderState::SetBlendEquation(GL_FUNC_ADD);
+		RenderState::SetBlendFunc(GL_ONE, GL_ONE);
+
+		for (size_t i = 0; i < volumes.size(); i++)
+		{
+			glUniform4f(volumeLocation, volumes[i].x, volumes[i].y, volumes[i].z, volumes[i].w);
+			glUniform1i(lightIndexLocation, (int32_t)lightIndices[i]);
+
+			// Stencil, back faces behind the scene increment and front faces behind it decrement
+			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			glDisable(GL_CULL_FACE);
+
+			RenderState::SetDepthTest(true);
+			RenderState::SetBlend(false);
+
+			glStencilFunc(GL_ALWAYS, 0, 0xFF);
+			glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+			glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+
+			glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+
+			// Shading, back faces only so the camera can be inside the volume, the stencil is zeroed as it is read ready for the next light
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			glEnable(GL_CULL_FACE);
+
+			RenderState::SetDepthTest(false);
+			RenderState::SetBlend(true);
+
+			glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+			glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+
+			glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+		}
+
+		glDisable(GL_CULL_FACE);
+		glCullFace(GL_BACK);
+		glDisable(GL_DEPTH_CLAMP);
+		glDepthMask(GL_TRUE);
+
+		glStencilFunc(GL_ALWAYS, 0, 0xFF);
+		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		glDisable(GL_STENCIL_TEST);
+
+		RenderState::SetBlend(false);
+		RenderState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RenderState::SetDepthTest(true);
+	});
+}
+
 // Initialises scene renderer by setting up all required framebuffers and framebuffer textures and render passes
 void SceneRenderer::Init()
 {
+	#ifdef _DEBUG
+
+	// Catches a broken edit to the CPU packing reference before anything is rendered with the compact layout
+	ValidateGBufferPacking();
+
+	#endif
+
 	#pragma region Geometry Pass
 
 	// Geometry pass
@@ -81,26 +846,31 @@ void SceneRenderer::Init()
 	FramebufferTextureSpecification positionTexture;
 	positionTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	positionTexture.Format = FramebufferTextureFormat::RGBA16F;
+	positionTexture.Transient = true;
 
 	// Normal texture
 	FramebufferTextureSpecification normalTexture;
 	normalTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	normalTexture.Format = FramebufferTextureFormat::RGBA16F;
+	normalTexture.Transient = true;
 
 	// Diffuse texture
 	FramebufferTextureSpecification diffuseTexture;
 	diffuseTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	diffuseTexture.Format = FramebufferTextureFormat::RGBA16F;
+	diffuseTexture.Transient = true;
 
 	// Specular/Gloss texture
 	FramebufferTextureSpecification specularGlossTexture;
 	specularGlossTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	specularGlossTexture.Format = FramebufferTextureFormat::RGBA16F;
+	specularGlossTexture.Transient = true;
 
 	// Depth texture
 	FramebufferTextureSpecification geoDepthTexture;
 	geoDepthTexture.TextureUsage = FramebufferTextureUsage::DEPTH;
 	geoDepthTexture.Format = FramebufferTextureFormat::DEPTH24STENCIL8;
+	geoDepthTexture.Transient = true;
 
 	geoFramebufferSpec.Attach(positionTexture, 0);
 	geoFramebufferSpec.Attach(normalTexture, 1);
@@ -111,6 +881,33 @@ void SceneRenderer::Init()
 	geoRenderPassSpec.TargetFramebuffer = Framebuffer::Create(geoFramebufferSpec);
 	s_Data.GeometryPass = RenderPass::Create(geoRenderPassSpec);
 
+	// Compact geometry pass
+	RenderPassSpecification compactGeoRenderPassSpec;
+	FramebufferSpecification compactGeoFramebufferSpec;
+	compactGeoFramebufferSpec.Width = 1280;
+	compactGeoFramebufferSpec.Height = 720;
+
+	// Albedo/Specular texture
+	FramebufferTextureSpecification albedoSpecularTexture;
+	albedoSpecularTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
+	albedoSpecularTexture.Format = FramebufferTextureFormat::RGBA8;
+	albedoSpecularTexture.MagFilter = FramebufferTextureFiltering::NEAREST;
+	albedoSpecularTexture.Transient = true;
+
+	// Octahedral normal/Gloss texture, packed values cannot be filtered
+	FramebufferTextureSpecification normalGlossTexture;
+	normalGlossTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
+	normalGlossTexture.Format = FramebufferTextureFormat::RGBA8;
+	normalGlossTexture.MagFilter = FramebufferTextureFiltering::NEAREST;
+	normalGlossTexture.Transient = true;
+
+	compactGeoFramebufferSpec.Attach(albedoSpecularTexture, 0);
+	compactGeoFramebufferSpec.Attach(normalGlossTexture, 1);
+	compactGeoFramebufferSpec.Attach(geoDepthTexture, 2);
+
+	compactGeoRenderPassSpec.TargetFramebuffer = Framebuffer::Create(compactGeoFramebufferSpec);
+	s_Data.CompactGeometryPass = RenderPass::Create(compactGeoRenderPassSpec);
+
 	#pragma endregion
 
 	#pragma region Lighting Pass
@@ -125,11 +922,13 @@ void SceneRenderer::Init()
 	FramebufferTextureSpecification lightAccumulationTexture;
 	lightAccumulationTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	lightAccumulationTexture.Format = FramebufferTextureFormat::RGBA16F;
+	lightAccumulationTexture.Transient = true;
 
 	// Depth texture
 	FramebufferTextureSpecification lightDepthTexture;
 	lightDepthTexture.TextureUsage = FramebufferTextureUsage::DEPTH;
 	lightDepthTexture.Format = FramebufferTextureFormat::DEPTH24STENCIL8;
+	lightDepthTexture.Transient = true;
 
 	lightingFramebufferSpec.Attach(lightAccumulationTexture, 0);
 	lightingFramebufferSpec.Attach(lightDepthTexture, 1);
@@ -138,6 +937,9 @@ void SceneRenderer::Init()
 	s_Data.LightingPass = RenderPass::Create(lightingRenderPassSpec);
 
 	s_Data.LightingShader = Shader::Create("assets/shaders/Lighting.glsl");
+	s_Data.LightVolumeShader = Shader::Create("assets/shaders/LightVolume.glsl");
+
+	s_Data.LightVolumeSphere = CreateLightVolumeSphere();
 
 	#pragma endregion
 
@@ -154,24 +956,28 @@ void SceneRenderer::Init()
 	fragDepthTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	fragDepthTexture.TextureType = FramebufferTextureType::TEXRECT;
 	fragDepthTexture.Format = FramebufferTextureFormat::RG16F_RECT;
+	fragDepthTexture.Transient = true;
 
 	// Front texture
 	FramebufferTextureSpecification frontTexture;
 	frontTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	frontTexture.TextureType = FramebufferTextureType::TEXRECT;
 	frontTexture.Format = FramebufferTextureFormat::RGBA8F_RECT;
+	frontTexture.Transient = true;
 
 	// Back texture
 	FramebufferTextureSpecification backTexture;
 	backTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	backTexture.TextureType = FramebufferTextureType::TEXRECT;
 	backTexture.Format = FramebufferTextureFormat::RGBA8F_RECT;
+	backTexture.Transient = true;
 
 	// Colour blend texture
 	FramebufferTextureSpecification colourBlendTexture;
 	colourBlendTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
 	colourBlendTexture.TextureType = FramebufferTextureType::TEXRECT;
 	colourBlendTexture.Format = FramebufferTextureFormat::RGB8F_RECT;
+	colourBlendTexture.Transient = true;
 
 	transparencyFramebufferSpec.Attach(fragDepthTexture, 0);
 	transparencyFramebufferSpec.Attach(fragDepthTexture, 3);
@@ -188,12 +994,9 @@ void SceneRenderer::Init()
 	transparencyCompositeFramebufferSpec.Width = 1280;
 	transparencyCompositeFramebufferSpec.Height = 720;
 
-	FramebufferTextureSpecification transparenyCompositeTexture;
-	transparenyCompositeTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
-	transparenyCompositeTexture.TextureType = FramebufferTextureType::TEX2D;
-	transparenyCompositeTexture.Format = FramebufferTextureFormat::RGBA8;
-
-	transparencyCompositeFramebufferSpec.Attach(transparenyCompositeTexture, 0);
+	// Full resolution front and back colours upsampled from reduced resolution peel targets
+	transparencyCompositeFramebufferSpec.Attach(frontTexture, 0);
+	transparencyCompositeFramebufferSpec.Attach(colourBlendTexture, 1);
 
 	s_Data.TransparencyComposite = Framebuffer::Create(transparencyCompositeFramebufferSpec);
 	
@@ -213,6 +1016,46 @@ void SceneRenderer::Init()
 
 	#pragma endregion
 
+	#pragma region Weighted Blended Pass
+
+	// Weighted blended transparency pass
+	RenderPassSpecification weightedBlendedRenderPassSpec;
+	FramebufferSpecification weightedBlendedFramebufferSpec;
+	weightedBlendedFramebufferSpec.Width = 1280;
+	weightedBlendedFramebufferSpec.Height = 720;
+
+	// Weighted premultiplied colour and weighted alpha, summed over every fragment
+	FramebufferTextureSpecification accumulationTexture;
+	accumulationTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
+	accumulationTexture.TextureType = FramebufferTextureType::TEX2D;
+	accumulationTexture.Format = FramebufferTextureFormat::RGBA16F;
+	accumulationTexture.Transient = true;
+
+	// Product of one minus alpha over every fragment
+	FramebufferTextureSpecification revealageTexture;
+	revealageTexture.TextureUsage = FramebufferTextureUsage::COLOUR;
+	revealageTexture.TextureType = FramebufferTextureType::TEX2D;
+	revealageTexture.Format = FramebufferTextureFormat::RED8;
+	revealageTexture.Transient = true;
+
+	// Resolved into the same front and back colour layout the composite reads from the peel textures
+	weightedBlendedFramebufferSpec.Attach(accumulationTexture, 0);
+	weightedBlendedFramebufferSpec.Attach(revealageTexture, 1);
+	weightedBlendedFramebufferSpec.Attach(frontTexture, 2);
+	weightedBlendedFramebufferSpec.Attach(colourBlendTexture, 3);
+
+	weightedBlendedRenderPassSpec.TargetFramebuffer = Framebuffer::Create(weightedBlendedFramebufferSpec);
+	s_Data.WeightedBlendedPass = RenderPass::Create(weightedBlendedRenderPassSpec);
+
+	s_Data.WeightedBlendedShader = Shader::Create("assets/shaders/WeightedBlended.glsl");
+	s_Data.WeightedBlended = MaterialInstance::Create(Material::Create(s_Data.WeightedBlendedShader));
+	s_Data.WeightedBlended->SetFlag(MaterialFlag::DepthTest, false);
+
+	s_Data.WeightedBlendedResolveShader = Shader::Create("assets/shaders/WeightedBlendedResolve.glsl");
+	s_Data.WeightedBlendedResolve = MaterialInstance::Create(Material::Create(s_Data.WeightedBlendedResolveShader));
+
+	#pragma endregion
+
 	#pragma region Composite Pass
 
 	// Composite pass
@@ -247,6 +1090,11 @@ void SceneRenderer::Init()
 
 	#pragma endregion
 
+	s_Data.LightBuffer = StorageBuffer::Create(sizeof(GPULightBufferHeader) + 64 * sizeof(GPUPointLight), s_LightBufferBinding);
+
+	s_Data.ClusterBuffer = StorageBuffer::Create(sizeof(GPUClusterBufferHeader) + LightClusterGrid::s_ClusterCount * sizeof(LightClusterGrid::Cluster), s_ClusterBufferBinding);
+	s_Data.ClusterIndexBuffer = StorageBuffer::Create(LightClusterGrid::s_ClusterCount * sizeof(uint32_t), s_ClusterIndexBufferBinding);
+
 	// Grid
 	auto gridShader = Shader::Create("assets/shaders/Grid.glsl");
 	s_Data.GridMaterial = MaterialInstance::Create(Material::Create(gridShader));
@@ -264,17 +1112,76 @@ void SceneRenderer::Init()
 	s_Data.OutlineMaterial->SetFlag(MaterialFlag::DepthTest, false);
 }
 
-// Calls Framebuffer::Resize for resizing all framebuffers when the viewport changes size
-void SceneRenderer::SetViewportSize(uint32_t width, uint32_t height)
-{
-	s_Data.GeometryPass->GetSpecification().TargetFramebuffer->Resize(width, height);
-	s_Data.LightingPass->GetSpecification().TargetFramebuffer->Resize(width, height);
-	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->Resize(width, height);
-	s_Data.CompositePass->GetSpecification().TargetFramebuffer->Resize(width, height);
+// Calls Framebuffer::Resize for resizing all framebuffers when the viewport changes size
+// Reallocating every target while the viewport is being dragged hitches, the scene renders into the corner of the current allocation instead
+// A size larger than the allocation is clamped to it until the size settles
+void SceneRenderer::SetViewportSize(uint32_t width, uint32_t height)
+{
+	// Minimised or collapsed viewport
+	if (width == 0 || height == 0)
+	{
+		return;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+
+	if (s_Data.RequestedViewportSize != glm::uvec2(width, height))
+	{
+		s_Data.RequestedViewportSize = { width, height };
+		s_Data.ViewportResizeTime = now;
+	}
+
+	Ref<Framebuffer> framebuffers[] =
+	{
+		s_Data.GeometryPass->GetSpecification().TargetFramebuffer,
+		s_Data.CompactGeometryPass->GetSpecification().TargetFramebuffer,
+		s_Data.LightingPass->GetSpecification().TargetFramebuffer,
+		s_Data.WeightedBlendedPass->GetSpecification().TargetFramebuffer,
+		s_Data.CompositePass->GetSpecification().TargetFramebuffer,
+		s_Data.TransparencyComposite
+	};
+
+	glm::uvec2 capacity = { GetFramebufferCapacity(width), GetFramebufferCapacity(height) };
+
+	// The first size is allocated straight away
+	bool settled = s_Data.FramebufferCapacity.x == 0 || std::chrono::duration<float>(now - s_Data.ViewportResizeTime).count() >= s_ViewportSettleTime;
+
+	if (capacity != s_Data.FramebufferCapacity && settled)
+	{
+		for (Ref<Framebuffer>& framebuffer : framebuffers)
+		{
+			framebuffer->Resize(capacity.x, capacity.y);
+		}
+
+		s_Data.FramebufferCapacity = capacity;
+	}
+
+	glm::uvec2 viewportSize = glm::min(s_Data.RequestedViewportSize, s_Data.FramebufferCapacity);
+
+	for (Ref<Framebuffer>& framebuffer : framebuffers)
+	{
+		framebuffer->SetViewport(viewportSize.x, viewportSize.y);
+	}
+
+	// Peel targets are the allocation and viewport divided by the transparency resolution, rounded up to cover every pixel
+	uint32_t transparencyResolution = (uint32_t)std::clamp(s_Data.Options.TransparencyResolution, 1, 4);
+
+	Ref<Framebuffer> peelFramebuffer = s_Data.TransparencyPass->GetSpecification().TargetFramebuffer;
+
+	glm::uvec2 peelCapacity = (s_Data.FramebufferCapacity + transparencyResolution - 1u) / transparencyResolution;
+
+	if (peelCapacity != glm::uvec2(peelFramebuffer->GetSpecification().Width, peelFramebuffer->GetSpecification().Height))
+	{
+		peelFramebuffer->Resize(peelCapacity.x, peelCapacity.y);
+	}
+
+	glm::uvec2 peelViewportSize = (viewportSize + transparencyResolution - 1u) / transparencyResolution;
+
+	peelFramebuffer->SetViewport(peelViewportSize.x, peelViewportSize.y);
 
-	s_Data.TransparencyComposite->Resize(width, height);
+	s_Data.TransparencyResolution = transparencyResolution;
 
-	s_Data.ViewportSize = { width, height };
+	s_Data.ViewportSize = viewportSize;
 }
 
 // Sets the active scene, scene camera and scenes light environment
@@ -286,7 +1193,8 @@ void SceneRenderer::BeginScene(const Scene* scene, const SceneRendererCamera& ca
 
 	s_Data.SceneData.SceneCamera = camera;
 	s_Data.SceneData.DirLight = scene->m_Light;
-	s_Data.SceneData.LightEnv = scene->m_LightEnvironment;
+	s_Data.SceneData.LightEnv = &scene->m_LightEnvironment;
+	s_Data.SceneData.LightSceneID = scene->GetUUID();
 }
 
 void SceneRenderer::EndScene()
@@ -301,8 +1209,6 @@ void SceneRenderer::EndScene()
 // Submits a mesh to its corresponding draw list
 void SceneRenderer::SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<MaterialInstance> overrideMaterial, bool transparency)
 {
-	// Culling, sorting, can be done here
-	
 	if (transparency)
 	{
 		s_Data.TransparentMeshDrawList.push_back({ mesh, nullptr, transform });
@@ -329,32 +1235,50 @@ void SceneRenderer::SubmitSelectedMesh(Ref<Mesh> mesh, const glm::mat4& transfor
 // Geometry pass to create g-buffer
 void SceneRenderer::GeometryPass()
 {
-	Renderer::BeginRenderPass(s_Data.GeometryPass);
+	// Every pixel covered by geometry is marked so light volume mode can leave the background out of the directional pass
+	bool markStencil = s_Data.Options.LightVolumes;
+
+	if (markStencil)
+	{
+		Renderer::Submit([]()
+		{
+			glEnable(GL_STENCIL_TEST);
+			glStencilFunc(GL_ALWAYS, 1, 0xFF);
+			glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+			glStencilMask(0xFF);
+		});
+	}
 
 	auto viewProjection = s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix() * s_Data.SceneData.SceneCamera.ViewMatrix;
 	glm::vec3 cameraPosition = glm::inverse(s_Data.SceneData.SceneCamera.ViewMatrix)[3];
 
-	// Render non-selected meshes
+	float compactGBuffer = s_Data.Options.CompactGBuffer ? 1.0f : 0.0f;
+
+	// Material values are written up front, recording may happen on several threads which only read materials
 	for (auto& dc : s_Data.MeshDrawList)
 	{
-		auto baseMaterial = dc.Mesh->GetMaterial();
-		auto shader = baseMaterial->GetShader();
-
-		baseMaterial->Set("u_ViewProjectionMatrix", viewProjection);
-
-		Renderer::SubmitMesh(dc.Mesh, dc.Transform);
+		dc.Mesh->GetMaterial()->Set("u_ViewProjectionMatrix", viewProjection);
+		dc.Mesh->GetMaterial()->Set("u_CompactGBuffer", compactGBuffer);
 	}
 
-	// Render only selected meshes
 	for (auto& dc : s_Data.SelectedMeshDrawList)
 	{
-		auto baseMaterial = dc.Mesh->GetMaterial();
-		auto shader = baseMaterial->GetShader();
+		dc.Mesh->GetMaterial()->Set("u_ViewProjectionMatrix", viewProjection);
+		dc.Mesh->GetMaterial()->Set("u_CompactGBuffer", compactGBuffer);
+	}
 
-		baseMaterial->Set("u_ViewProjectionMatrix", viewProjection);
+	// Far clip recovered from the perspective projection, used to normalise packet sort depths
+	const glm::mat4& projection = s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix();
+	float farClip = projection[3][2] / (projection[2][2] + 1.0f);
 
-		Renderer::SubmitMesh(dc.Mesh, dc.Transform);
-	}
+	s_Data.GeometryPackets.Begin(s_Data.SceneData.SceneCamera.ViewMatrix, farClip);
+	s_Data.GeometryPackets.SetInstancing(s_Data.Options.Instancing);
+
+	// Non-selected and selected meshes share one bucket so they are sorted together
+	AddDrawListPackets(s_Data.GeometryPackets, s_Data.MeshDrawList);
+	AddDrawListPackets(s_Data.GeometryPackets, s_Data.SelectedMeshDrawList);
+
+	s_Data.GeometryPackets.Flush();
 
 	// Grid
 	if (GetOptions().ShowGrid)
@@ -377,13 +1301,41 @@ void SceneRenderer::GeometryPass()
 		Renderer2D::EndScene();
 	}
 
-	Renderer::EndRenderPass();
+	if (markStencil)
+	{
+		Renderer::Submit([]()
+		{
+			glDisable(GL_STENCIL_TEST);
+		});
+	}
 }
 
 // Lighting pass that utilises g-buffer for performing per-pixel lighting
 void SceneRenderer::LightingPass()
 {
-	Renderer::BeginRenderPass(s_Data.LightingPass);
+	bool lightVolumes = s_Data.Options.LightVolumes;
+
+	// Light volumes are depth tested against the scene, which also brings the geometry stencil marking with it
+	if (lightVolumes)
+	{
+		Ref<Framebuffer> geometryFramebuffer = GetActiveGeometryPass()->GetSpecification().TargetFramebuffer;
+		Ref<Framebuffer> lightingFramebuffer = s_Data.LightingPass->GetSpecification().TargetFramebuffer;
+
+		uint32_t width = lightingFramebuffer->GetViewportWidth();
+		uint32_t height = lightingFramebuffer->GetViewportHeight();
+
+		Renderer::Submit([geometryFramebuffer, lightingFramebuffer, width, height]()
+		{
+			glBlitNamedFramebuffer(geometryFramebuffer->GetRendererID(), lightingFramebuffer->GetRendererID(), 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+
+			// The directional pass only shades pixels covered by geometry
+			glEnable(GL_STENCIL_TEST);
+			glStencilFunc(GL_EQUAL, 1, 0xFF);
+			glStencilMask(0x00);
+
+			RenderState::SetDepthTest(false);
+		});
+	}
 
 	glm::vec3 cameraPosition = glm::inverse(s_Data.SceneData.SceneCamera.ViewMatrix)[3];
 
@@ -391,50 +1343,35 @@ void SceneRenderer::LightingPass()
 
 	s_Data.LightingShader->SetVec3("u_CameraPosition", cameraPosition);
 
-	// Bind colour attachments
-	s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(0, 0); // Position
-	s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(1, 1); // Normals
-	s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(2, 2); // Diffuse
-	s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(3, 3); // Specular
+	SetGBufferUniforms(s_Data.LightingShader);
 
-	// Directional light
-	s_Data.LightingShader->SetFloat("r_DirectionalLight.Brightness", s_Data.SceneData.DirLight.Brightness);
-	s_Data.LightingShader->SetVec3("r_DirectionalLight.Direction", s_Data.SceneData.DirLight.Direction);
-	s_Data.LightingShader->SetVec3("r_DirectionalLight.Diffuse", s_Data.SceneData.DirLight.Diffuse);
-	s_Data.LightingShader->SetVec3("r_DirectionalLight.Ambient", s_Data.SceneData.DirLight.Ambient);
-	s_Data.LightingShader->SetVec3("r_DirectionalLight.Specular", s_Data.SceneData.DirLight.Specular);
+	UpdateLightBuffer();
 
-	// Point lights
-	int it = 0;
-
-	// Iterate over all point lights
-	for (it; it < 100; it++)
-	{
-		auto& pointLight = s_Data.SceneData.LightEnv.PointLights[it];
+	// Point lights are shaded by the fullscreen pass unless they are drawn as volumes
+	bool clusteredLighting = s_Data.Options.ClusteredLighting && !lightVolumes;
 
-		if (pointLight.Brightness == 0.0f)
-		{
-			break;
-		}
+	s_Data.LightingShader->SetInt("u_PointLightMode", lightVolumes ? 2 : clusteredLighting ? 1 : 0);
 
-		s_Data.LightingShader->SetVec3("r_PointLights[" + std::to_string(it) + "].Position", pointLight.Position);
-		s_Data.LightingShader->SetVec3("r_PointLights[" + std::to_string(it) + "].Diffuse", pointLight.Diffuse);
-		s_Data.LightingShader->SetFloat("r_PointLights[" + std::to_string(it) + "].Brightness", pointLight.Brightness);
-		s_Data.LightingShader->SetFloat("r_PointLights[" + std::to_string(it) + "].Quadratic", pointLight.Quadratic);
-		s_Data.LightingShader->SetVec3("r_PointLights[" + std::to_string(it) + "].Specular", pointLight.Specular);
+	if (clusteredLighting)
+	{
+		UpdateLightClusters();
+	}
+	else
+	{
+		s_Data.Stats.ClusterLightIndices = 0;
+		s_Data.Stats.LightClusterTime = 0.0f;
 	}
-
-	s_Data.LightingShader->SetInt("r_PointLightCount", it);
 
 	Renderer::SubmitFullscreenQuad(nullptr);
 
-	Renderer::EndRenderPass();
+	if (lightVolumes)
+	{
+		SubmitLightVolumes();
+	}
 }
 
 void SceneRenderer::TransparencyPass()
 {
-	Renderer::BeginRenderPass(s_Data.TransparencyPass);
-
 	const float MAX_DEPTH = 1.0f;
 
 	int currentAttachment = 0;
@@ -446,7 +1383,7 @@ void SceneRenderer::TransparencyPass()
 
 	Renderer::Submit([]()
 	{
-		glEnable(GL_BLEND);
+		RenderState::SetBlend(true);
 	});
 
 	// Render targets 1 and 2 store the front and back colours
@@ -464,29 +1401,39 @@ void SceneRenderer::TransparencyPass()
 	// Enable max blending
 	Renderer::Submit([]()
 	{
-		glBlendEquation(GL_MAX);
+		RenderState::SetBlendEquation(GL_MAX);
 	});
 
-	// Render non-selected transparent meshes with DepthPeelingInit
-	for (auto& dc : s_Data.TransparentMeshDrawList)
-	{
-		auto material = s_Data.DualDepthPeelInit;
+	s_Data.DualDepthPeelInit->Set("u_ViewProjectionMatrix", viewProjection);
 
-		material->Set("u_ViewProjectionMatrix", viewProjection);
+	s_Data.DualDepthPeel->Set("u_ViewProjectionMatrix", viewProjection);
+	s_Data.DualDepthPeel->Set("u_Alpha", 0.25f);
 
-		Renderer::SubmitMesh(dc.Mesh, dc.Transform, material);
-	}
+	s_Data.Stats.LayerPeels = (uint32_t)s_Data.ActiveLayerPeels;
 
-	// Render only selected transparent meshes with DepthPeelingInit
-	for (auto& dc : s_Data.SelectedTransparentMeshDrawList)
-	{
-		auto material = s_Data.DualDepthPeelInit;
+	bool adaptive = s_Data.Options.AdaptiveLayerPeels;
+	uint32_t querySlot = s_Data.PeelQueryFrame++ % s_PeelQuerySlots;
 
-		material->Set("u_ViewProjectionMatrix", viewProjection);
+	if (adaptive)
+	{
+		int layerPeels = s_Data.ActiveLayerPeels;
 
-		Renderer::SubmitMesh(dc.Mesh, dc.Transform, material);
+		Renderer::Submit([querySlot, layerPeels]()
+		{
+			BeginPeelQueries(querySlot, layerPeels);
+		});
 	}
 
+	RenderProfiler::BeginScope("Peel Layer 0");
+
+	// Render non-selected transparent meshes with DepthPeelingInit
+	SubmitDrawList(s_Data.TransparentMeshDrawList, s_Data.DualDepthPeelInit);
+
+	// Render only selected transparent meshes with DepthPeelingInit
+	SubmitDrawList(s_Data.SelectedTransparentMeshDrawList, s_Data.DualDepthPeelInit);
+
+	RenderProfiler::EndScope();
+
 	// Bind our back colour texture
 	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->DrawBuffers(6);
 
@@ -502,8 +1449,10 @@ void SceneRenderer::TransparencyPass()
 	int frontAttachments[2] = { 1, 4 };
 	int backAttachments[2] = { 2, 5 };
 
-	for (int i = 1; i < s_Data.Options.LayerPeels; i++)
+	for (int i = 1; i < s_Data.ActiveLayerPeels; i++)
 	{
+		RenderProfilerScope layerScope("Peel Layer " + std::to_string(i));
+
 		// Always provide us the modulo of the current layer and 2 (currentAttachment will always be 0 or 1)
 		currentAttachment = i % 2;
 
@@ -531,7 +1480,7 @@ void SceneRenderer::TransparencyPass()
 		// Enable max blending
 		Renderer::Submit([]()
 		{
-			glBlendEquation(GL_MAX);
+			RenderState::SetBlendEquation(GL_MAX);
 		});
 
 		// Bind our depth texture to texture unit 0 (alternate between both depth attachments)
@@ -542,31 +1491,15 @@ void SceneRenderer::TransparencyPass()
 
 		Renderer::Submit([]()
 		{
-			glEnable(GL_BLEND);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			RenderState::SetBlend(true);
+			RenderState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		});
 
 		// Render non-selected transparent meshes with DepthPeeling
-		for (auto& dc : s_Data.TransparentMeshDrawList)
-		{
-			auto material = s_Data.DualDepthPeel;
-
-			material->Set("u_ViewProjectionMatrix", viewProjection);
-			material->Set("u_Alpha", 0.25f);
-
-			Renderer::SubmitMesh(dc.Mesh, dc.Transform, material);
-		}
+		SubmitDrawList(s_Data.TransparentMeshDrawList, s_Data.DualDepthPeel);
 
 		// Render only selected transparent meshes with DepthPeeling
-		for (auto& dc : s_Data.SelectedTransparentMeshDrawList)
-		{
-			auto material = s_Data.DualDepthPeel;
-
-			material->Set("u_ViewProjectionMatrix", viewProjection);
-			material->Set("u_Alpha", 0.25f);
-
-			Renderer::SubmitMesh(dc.Mesh, dc.Transform, material);
-		}
+		SubmitDrawList(s_Data.SelectedTransparentMeshDrawList, s_Data.DualDepthPeel);
 
 		// Full-screen pass to alpha-blend the back texture (this is written to our intermediate blender texture)
 		s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->DrawBuffers(6);
@@ -574,79 +1507,313 @@ void SceneRenderer::TransparencyPass()
 		// Enable over blending
 		Renderer::Submit([]()
 		{
-			glBlendEquation(GL_FUNC_ADD);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			RenderState::SetBlendEquation(GL_FUNC_ADD);
+			RenderState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		});
 
 		// Bind our back texture to texture unit 0 (alternate between our first and last back texture)
 		s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->BindColourAttachment(backAttachments[currentAttachment], 0);
 
+		// Count the fragments of the layer that survive the blend shader's discard, none means the adaptive count can stop here
+		if (adaptive)
+		{
+			Renderer::Submit([querySlot, i]()
+			{
+				glBeginQuery(GL_ANY_SAMPLES_PASSED, s_Data.PeelQueries[querySlot].Queries[i - 1]);
+			});
+		}
+
 		// Render alpha-blended results to full-screen quad
 		Renderer::SubmitFullscreenQuad(s_Data.DualDepthPeelBlend);
+
+		if (adaptive)
+		{
+			Renderer::Submit([]()
+			{
+				glEndQuery(GL_ANY_SAMPLES_PASSED);
+			});
+		}
 	}
 
 	// Disable blending
 	Renderer::Submit([]()
 	{
-		glDisable(GL_BLEND);
+		RenderState::SetBlend(false);
 	});
 
-	// Bind our composite framebuffer here
+}
+
+// Upsamples the front and back colours of the last peeled layer to the viewport resolution, weighting the peel texels by how close their opaque depth is to the pixel's
+// Only runs when the peel targets are below full resolution, its peel and depth textures are bound by the render graph
+void SceneRenderer::DualDepthPeelCompositePass()
+{
 	s_Data.TransparencyComposite->Bind();
+	s_Data.TransparencyComposite->DrawBuffers(0, 1);
 
-	// Bind our depth attachment to texture unit 0 (alternate between our first and last depth texture)
-	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->BindColourAttachment(depthAttachments[currentAttachment], 0);
+	Ref<Framebuffer> peelFramebuffer = s_Data.TransparencyPass->GetSpecification().TargetFramebuffer;
 
-	// Bind our front attachments to texture unit 1
-	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->BindColourAttachment(frontAttachments[currentAttachment], 1);
+	const glm::mat4& projection = s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix();
 
-	// Bind our colour blend texture to texture unit 2
-	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->BindColourAttachment(6, 2);
+	s_Data.DualDepthPeelComposite->Set("u_ResolutionFactor", (int)s_Data.TransparencyResolution);
+	s_Data.DualDepthPeelComposite->Set("u_PeelViewportSize", glm::vec2((float)peelFramebuffer->GetViewportWidth(), (float)peelFramebuffer->GetViewportHeight()));
+	s_Data.DualDepthPeelComposite->Set("u_ProjectionParams", glm::vec2(projection[3][2], projection[2][2]));
 
-	// Render final results to full-screen quad
 	Renderer::SubmitFullscreenQuad(s_Data.DualDepthPeelComposite);
-	Renderer::EndRenderPass();
+
+	s_Data.TransparencyComposite->Unbind();
+}
+
+// Draws every transparent mesh once, each fragment adds its weighted colour to the accumulation target and scales down the revealage
+void SceneRenderer::WeightedBlendedPass()
+{
+	Ref<Framebuffer> framebuffer = s_Data.WeightedBlendedPass->GetSpecification().TargetFramebuffer;
+
+	framebuffer->DrawBuffers(0);
+	framebuffer->Clear(0.0f, 0.0f, 0.0f, 0.0f);
+
+	// Nothing drawn leaves the background fully revealed
+	framebuffer->DrawBuffers(1);
+	framebuffer->Clear(1.0f, 0.0f, 0.0f, 0.0f);
+
+	framebuffer->DrawBuffers(0, 1);
+
+	Renderer::Submit([]()
+	{
+		RenderState::SetBlend(true);
+		RenderState::SetBlendEquation(GL_FUNC_ADD);
+
+		RenderState::SetBlendFunc(0, GL_ONE, GL_ONE);
+		RenderState::SetBlendFunc(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+	});
+
+	auto viewProjection = s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix() * s_Data.SceneData.SceneCamera.ViewMatrix;
+
+	// Same colour and alpha as the peeled layers so both techniques can be compared
+	s_Data.WeightedBlended->Set("u_ViewProjectionMatrix", viewProjection);
+	s_Data.WeightedBlended->Set("u_Alpha", 0.25f);
+
+	SubmitDrawList(s_Data.TransparentMeshDrawList, s_Data.WeightedBlended);
+	SubmitDrawList(s_Data.SelectedTransparentMeshDrawList, s_Data.WeightedBlended);
+
+	Renderer::Submit([]()
+	{
+		RenderState::SetBlend(false);
+	});
 }
 
-void SceneRenderer::CompositePass()
+// Turns the accumulated colour and revealage into a front colour and coverage plus an empty back colour, the textures the composite reads after peeling
+void SceneRenderer::WeightedBlendedResolvePass()
 {
-	Renderer::BeginRenderPass(s_Data.CompositePass);
+	s_Data.WeightedBlendedPass->GetSpecification().TargetFramebuffer->DrawBuffers(2, 3);
+
+	Renderer::SubmitFullscreenQuad(s_Data.WeightedBlendedResolve);
+}
 
+void SceneRenderer::CompositePass(bool transparency)
+{
 	s_Data.CompositeShader->Bind();
 	s_Data.CompositeShader->SetFloat("u_Exposure", s_Data.SceneData.SceneCamera.Camera.GetExposure());
 
-	// Bind our light pass texture
-	s_Data.LightingPass->GetSpecification().TargetFramebuffer->BindColourAttachment();
+	// Peel textures are only bound when the peel passes ran this frame
+	s_Data.CompositeShader->SetInt("u_Transparency", transparency ? 1 : 0);
+
+	Renderer::SubmitFullscreenQuad(nullptr);
+}
+
+// Declares every pass with the attachments and buffers it reads and writes, the graph culls what the composite does not need
+void SceneRenderer::BuildRenderGraph()
+{
+	RenderGraph& graph = s_Data.Graph;
+	graph.Reset();
+
+	const SceneRendererOptions& options = s_Data.Options;
+
+	bool compactGBuffer = options.CompactGBuffer;
+
+	// G-buffer targets, the compact layout only has albedo/specular and normal/gloss
+	Ref<Framebuffer> geometryFramebuffer = GetActiveGeometryPass()->GetSpecification().TargetFramebuffer;
+
+	RenderGraphResource gbuffer[4];
+	uint32_t gbufferTargets = compactGBuffer ? 2 : 4;
+
+	const char* gbufferNames[4] = { "Position", "Normal", "Diffuse", "Specular" };
+	const char* compactGBufferNames[2] = { "AlbedoSpecular", "NormalGloss" };
+
+	for (uint32_t i = 0; i < gbufferTargets; i++)
+	{
+		gbuffer[i] = graph.ImportTexture(compactGBuffer ? compactGBufferNames[i] : gbufferNames[i], geometryFramebuffer, i);
+	}
+
+	RenderGraphResource gbufferDepth = graph.ImportTexture("GBufferDepth", geometryFramebuffer, gbufferTargets, true);
+
+	RenderGraphResource lightBuffer = graph.ImportBuffer("LightBuffer", s_Data.LightBuffer);
+	RenderGraphResource clusterBuffer = graph.ImportBuffer("ClusterBuffer", s_Data.ClusterBuffer);
+	RenderGraphResource clusterIndexBuffer = graph.ImportBuffer("ClusterIndexBuffer", s_Data.ClusterIndexBuffer);
+
+	RenderGraphResource lighting = graph.ImportTexture("Lighting", s_Data.LightingPass->GetSpecification().TargetFramebuffer, 0);
+	RenderGraphResource lightingDepth = graph.ImportTexture("LightingDepth", s_Data.LightingPass->GetSpecification().TargetFramebuffer, 1, true);
+
+	// Peel attachments, depth at 0 and 3, front at 1 and 4, back at 2 and 5 and the blended back colour at 6
+	Ref<Framebuffer> peelFramebuffer = s_Data.TransparencyPass->GetSpecification().TargetFramebuffer;
+
+	const char* peelNames[7] = { "PeelDepth0", "PeelFront0", "PeelBack0", "PeelDepth1", "PeelFront1", "PeelBack1", "PeelBlend" };
+
+	RenderGraphResource peel[7];
+
+	for (uint32_t i = 0; i < 7; i++)
+	{
+		peel[i] = graph.ImportTexture(peelNames[i], peelFramebuffer, i);
+	}
+
+	RenderGraphResource transparencyFront = graph.ImportTexture("TransparencyFront", s_Data.TransparencyComposite, 0);
+	RenderGraphResource transparencyBack = graph.ImportTexture("TransparencyBack", s_Data.TransparencyComposite, 1);
+
+	// Weighted blended attachments, accumulation at 0, revealage at 1 and the resolved front and back colours at 2 and 3
+	Ref<Framebuffer> weightedBlendedFramebuffer = s_Data.WeightedBlendedPass->GetSpecification().TargetFramebuffer;
+
+	const char* weightedBlendedNames[4] = { "WeightedAccumulation", "WeightedRevealage", "WeightedFront", "WeightedBack" };
+
+	RenderGraphResource weightedBlended[4];
 
-	// Check SceneRenderer options for showing g-buffer textures individually
-	if (GetOptions().ShowPosition)
+	for (uint32_t i = 0; i < 4; i++)
 	{
-		s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(0, 0);
+		weightedBlended[i] = graph.ImportTexture(weightedBlendedNames[i], weightedBlendedFramebuffer, i);
 	}
 
-	if (GetOptions().ShowNormal)
+	RenderGraphResource composite = graph.ImportTexture("Composite", s_Data.CompositePass->GetSpecification().TargetFramebuffer, 0);
+	graph.SetOutput(composite);
+
+	// Geometry
+	{
+		RenderGraphPassBuilder pass = graph.AddPass("Geometry", GetActiveGeometryPass(), []() { GeometryPass(); });
+
+		for (uint32_t i = 0; i < gbufferTargets; i++)
+		{
+			pass.Write(gbuffer[i]);
+		}
+
+		pass.Write(gbufferDepth);
+	}
+
+	// Lighting
 	{
-		s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(1, 0);
+		RenderGraphPassBuilder pass = graph.AddPass("Lighting", s_Data.LightingPass, []() { LightingPass(); });
+
+		if (compactGBuffer)
+		{
+			pass.Read(gbuffer[1], 1).Read(gbuffer[0], 2).Read(gbufferDepth, 4);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < gbufferTargets; i++)
+			{
+				pass.Read(gbuffer[i], i);
+			}
+		}
+
+		// Light volumes blit the g-buffer depth and stencil into the lighting framebuffer
+		if (options.LightVolumes)
+		{
+			pass.Read(gbufferDepth, -1, RenderGraphAccess::RenderTarget);
+		}
+
+		pass.Read(lightBuffer, -1, RenderGraphAccess::Storage);
+
+		if (options.ClusteredLighting && !options.LightVolumes)
+		{
+			pass.Read(clusterBuffer, -1, RenderGraphAccess::Storage).Read(clusterIndexBuffer, -1, RenderGraphAccess::Storage);
+		}
+
+		pass.Write(lighting).Write(lightingDepth);
 	}
 
-	if (GetOptions().ShowDiffuse)
+	bool transparency = !s_Data.TransparentMeshDrawList.empty() || !s_Data.SelectedTransparentMeshDrawList.empty();
+	bool weightedBlendedTransparency = options.Transparency == TransparencyTechnique::WeightedBlended;
+
+	// The user set count is the upper bound of the adaptive count
+	s_Data.ActiveLayerPeels = std::max(options.LayerPeels, 1);
+
+	if (options.AdaptiveLayerPeels)
 	{
-		s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(2, 0);
+		s_Data.ActiveLayerPeels = std::min(s_Data.ActiveLayerPeels, s_Data.AdaptiveLayerPeels.load());
 	}
 
-	if (GetOptions().ShowSpecular)
+	// The peel loop ping-pongs between the two sets of depth and front textures, the last layer decides which holds the result
+	uint32_t lastLayer = (uint32_t)((s_Data.ActiveLayerPeels - 1) % 2) * 3;
+
+	// Dual depth peeling
 	{
-		s_Data.GeometryPass->GetSpecification().TargetFramebuffer->BindColourAttachment(3, 0);
+		RenderGraphPassBuilder pass = graph.AddPass("DualDepthPeel", s_Data.TransparencyPass, []() { TransparencyPass(); });
+
+		for (uint32_t i = 0; i < 7; i++)
+		{
+			pass.Write(peel[i]);
+		}
 	}
 
-	// Bind our front, back and colour blender textures from depth-peeled pass
-	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->BindColourAttachment(0, 1);
-	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->BindColourAttachment(1, 2);
-	s_Data.TransparencyPass->GetSpecification().TargetFramebuffer->BindColourAttachment(6, 3);
+	// Upsampling of reduced resolution peel targets, culled at full resolution where the composite reads the peel textures directly
+	graph.AddPass("DualDepthPeelComposite", nullptr, []() { DualDepthPeelCompositePass(); })
+		.Read(peel[lastLayer + 1], 0)
+		.Read(peel[6], 1)
+		.Read(gbufferDepth, 2)
+		.Write(transparencyFront)
+		.Write(transparencyBack);
+
+	// Weighted blended transparency, culled unless the composite reads its resolved colours
+	graph.AddPass("WeightedBlended", s_Data.WeightedBlendedPass, []() { WeightedBlendedPass(); }, false)
+		.Write(weightedBlended[0])
+		.Write(weightedBlended[1]);
+
+	graph.AddPass("WeightedBlendedResolve", s_Data.WeightedBlendedPass, []() { WeightedBlendedResolvePass(); }, false)
+		.Read(weightedBlended[0], 0)
+		.Read(weightedBlended[1], 1)
+		.Write(weightedBlended[2])
+		.Write(weightedBlended[3]);
+
+	// Composite, a g-buffer debug view replaces the lighting result
+	{
+		RenderGraphResource source = lighting;
+
+		if (options.ShowPosition)
+		{
+			source = compactGBuffer ? gbufferDepth : gbuffer[0];
+		}
 
-	Renderer::SubmitFullscreenQuad(nullptr);
+		if (options.ShowNormal)
+		{
+			source = gbuffer[1];
+		}
+
+		if (options.ShowDiffuse)
+		{
+			source = gbuffer[compactGBuffer ? 0 : 2];
+		}
+
+		if (options.ShowSpecular)
+		{
+			source = gbuffer[compactGBuffer ? 0 : 3];
+		}
+
+		RenderGraphPassBuilder pass = graph.AddPass("Composite", s_Data.CompositePass, [transparency]() { CompositePass(transparency); });
+
+		pass.Read(source, 0);
+
+		// Either technique hands the composite a front colour with its coverage and a back colour
+		if (transparency && weightedBlendedTransparency)
+		{
+			pass.Read(weightedBlended[2], 2).Read(weightedBlended[3], 3);
+		}
+		else if (transparency && s_Data.TransparencyResolution > 1)
+		{
+			pass.Read(transparencyFront, 2).Read(transparencyBack, 3);
+		}
+		else if (transparency)
+		{
+			pass.Read(peel[lastLayer], 1).Read(peel[lastLayer + 1], 2).Read(peel[6], 3);
+		}
 
-	Renderer::EndRenderPass();
+		pass.Write(composite);
+	}
 }
 
 // Executes each render pass in order and flushes both mesh draw lists (transparent and non-transparent)
@@ -654,10 +1821,27 @@ void SceneRenderer::FlushDrawList()
 {
 	LD_CORE_ASSERT(!s_Data.ActiveScene, "");
 
-	GeometryPass();
-	LightingPass();
-	TransparencyPass();
-	CompositePass();
+	RenderProfiler::BeginFrame();
+
+	{
+		RenderProfilerScope frameScope("Scene");
+
+		{
+			RenderProfilerScope cullScope("CullDrawLists");
+
+			CullDrawLists();
+		}
+
+		{
+			RenderProfilerScope sortScope("SortDrawLists");
+
+			SortDrawLists();
+		}
+
+		BuildRenderGraph();
+
+		s_Data.Graph.Execute();
+	}
 
 	s_Data.MeshDrawList.clear();
 	s_Data.SelectedMeshDrawList.clear();
@@ -666,6 +1850,123 @@ void SceneRenderer::FlushDrawList()
 	s_Data.SceneData = {};
 }
 
+// Tests the bounds of every submesh in every draw list against the camera frustum and drops meshes with no visible submesh
+void SceneRenderer::CullDrawLists()
+{
+	std::vector<SceneRendererData::DrawCommand>* drawLists[] =
+	{
+		&s_Data.MeshDrawList,
+		&s_Data.SelectedMeshDrawList,
+		&s_Data.TransparentMeshDrawList,
+		&s_Data.SelectedTransparentMeshDrawList
+	};
+
+	uint32_t submeshCount = 0;
+
+	for (auto* drawList : drawLists)
+	{
+		for (auto& dc : *drawList)
+		{
+			dc.FirstSubmesh = submeshCount;
+			submeshCount += (uint32_t)dc.Mesh->GetSubmeshes().size();
+		}
+	}
+
+	s_Data.Stats = {};
+	s_Data.Stats.Submeshes = submeshCount;
+
+	if (!s_Data.Options.FrustumCulling)
+	{
+		s_Data.Stats.VisibleSubmeshes = submeshCount;
+
+		return;
+	}
+
+	s_Data.SubmeshBounds.Resize(submeshCount);
+	s_Data.SubmeshVisibility.resize(s_Data.SubmeshBounds.GetPaddedCount());
+
+	for (auto* drawList : drawLists)
+	{
+		SetDrawListBounds(*drawList);
+	}
+
+	Frustum frustum(s_Data.SceneData.SceneCamera.Camera.GetProjectionMatrix() * s_Data.SceneData.SceneCamera.ViewMatrix);
+
+	// Slices start on batch boundaries so each slice is tested with whole SIMD batches
+	uint32_t sliceCount = GetDrawListSliceCount(submeshCount, s_MinSubmeshesPerCullSlice);
+	uint32_t sliceSize = (submeshCount + sliceCount - 1) / sliceCount;
+	sliceSize = (sliceSize + CullingBounds::s_BatchSize - 1) / CullingBounds::s_BatchSize * CullingBounds::s_BatchSize;
+
+	std::atomic<uint32_t> visibleCount(0);
+
+	auto cullSlice = [&](uint32_t slice)
+	{
+		uint32_t begin = slice * sliceSize;
+		uint32_t end = begin + sliceSize < submeshCount ? begin + sliceSize : submeshCount;
+
+		if (begin < end)
+		{
+			visibleCount += s_Data.SubmeshBounds.Cull(frustum, begin, end - begin, s_Data.SubmeshVisibility.data() + begin);
+		}
+	};
+
+	if (sliceCount < 2)
+	{
+		cullSlice(0);
+	}
+	else
+	{
+		ThreadPool::Get().ParallelFor(sliceCount, cullSlice);
+	}
+
+	s_Data.Stats.VisibleSubmeshes = visibleCount;
+	s_Data.Stats.CulledSubmeshes = submeshCount - visibleCount;
+
+	// Meshes with nothing left to draw are removed so no pass pays for binding them
+	for (auto* drawList : drawLists)
+	{
+		auto culled = std::remove_if(drawList->begin(), drawList->end(), [](const SceneRendererData::DrawCommand& dc)
+		{
+			const uint8_t* visibility = s_Data.SubmeshVisibility.data() + dc.FirstSubmesh;
+
+			for (size_t i = 0; i < dc.Mesh->GetSubmeshes().size(); i++)
+			{
+				if (visibility[i])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		});
+
+		s_Data.Stats.CulledMeshes += (uint32_t)(drawList->end() - culled);
+
+		drawList->erase(culled, drawList->end());
+	}
+}
+
+// Opaque lists are sorted per submesh by shader, material, mesh and front to back depth when their packets are dispatched
+// Transparent lists keep submission order unless back to front sorting is enabled
+void SceneRenderer::SortDrawLists()
+{
+	s_Data.Stats.SortedTransparentMeshes = 0;
+	s_Data.Stats.TransparentSortTime = 0.0f;
+
+	if (!s_Data.Options.SortTransparentBackToFront)
+	{
+		return;
+	}
+
+	auto sortStart = std::chrono::high_resolution_clock::now();
+
+	SortDrawListBackToFront(s_Data.TransparentMeshDrawList, s_Data.SceneData.SceneCamera.ViewMatrix);
+	SortDrawListBackToFront(s_Data.SelectedTransparentMeshDrawList, s_Data.SceneData.SceneCamera.ViewMatrix);
+
+	s_Data.Stats.TransparentSortTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - sortStart).count();
+	s_Data.Stats.SortedTransparentMeshes = (uint32_t)(s_Data.TransparentMeshDrawList.size() + s_Data.SelectedTransparentMeshDrawList.size());
+}
+
 Ref<RenderPass> SceneRenderer::GetFinalRenderPass()
 {
 	return s_Data.CompositePass;
@@ -676,7 +1977,26 @@ uint32_t SceneRenderer::GetFinalColourBufferRendererID()
 	return s_Data.CompositePass->GetSpecification().TargetFramebuffer->GetColourAttachmentRendererID();
 }
 
+glm::vec2 SceneRenderer::GetFinalColourBufferScale()
+{
+	Ref<Framebuffer> framebuffer = s_Data.CompositePass->GetSpecification().TargetFramebuffer;
+
+	const FramebufferSpecification& spec = framebuffer->GetSpecification();
+
+	return { (float)framebuffer->GetViewportWidth() / (float)spec.Width, (float)framebuffer->GetViewportHeight() / (float)spec.Height };
+}
+
 SceneRendererOptions& SceneRenderer::GetOptions()
 {
 	return s_Data.Options;
+}
+
+const SceneRendererStats& SceneRenderer::GetStats()
+{
+	return s_Data.Stats;
+}
+
+const std::vector<RenderGraphPassStats>& SceneRenderer::GetRenderGraphStats()
+{
+	return s_Data.Graph.GetPassStats();
 }
\ No newline at end of file
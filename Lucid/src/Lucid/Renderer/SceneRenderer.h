@@ -1,10 +1,21 @@
 #pragma once
 
 #include "Lucid/Renderer/Mesh.h"
+#include "Lucid/Renderer/RenderGraph.h"
 #include "Lucid/Renderer/RenderPass.h"
 
 #include "Lucid/Scene/Scene.h"
 
+// Order independent technique used for meshes submitted as transparent
+enum class TransparencyTechnique
+{
+	// Exact for up to LayerPeels layers, costs a geometry pass per layer
+	DualDepthPeeling = 0,
+
+	// One geometry pass into an accumulation and a revealage target, order is approximated by weighting fragments by depth
+	WeightedBlended = 1
+};
+
 struct SceneRendererOptions
 {
 	bool ShowDepthPeeling = false;
@@ -16,7 +27,66 @@ struct SceneRendererOptions
 	bool ShowBoundingBoxes = false;
 	bool SetCameraMode = false;
 
+	// Record draw lists across the thread pool, one command list per slice
+	bool ParallelRecording = true;
+
+	// Skip submeshes whose world space bounds are outside the camera frustum
+	bool FrustumCulling = true;
+
+	// Draw repeated submeshes sharing a material with one instanced draw call
+	bool Instancing = true;
+
+	// Draw transparent meshes farthest first, depth peeling resolves order per pixel so this only matters for order dependent blending
+	bool SortTransparentBackToFront = false;
+
+	// Bin point lights into view space clusters so each pixel only shades the lights that can reach it
+	bool ClusteredLighting = true;
+
+	// Draw each point light as a stencil marked sphere so only pixels within its radius are shaded, takes priority over clustered lighting
+	bool LightVolumes = false;
+
+	// Write albedo/specular and octahedral normal/gloss to two RGBA8 targets and rebuild position from depth, 12 bytes per pixel instead of 36
+	bool CompactGBuffer = false;
+
+	TransparencyTechnique Transparency = TransparencyTechnique::DualDepthPeeling;
+
+	// Stop peeling once a layer blends no fragments, measured with occlusion queries read back a frame or more later
+	// LayerPeels becomes the upper bound
+	bool AdaptiveLayerPeels = true;
+
 	int LayerPeels = 4;
+
+	// Divides the width and height of the dual depth peeling targets, 2 for half and 4 for quarter resolution
+	// The peeled colours are upsampled against the opaque depth buffer so edges between near and far surfaces stay sharp
+	int TransparencyResolution = 1;
+};
+
+// Culling and sorting results of the last flushed frame
+struct SceneRendererStats
+{
+	uint32_t Submeshes = 0;
+	uint32_t VisibleSubmeshes = 0;
+	uint32_t CulledSubmeshes = 0;
+
+	// Meshes dropped from their draw list because every submesh was culled
+	uint32_t CulledMeshes = 0;
+
+	uint32_t SortedTransparentMeshes = 0;
+
+	// Milliseconds
+	float TransparentSortTime = 0.0f;
+
+	// Entries in the cluster light lists, a light is counted once per cluster it overlaps
+	uint32_t ClusterLightIndices = 0;
+
+	// Milliseconds, zero when the clusters were reused from the previous frame
+	float LightClusterTime = 0.0f;
+
+	// Point lights drawn as light volumes after culling them against the camera frustum
+	uint32_t LightVolumes = 0;
+
+	// Dual depth peeling layers recorded, including the initial depth pass
+	uint32_t LayerPeels = 0;
 };
 
 struct SceneRendererCamera
@@ -33,6 +103,7 @@ public:
 
 	static void Init();
 
+	// Called every frame with the size of the viewport, framebuffers are reallocated once the size stops changing
 	static void SetViewportSize(uint32_t width, uint32_t height);
 
 	static void BeginScene(const Scene* scene, const SceneRendererCamera& camera);
@@ -45,14 +116,30 @@ public:
 
 	static uint32_t GetFinalColourBufferRendererID();
 
+	// Fraction of the final colour buffer covered by the viewport, the rest is spare capacity
+	static glm::vec2 GetFinalColourBufferScale();
+
 	static SceneRendererOptions& GetOptions();
 
+	static const SceneRendererStats& GetStats();
+
+	// Passes of the last flushed frame in execution order, including the ones the render graph culled
+	static const std::vector<RenderGraphPassStats>& GetRenderGraphStats();
+
 private:
 
 	static void FlushDrawList();
 
+	static void CullDrawLists();
+	static void SortDrawLists();
+
+	static void BuildRenderGraph();
+
 	static void GeometryPass();
 	static void LightingPass();
 	static void TransparencyPass();
-	static void CompositePass();
+	static void DualDepthPeelCompositePass();
+	static void WeightedBlendedPass();
+	static void WeightedBlendedResolvePass();
+	static void CompositePass(bool transparency);
 };
\ No newline at end of file
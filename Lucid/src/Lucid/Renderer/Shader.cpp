@@ -9,6 +9,7 @@
 #include <limits>
 
 #include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderState.h"
 
 std::vector<Ref<Shader>> Shader::s_AllShaders;
 
@@ -175,6 +176,8 @@ void Shader::Load(const std::string& source)
 		if (m_RendererID)
 		{
 			glDeleteProgram(m_RendererID);
+
+			RenderState::Invalidate();
 		}
 
 		CompileAndUploadShader();
@@ -212,7 +215,7 @@ void Shader::Bind()
 {
 	Renderer::Submit([=]()
 	{
-		glUseProgram(m_RendererID);
+		RenderState::UseProgram(m_RendererID);
 	});
 }
 
@@ -535,7 +538,7 @@ void Shader::ParseUniformStruct(const std::string& block, ShaderDomain domain)
 
 void Shader::ResolveUniforms()
 {
-	glUseProgram(m_RendererID);
+	RenderState::UseProgram(m_RendererID);
 
 	for (size_t i = 0; i < m_VSRendererUniformBuffers.size(); i++)
 	{
@@ -809,24 +812,41 @@ void Shader::CompileAndUploadShader()
 
 void Shader::SetVSMaterialUniformBuffer(Memory buffer)
 {
-	Renderer::Submit([this, buffer]()
+	// Materials go on being set for the next frame while the render thread draws this one, so the values are copied into the command
+	Renderer::SubmitWithData(buffer.Data, buffer.Size, [this](Memory uniforms)
 	{
-		glUseProgram(m_RendererID);
+		RenderState::UseProgram(m_RendererID);
 
-		ResolveAndSetUniforms(m_VSMaterialUniformBuffer, buffer);
+		ResolveAndSetUniforms(m_VSMaterialUniformBuffer, uniforms);
 	});
 }
 
 void Shader::SetFSMaterialUniformBuffer(Memory buffer)
 {
-	Renderer::Submit([this, buffer]()
+	Renderer::SubmitWithData(buffer.Data, buffer.Size, [this](Memory uniforms)
 	{
-		glUseProgram(m_RendererID);
+		RenderState::UseProgram(m_RendererID);
 
-		ResolveAndSetUniforms(m_FSMaterialUniformBuffer, buffer);
+		ResolveAndSetUniforms(m_FSMaterialUniformBuffer, uniforms);
 	});
 }
 
+void Shader::SetVSMaterialUniformBufferFromRenderThread(Memory buffer)
+{
+	if (m_VSMaterialUniformBuffer)
+	{
+		ResolveAndSetUniforms(m_VSMaterialUniformBuffer, buffer);
+	}
+}
+
+void Shader::SetFSMaterialUniformBufferFromRenderThread(Memory buffer)
+{
+	if (m_FSMaterialUniformBuffer)
+	{
+		ResolveAndSetUniforms(m_FSMaterialUniformBuffer, buffer);
+	}
+}
+
 void Shader::ResolveAndSetUniforms(const Scope<ShaderUniformBufferDeclaration>& decl, Memory buffer)
 {
 	const ShaderUniformList& uniforms = decl->GetUniformDeclarations();
@@ -1234,7 +1254,7 @@ void Shader::UploadUniformIntArray(const std::string& name, int32_t* values, uin
 
 void Shader::UploadUniformFloat(const std::string& name, float value)
 {
-	glUseProgram(m_RendererID);
+	RenderState::UseProgram(m_RendererID);
 
 	auto location = glGetUniformLocation(m_RendererID, name.c_str());
 
@@ -1250,7 +1270,7 @@ void Shader::UploadUniformFloat(const std::string& name, float value)
 
 void Shader::UploadUniformFloat2(const std::string& name, const glm::vec2& values)
 {
-	glUseProgram(m_RendererID);
+	RenderState::UseProgram(m_RendererID);
 
 	auto location = glGetUniformLocation(m_RendererID, name.c_str());
 
@@ -1266,7 +1286,7 @@ void Shader::UploadUniformFloat2(const std::string& name, const glm::vec2& value
 
 void Shader::UploadUniformFloat3(const std::string& name, const glm::vec3& values)
 {
-	glUseProgram(m_RendererID);
+	RenderState::UseProgram(m_RendererID);
 
 	auto location = glGetUniformLocation(m_RendererID, name.c_str());
 
@@ -1282,7 +1302,7 @@ void Shader::UploadUniformFloat3(const std::string& name, const glm::vec3& value
 
 void Shader::UploadUniformFloat4(const std::string& name, const glm::vec4& values)
 {
-	glUseProgram(m_RendererID);
+	RenderState::UseProgram(m_RendererID);
 
 	auto location = glGetUniformLocation(m_RendererID, name.c_str());
 
@@ -1298,7 +1318,7 @@ void Shader::UploadUniformFloat4(const std::string& name, const glm::vec4& value
 
 void Shader::UploadUniformMat4(const std::string& name, const glm::mat4& values)
 {
-	glUseProgram(m_RendererID);
+	RenderState::UseProgram(m_RendererID);
 
 	auto location = glGetUniformLocation(m_RendererID, name.c_str());
 
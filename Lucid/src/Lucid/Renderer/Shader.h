@@ -117,6 +117,10 @@ public:
 	void SetVSMaterialUniformBuffer(Memory buffer);
 	void SetFSMaterialUniformBuffer(Memory buffer);
 
+	// Uploads material uniforms to the program that is currently bound, for use by render commands that bind the program themselves
+	void SetVSMaterialUniformBufferFromRenderThread(Memory buffer);
+	void SetFSMaterialUniformBufferFromRenderThread(Memory buffer);
+
 	void SetFloat(const std::string& name, float value);
 	void SetInt(const std::string& name, int value);
 	void SetVec2(const std::string& name, const glm::vec2& value);
@@ -42,4 +42,9 @@ Ref<Shader>& ShaderLibrary::Get(const std::string& name)
 	LD_CORE_ASSERT(m_Shaders.find(name) != m_Shaders.end());
 
 	return m_Shaders[name];
+}
+
+bool ShaderLibrary::Exists(const std::string& name) const
+{
+	return m_Shaders.find(name) != m_Shaders.end();
 }
\ No newline at end of file
@@ -16,6 +16,8 @@ public:
 
 	Ref<Shader>& Get(const std::string& name);
 
+	bool Exists(const std::string& name) const;
+
 private:
 
 	std::unordered_map<std::string, Ref<Shader>> m_Shaders;
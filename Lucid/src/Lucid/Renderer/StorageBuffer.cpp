@@ -0,0 +1,75 @@
+#include "ldpch.h"
+
+#include <glad/glad.h>
+
+#include "StorageBuffer.h"
+
+#include "Lucid/Renderer/Renderer.h"
+
+Ref<StorageBuffer> StorageBuffer::Create(uint32_t size, uint32_t binding)
+{
+	return Ref<StorageBuffer>::Create(size, binding);
+}
+
+StorageBuffer::StorageBuffer(uint32_t size, uint32_t binding)
+	: m_Size(size), m_Binding(binding)
+{
+	Ref<StorageBuffer> instance = this;
+
+	Renderer::Submit([instance]() mutable
+	{
+		glCreateBuffers(1, &instance->m_RendererID);
+		glNamedBufferData(instance->m_RendererID, instance->m_Size, nullptr, GL_DYNAMIC_DRAW);
+	});
+}
+
+StorageBuffer::~StorageBuffer()
+{
+	GLuint rendererID = m_RendererID;
+
+	Renderer::Submit([rendererID]()
+	{
+		glDeleteBuffers(1, &rendererID);
+	});
+}
+
+void StorageBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+{
+	Ref<StorageBuffer> instance = this;
+
+	if (offset + size > m_Size)
+	{
+		// Grow to the next power of two so a slowly growing buffer is not reallocated every write
+		uint32_t newSize = m_Size ? m_Size : 1;
+
+		while (newSize < offset + size)
+		{
+			newSize *= 2;
+		}
+
+		m_Size = newSize;
+
+		Renderer::Submit([instance, newSize]()
+		{
+			glNamedBufferData(instance->m_RendererID, newSize, nullptr, GL_DYNAMIC_DRAW);
+		});
+	}
+
+	// The data is copied into the command so the caller's memory can be reused straight away
+	std::vector<byte> localData((const byte*)data, (const byte*)data + size);
+
+	Renderer::Submit([instance, localData, offset]()
+	{
+		glNamedBufferSubData(instance->m_RendererID, offset, localData.size(), localData.data());
+	});
+}
+
+void StorageBuffer::Bind() const
+{
+	Ref<const StorageBuffer> instance = this;
+
+	Renderer::Submit([instance]()
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, instance->m_Binding, instance->m_RendererID);
+	});
+}
\ No newline at end of file
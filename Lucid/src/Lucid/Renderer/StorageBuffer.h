@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Lucid/Core/Base.h"
+
+// Shader storage buffer bound to a fixed binding point, written from the main thread through the render command queue
+class StorageBuffer : public RefCounted
+{
+
+public:
+
+	StorageBuffer(uint32_t size, uint32_t binding);
+	~StorageBuffer();
+
+	// Copies data into the buffer, a write past the end grows the buffer and discards its previous contents
+	void SetData(const void* data, uint32_t size, uint32_t offset = 0);
+
+	void Bind() const;
+
+	uint32_t GetSize() const { return m_Size; }
+	uint32_t GetBinding() const { return m_Binding; }
+
+	RendererID GetRendererID() const { return m_RendererID; }
+
+	static Ref<StorageBuffer> Create(uint32_t size, uint32_t binding);
+
+private:
+
+	RendererID m_RendererID = 0;
+
+	uint32_t m_Size = 0;
+	uint32_t m_Binding = 0;
+};
\ No newline at end of file
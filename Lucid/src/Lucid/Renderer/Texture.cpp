@@ -7,6 +7,14 @@
 #include <stb_image/stb_image.h>
 
 #include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderState.h"
+
+// S3TC formats come from EXT_texture_compression_s3tc rather than core, so the loader's core profile headers lack them
+// Only RGTC, used for BC5, is core
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
 
 static GLenum SetTextureFormat(TextureFormat format)
 {
@@ -31,6 +39,50 @@ static GLenum SetTextureFormat(TextureFormat format)
 	return 0;
 }
 
+static GLenum GetCompressedFormat(TextureFormat format, bool srgb)
+{
+	switch (format)
+	{
+		case TextureFormat::BC1:
+		{
+			return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		}
+		case TextureFormat::BC3:
+		{
+			return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		}
+		case TextureFormat::BC5:
+		{
+			return GL_COMPRESSED_RG_RGTC2;
+		}
+	}
+
+	LD_CORE_ASSERT(false, "Unknown compressed texture format!");
+
+	return 0;
+}
+
+static TextureFormat GetCookedFormat(TextureCompression compression)
+{
+	switch (compression)
+	{
+		case TextureCompression::BC1:
+		{
+			return TextureFormat::BC1;
+		}
+		case TextureCompression::BC3:
+		{
+			return TextureFormat::BC3;
+		}
+		case TextureCompression::BC5:
+		{
+			return TextureFormat::BC5;
+		}
+	}
+
+	return TextureFormat::None;
+}
+
 Ref<Texture2D> Texture2D::Create(TextureFormat format, uint32_t width, uint32_t height, TextureWrap wrap)
 {
 	return Ref<Texture2D>::Create(format, width, height, wrap);
@@ -41,6 +93,11 @@ Ref<Texture2D> Texture2D::Create(const std::string& path, bool srgb)
 	return Ref<Texture2D>::Create(path, srgb);
 }
 
+Ref<Texture2D> Texture2D::Create(const TextureImage& image)
+{
+	return Ref<Texture2D>::Create(image);
+}
+
 Ref<TextureCube> TextureCube::Create(TextureFormat format, uint32_t width, uint32_t height)
 {
 	return Ref<TextureCube>::Create(format, width, height);
@@ -73,14 +130,40 @@ Texture2D::Texture2D(TextureFormat format, uint32_t width, uint32_t height, Text
 		glTexImage2D(GL_TEXTURE_2D, 0, SetTextureFormat(instance->m_Format), instance->m_Width, instance->m_Height, 0, SetTextureFormat(instance->m_Format), GL_UNSIGNED_BYTE, nullptr);
 
 		glBindTexture(GL_TEXTURE_2D, 0);
+
+		RenderState::Invalidate();
 	});
 
 	m_ImageData.Allocate(width * height * Texture2D::GetBPP(m_Format));
 }
 
-Texture2D::Texture2D(const std::string& path, bool srgb)
-	: m_FilePath(path)
+TextureImage Texture2D::Decode(const std::string& path, bool srgb)
 {
+	TextureImage image;
+	image.Path = path;
+	image.SRGB = srgb;
+
+	// A cooked texture skips decoding and mip generation entirely
+	image.Cooked = CookedTexture::Open(path, srgb);
+
+	// BC1 and BC3 containers need the S3TC extension, without it the source is decoded instead, BC5 is core
+	if (image.Cooked && image.Cooked->GetHeader().Compression != TextureCompression::BC5 && !RendererCapabilities::GetCapabilities().TextureCompressionS3TC)
+	{
+		LD_CORE_WARN("Cooked texture {0} needs S3TC, which the driver does not support, decoding the source instead", CookedTexture::GetCookedPath(path));
+
+		image.Cooked = nullptr;
+	}
+
+	if (image.Cooked)
+	{
+		LD_CORE_INFO("Loading cooked texture {0}, srgb={1}", CookedTexture::GetCookedPath(path), srgb);
+
+		image.Width = image.Cooked->GetHeader().Width;
+		image.Height = image.Cooked->GetHeader().Height;
+
+		return image;
+	}
+
 	int width;
 	int height;
 	int channels;
@@ -89,23 +172,96 @@ Texture2D::Texture2D(const std::string& path, bool srgb)
 	{
 		LD_CORE_INFO("Loading HDR texture {0}, srgb={1}", path, srgb);
 
-		m_ImageData.Data = (byte*)stbi_loadf(path.c_str(), &width, &height, &channels, 0);
-
-		m_IsHDR = true;
+		image.Data = stbi_loadf(path.c_str(), &width, &height, &channels, 0);
 
-		m_Format = TextureFormat::Float16;
+		image.HDR = true;
 	}
 	else
 	{
 		LD_CORE_INFO("Loading texture {0}, srgb={1}", path, srgb);
 
-		m_ImageData.Data = stbi_load(path.c_str(), &width, &height, &channels, srgb ? STBI_rgb : STBI_rgb_alpha);
+		image.Data = stbi_load(path.c_str(), &width, &height, &channels, srgb ? STBI_rgb : STBI_rgb_alpha);
+
+		LD_CORE_ASSERT(image.Data, "Could not read image!");
+	}
+
+	if (image.Data)
+	{
+		image.Width = width;
+		image.Height = height;
+	}
 
-		LD_CORE_ASSERT(m_ImageData.Data, "Could not read image!");
+	return image;
+}
 
-		m_Format = TextureFormat::RGBA;
+void Texture2D::FreeImage(TextureImage& image)
+{
+	if (image.Data)
+	{
+		stbi_image_free(image.Data);
 	}
 
+	image.Data = nullptr;
+	image.Cooked = nullptr;
+}
+
+Texture2D::Texture2D(const std::string& path, bool srgb)
+	: Texture2D(Decode(path, srgb))
+{
+}
+
+Texture2D::Texture2D(const TextureImage& image)
+	: m_FilePath(image.Path)
+{
+	if (image.Cooked)
+	{
+		const CookedTextureHeader& header = image.Cooked->GetHeader();
+
+		m_Format = GetCookedFormat(header.Compression);
+
+		m_Width = header.Width;
+		m_Height = header.Height;
+
+		m_Loaded = true;
+
+		Ref<Texture2D> instance = this;
+		Ref<CookedTexture> cooked = image.Cooked;
+
+		bool srgb = image.SRGB;
+
+		// The submission keeps the mapping alive until every mip has been copied out of it
+		Renderer::Submit([instance, cooked, srgb]() mutable
+		{
+			const CookedTextureHeader& header = cooked->GetHeader();
+
+			GLenum internalFormat = GetCompressedFormat(instance->m_Format, srgb);
+
+			glCreateTextures(GL_TEXTURE_2D, 1, &instance->m_RendererID);
+
+			glTextureStorage2D(instance->m_RendererID, header.MipCount, internalFormat, header.Width, header.Height);
+			glTextureParameteri(instance->m_RendererID, GL_TEXTURE_MIN_FILTER, header.MipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+			glTextureParameteri(instance->m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(instance->m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTextureParameteri(instance->m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			glTextureParameterf(instance->m_RendererID, GL_TEXTURE_MAX_ANISOTROPY, RendererCapabilities::GetCapabilities().MaxAnisotropy);
+
+			for (uint32_t level = 0; level < header.MipCount; level++)
+			{
+				const CookedTextureMip& mip = cooked->GetMip(level);
+
+				glCompressedTextureSubImage2D(instance->m_RendererID, level, 0, 0, mip.Width, mip.Height, internalFormat, (GLsizei)mip.Size, cooked->GetMipData(level));
+			}
+		});
+
+		return;
+	}
+
+	m_ImageData.Data = (byte*)image.Data;
+
+	m_IsHDR = image.HDR;
+
+	m_Format = image.HDR ? TextureFormat::Float16 : TextureFormat::RGBA;
+
 	if (!m_ImageData.Data)
 	{
 		return;
@@ -113,8 +269,10 @@ Texture2D::Texture2D(const std::string& path, bool srgb)
 
 	m_Loaded = true;
 
-	m_Width = width;
-	m_Height = height;
+	m_Width = image.Width;
+	m_Height = image.Height;
+
+	bool srgb = image.SRGB;
 
 	Ref<Texture2D> instance = this;
 
@@ -154,6 +312,8 @@ Texture2D::Texture2D(const std::string& path, bool srgb)
 			glGenerateMipmap(GL_TEXTURE_2D);
 
 			glBindTexture(GL_TEXTURE_2D, 0);
+
+			RenderState::Invalidate();
 		}
 
 		stbi_image_free(instance->m_ImageData.Data);
@@ -167,6 +327,8 @@ Texture2D::~Texture2D()
 	Renderer::Submit([rendererID]()
 	{
 		glDeleteTextures(1, &rendererID);
+
+		RenderState::Invalidate();
 	});
 }
 
@@ -176,7 +338,7 @@ void Texture2D::Bind(uint32_t slot) const
 
 	Renderer::Submit([instance, slot]()
 	{
-		glBindTextureUnit(slot, instance->m_RendererID);
+		RenderState::BindTextureUnit(slot, instance->m_RendererID);
 	});
 }
 
@@ -213,6 +375,49 @@ Memory Texture2D::GetWriteableBuffer()
 	return m_ImageData;
 }
 
+uint64_t Texture2D::GetMemorySize() const
+{
+	if (!m_FilePath.empty() && !m_Loaded)
+	{
+		return 0;
+	}
+
+	uint64_t texels = (uint64_t)m_Width * m_Height;
+	uint64_t size = 0;
+
+	switch (m_Format)
+	{
+		case TextureFormat::BC1:
+		{
+			size = texels / 2;
+
+			break;
+		}
+		case TextureFormat::BC3:
+		case TextureFormat::BC5:
+		{
+			size = texels;
+
+			break;
+		}
+		case TextureFormat::Float16:
+		{
+			size = texels * 8;
+
+			break;
+		}
+		default:
+		{
+			size = texels * GetBPP(m_Format);
+
+			break;
+		}
+	}
+
+	// Textures loaded from a file have a full mip chain, which adds a third
+	return m_FilePath.empty() ? size : size * 4 / 3;
+}
+
 uint32_t Texture2D::GetBPP(TextureFormat format)
 {
 	switch (format)
@@ -375,6 +580,8 @@ TextureCube::TextureCube(const std::string& path)
 
 		glBindTexture(GL_TEXTURE_2D, 0);
 
+		RenderState::Invalidate();
+
 		for (size_t i = 0; i < faces.size(); i++)
 		{
 			delete[] faces[i];
@@ -391,6 +598,8 @@ TextureCube::~TextureCube()
 	Renderer::Submit([rendererID]()
 	{
 		glDeleteTextures(1, &rendererID);
+
+		RenderState::Invalidate();
 	});
 }
 
@@ -400,7 +609,7 @@ void TextureCube::Bind(uint32_t slot) const
 
 	Renderer::Submit([instance, slot]()
 	{
-		glBindTextureUnit(slot, instance->m_RendererID);
+		RenderState::BindTextureUnit(slot, instance->m_RendererID);
 	});
 }
 
@@ -3,12 +3,19 @@
 #include "Lucid/Core/Base.h"
 #include "Lucid/Core/Memory.h"
 
+#include "Lucid/Renderer/CookedTexture.h"
+
 enum class TextureFormat
 {
 	None = 0,
 	RGB = 1,
 	RGBA = 2,
-	Float16 = 3
+	Float16 = 3,
+
+	// Block compressed, only loaded from cooked textures
+	BC1 = 4,
+	BC3 = 5,
+	BC5 = 6
 };
 
 enum class TextureWrap
@@ -18,6 +25,24 @@ enum class TextureWrap
 	Repeat = 2
 };
 
+// Pixels of an image file decoded on the CPU, decoding does not touch the renderer so it can run on any thread
+struct TextureImage
+{
+	std::string Path;
+
+	bool SRGB = false;
+	bool HDR = false;
+
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+
+	// Allocated by stb_image, null when the file could not be read, freed once uploaded into a texture
+	void* Data = nullptr;
+
+	// Set instead of Data when the image has a cooked texture, its mips are uploaded straight from the mapping
+	Ref<CookedTexture> Cooked;
+};
+
 class Texture2D : public RefCounted
 {
 
@@ -25,11 +50,20 @@ public:
 
 	Texture2D(TextureFormat format, uint32_t width, uint32_t height, TextureWrap wrap);
 	Texture2D(const std::string& path, bool srgb);
+	Texture2D(const TextureImage& image);
 	~Texture2D();
 
 	static Ref<Texture2D> Create(TextureFormat format, uint32_t width, uint32_t height, TextureWrap wrap = TextureWrap::Clamp);
 	static Ref<Texture2D> Create(const std::string& path, bool srgb = false);
 
+	// Takes ownership of the decoded pixels and uploads them
+	static Ref<Texture2D> Create(const TextureImage& image);
+
+	static TextureImage Decode(const std::string& path, bool srgb = false);
+
+	// Frees the pixels of an image that will not be uploaded
+	static void FreeImage(TextureImage& image);
+
 	void Bind(uint32_t slot = 0) const;
 
 	TextureFormat GetFormat() const { return m_Format; }
@@ -48,6 +82,9 @@ public:
 
 	const std::string& GetPath() const { return m_FilePath; }
 
+	// Estimated video memory of the texture and its mips, in bytes
+	uint64_t GetMemorySize() const;
+
 	bool Loaded() const { return m_Loaded; }
 
 	RendererID GetRendererID() const { return m_RendererID; }
@@ -0,0 +1,625 @@
+#include "ldpch.h"
+
+#include "TextureCooker.h"
+
+#include <glm/glm.hpp>
+
+#include <stb_image/stb_image.h>
+
+#include "Lucid/Core/ThreadPool.h"
+
+static constexpr float s_Pi = 3.14159265358979f;
+
+// Lanczos lobes, two keeps ringing low while staying much sharper than a box filter
+static constexpr float s_LanczosRadius = 2.0f;
+
+// Linear floating point image the mips are filtered in
+struct CookImage
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+
+	std::vector<glm::vec4> Texels;
+};
+
+// Source texels and weights making up one destination texel
+struct ResampleTaps
+{
+	std::vector<uint32_t> Indices;
+	std::vector<float> Weights;
+};
+
+static float SRGBToLinear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSRGB(float value)
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static float Lanczos(float x)
+{
+	x = std::abs(x);
+
+	if (x < 1e-5f)
+	{
+		return 1.0f;
+	}
+
+	if (x >= s_LanczosRadius)
+	{
+		return 0.0f;
+	}
+
+	float px = s_Pi * x;
+
+	return s_LanczosRadius * std::sin(px) * std::sin(px / s_LanczosRadius) / (px * px);
+}
+
+// The filter is stretched by the reduction so every source texel contributes, taps past the edge are clamped onto it
+static std::vector<ResampleTaps> ComputeTaps(uint32_t sourceSize, uint32_t destinationSize)
+{
+	std::vector<ResampleTaps> taps(destinationSize);
+
+	float scale = (float)sourceSize / (float)destinationSize;
+	float support = s_LanczosRadius * scale;
+
+	for (uint32_t i = 0; i < destinationSize; i++)
+	{
+		float centre = ((float)i + 0.5f) * scale;
+
+		int32_t first = (int32_t)std::floor(centre - support);
+		int32_t last = (int32_t)std::ceil(centre + support);
+
+		float total = 0.0f;
+
+		for (int32_t j = first; j <= last; j++)
+		{
+			float weight = Lanczos(((float)j + 0.5f - centre) / scale);
+
+			if (weight == 0.0f)
+			{
+				continue;
+			}
+
+			taps[i].Indices.push_back((uint32_t)std::clamp(j, 0, (int32_t)sourceSize - 1));
+			taps[i].Weights.push_back(weight);
+
+			total += weight;
+		}
+
+		for (float& weight : taps[i].Weights)
+		{
+			weight /= total;
+		}
+	}
+
+	return taps;
+}
+
+// Separable resample, rows first then columns
+static CookImage Resample(const CookImage& source, uint32_t width, uint32_t height)
+{
+	std::vector<ResampleTaps> horizontalTaps = ComputeTaps(source.Width, width);
+	std::vector<ResampleTaps> verticalTaps = ComputeTaps(source.Height, height);
+
+	std::vector<glm::vec4> rows((size_t)width * source.Height);
+
+	for (uint32_t y = 0; y < source.Height; y++)
+	{
+		const glm::vec4* sourceRow = &source.Texels[(size_t)y * source.Width];
+
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const ResampleTaps& taps = horizontalTaps[x];
+
+			glm::vec4 sum(0.0f);
+
+			for (size_t i = 0; i < taps.Indices.size(); i++)
+			{
+				sum += sourceRow[taps.Indices[i]] * taps.Weights[i];
+			}
+
+			rows[(size_t)y * width + x] = sum;
+		}
+	}
+
+	CookImage result;
+	result.Width = width;
+	result.Height = height;
+	result.Texels.resize((size_t)width * height);
+
+	for (uint32_t y = 0; y < height; y++)
+	{
+		const ResampleTaps& taps = verticalTaps[y];
+
+		for (uint32_t x = 0; x < width; x++)
+		{
+			glm::vec4 sum(0.0f);
+
+			for (size_t i = 0; i < taps.Indices.size(); i++)
+			{
+				sum += rows[(size_t)taps.Indices[i] * width + x] * taps.Weights[i];
+			}
+
+			// Negative lobes overshoot around hard edges
+			result.Texels[(size_t)y * width + x] = glm::clamp(sum, glm::vec4(0.0f), glm::vec4(1.0f));
+		}
+	}
+
+	return result;
+}
+
+// Filtering shortens normals, they are pulled back to unit length so lighting does not darken in the distance
+static void RenormaliseNormals(CookImage& image)
+{
+	for (glm::vec4& texel : image.Texels)
+	{
+		glm::vec3 normal = glm::vec3(texel) * 2.0f - 1.0f;
+
+		float length = glm::length(normal);
+
+		normal = length > 1e-6f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+
+		texel = glm::vec4(normal * 0.5f + 0.5f, texel.a);
+	}
+}
+
+static std::vector<uint8_t> QuantiseImage(const CookImage& image, bool srgb)
+{
+	std::vector<uint8_t> texels(image.Texels.size() * 4);
+
+	for (size_t i = 0; i < image.Texels.size(); i++)
+	{
+		const glm::vec4& texel = image.Texels[i];
+
+		// Alpha is never gamma encoded
+		glm::vec4 encoded = srgb ? glm::vec4(LinearToSRGB(texel.r), LinearToSRGB(texel.g), LinearToSRGB(texel.b), texel.a) : texel;
+
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			texels[i * 4 + channel] = (uint8_t)(std::clamp(encoded[channel], 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+	}
+
+	return texels;
+}
+
+// 4x4 block starting at a texel, blocks hanging over the edge of small mips repeat the last row and column
+static void GatherBlock(const std::vector<uint8_t>& texels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t block[16][4])
+{
+	for (uint32_t y = 0; y < 4; y++)
+	{
+		for (uint32_t x = 0; x < 4; x++)
+		{
+			uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+			uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+
+			memcpy(block[y * 4 + x], &texels[((size_t)sourceY * width + sourceX) * 4], 4);
+		}
+	}
+}
+
+static uint16_t PackRGB565(const glm::vec3& colour)
+{
+	glm::vec3 clamped = glm::clamp(colour, glm::vec3(0.0f), glm::vec3(255.0f));
+
+	uint16_t r = (uint16_t)(clamped.r * 31.0f / 255.0f + 0.5f);
+	uint16_t g = (uint16_t)(clamped.g * 63.0f / 255.0f + 0.5f);
+	uint16_t b = (uint16_t)(clamped.b * 31.0f / 255.0f + 0.5f);
+
+	return (r << 11) | (g << 5) | b;
+}
+
+static glm::vec3 UnpackRGB565(uint16_t colour)
+{
+	uint32_t r = (colour >> 11) & 31;
+	uint32_t g = (colour >> 5) & 63;
+	uint32_t b = colour & 31;
+
+	return glm::vec3((float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)));
+}
+
+struct BC1Block
+{
+	uint16_t Colour0 = 0;
+	uint16_t Colour1 = 0;
+
+	uint32_t Indices = 0;
+
+	float Error = 0.0f;
+};
+
+// Picks the nearest of the four palette colours for every texel, endpoints are ordered so the block decodes in four colour mode
+static BC1Block FitBC1Indices(const glm::vec3 colours[16], uint16_t colour0, uint16_t colour1)
+{
+	BC1Block block;
+
+	if (colour0 < colour1)
+	{
+		std::swap(colour0, colour1);
+	}
+
+	block.Colour0 = colour0;
+	block.Colour1 = colour1;
+
+	glm::vec3 endpoint0 = UnpackRGB565(colour0);
+	glm::vec3 endpoint1 = UnpackRGB565(colour1);
+
+	// Equal endpoints decode every index to the first one
+	if (colour0 == colour1)
+	{
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			glm::vec3 difference = colours[i] - endpoint0;
+
+			block.Error += glm::dot(difference, difference);
+		}
+
+		return block;
+	}
+
+	glm::vec3 palette[4] =
+	{
+		endpoint0,
+		endpoint1,
+		(endpoint0 * 2.0f + endpoint1) / 3.0f,
+		(endpoint0 + endpoint1 * 2.0f) / 3.0f
+	};
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		uint32_t best = 0;
+		float bestError = FLT_MAX;
+
+		for (uint32_t p = 0; p < 4; p++)
+		{
+			glm::vec3 difference = colours[i] - palette[p];
+
+			float error = glm::dot(difference, difference);
+
+			if (error < bestError)
+			{
+				best = p;
+				bestError = error;
+			}
+		}
+
+		block.Indices |= best << (i * 2);
+		block.Error += bestError;
+	}
+
+	return block;
+}
+
+// Endpoints at the extremes of the block along its principal axis, then refined once by a least squares fit to the chosen indices
+static void EncodeBC1(const uint8_t texels[16][4], uint8_t* output)
+{
+	glm::vec3 colours[16];
+	glm::vec3 mean(0.0f);
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		colours[i] = glm::vec3(texels[i][0], texels[i][1], texels[i][2]);
+
+		mean += colours[i] / 16.0f;
+	}
+
+	glm::mat3 covariance(0.0f);
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		glm::vec3 offset = colours[i] - mean;
+
+		covariance += glm::outerProduct(offset, offset);
+	}
+
+	// Power iteration converges on the direction of greatest spread
+	glm::vec3 axis(1.0f);
+
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		axis = covariance * axis;
+
+		float length = glm::length(axis);
+
+		if (length < 1e-6f)
+		{
+			axis = glm::vec3(0.0f);
+
+			break;
+		}
+
+		axis /= length;
+	}
+
+	glm::vec3 minColour = mean;
+	glm::vec3 maxColour = mean;
+
+	float minProjection = FLT_MAX;
+	float maxProjection = -FLT_MAX;
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		float projection = glm::dot(colours[i] - mean, axis);
+
+		if (projection < minProjection)
+		{
+			minProjection = projection;
+			minColour = colours[i];
+		}
+
+		if (projection > maxProjection)
+		{
+			maxProjection = projection;
+			maxColour = colours[i];
+		}
+	}
+
+	BC1Block block = FitBC1Indices(colours, PackRGB565(maxColour), PackRGB565(minColour));
+
+	if (block.Colour0 != block.Colour1 && block.Error > 0.0f)
+	{
+		// Share of the first endpoint in each palette entry
+		static constexpr float s_PaletteWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+		float aa = 0.0f;
+		float ab = 0.0f;
+		float bb = 0.0f;
+
+		glm::vec3 ax(0.0f);
+		glm::vec3 bx(0.0f);
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			float a = s_PaletteWeights[(block.Indices >> (i * 2)) & 3];
+			float b = 1.0f - a;
+
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+
+			ax += colours[i] * a;
+			bx += colours[i] * b;
+		}
+
+		float determinant = aa * bb - ab * ab;
+
+		if (std::abs(determinant) > 1e-6f)
+		{
+			glm::vec3 endpoint0 = (ax * bb - bx * ab) / determinant;
+			glm::vec3 endpoint1 = (bx * aa - ax * ab) / determinant;
+
+			BC1Block refined = FitBC1Indices(colours, PackRGB565(endpoint0), PackRGB565(endpoint1));
+
+			if (refined.Error < block.Error)
+			{
+				block = refined;
+			}
+		}
+	}
+
+	memcpy(output + 0, &block.Colour0, 2);
+	memcpy(output + 2, &block.Colour1, 2);
+	memcpy(output + 4, &block.Indices, 4);
+}
+
+// Single channel block, endpoints at the channel's extremes interpolated in eight steps
+static void EncodeBC4(const uint8_t values[16], uint8_t* output)
+{
+	uint8_t minValue = 255;
+	uint8_t maxValue = 0;
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		minValue = std::min(minValue, values[i]);
+		maxValue = std::max(maxValue, values[i]);
+	}
+
+	output[0] = maxValue;
+	output[1] = minValue;
+
+	uint64_t indices = 0;
+
+	// Equal endpoints decode every index to the first one
+	if (maxValue > minValue)
+	{
+		float palette[8];
+		palette[0] = maxValue;
+		palette[1] = minValue;
+
+		for (uint32_t i = 2; i < 8; i++)
+		{
+			palette[i] = ((float)(8 - i) * maxValue + (float)(i - 1) * minValue) / 7.0f;
+		}
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint64_t best = 0;
+			float bestError = FLT_MAX;
+
+			for (uint32_t p = 0; p < 8; p++)
+			{
+				float error = std::abs((float)values[i] - palette[p]);
+
+				if (error < bestError)
+				{
+					best = p;
+					bestError = error;
+				}
+			}
+
+			indices |= best << (i * 3);
+		}
+	}
+
+	// 48 bits of indices, little endian
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		output[2 + i] = (uint8_t)(indices >> (i * 8));
+	}
+}
+
+static void EncodeBlock(TextureCompression compression, const uint8_t texels[16][4], uint8_t* output)
+{
+	uint8_t channel[16];
+
+	switch (compression)
+	{
+		case TextureCompression::BC1:
+		{
+			EncodeBC1(texels, output);
+
+			break;
+		}
+		case TextureCompression::BC3:
+		{
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				channel[i] = texels[i][3];
+			}
+
+			EncodeBC4(channel, output);
+			EncodeBC1(texels, output + 8);
+
+			break;
+		}
+		case TextureCompression::BC5:
+		{
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				channel[i] = texels[i][0];
+			}
+
+			EncodeBC4(channel, output);
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				channel[i] = texels[i][1];
+			}
+
+			EncodeBC4(channel, output + 8);
+
+			break;
+		}
+	}
+}
+
+static std::vector<uint8_t> CompressImage(const std::vector<uint8_t>& texels, uint32_t width, uint32_t height, TextureCompression compression)
+{
+	uint32_t blocksX = (width + 3) / 4;
+	uint32_t blocksY = (height + 3) / 4;
+
+	uint32_t blockSize = compression == TextureCompression::BC1 ? 8 : 16;
+
+	std::vector<uint8_t> blocks((size_t)blocksX * blocksY * blockSize);
+
+	// Rows of blocks are independent, the cooking thread takes part so this is safe from a job
+	ThreadPool::Get().ParallelFor(blocksY, [&](uint32_t blockY)
+	{
+		uint8_t block[16][4];
+
+		for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+		{
+			GatherBlock(texels, width, height, blockX, blockY, block);
+
+			EncodeBlock(compression, block, &blocks[((size_t)blockY * blocksX + blockX) * blockSize]);
+		}
+	});
+
+	return blocks;
+}
+
+bool TextureCooker::Cook(const std::string& sourcePath, const TextureCookSettings& settings)
+{
+	if (stbi_is_hdr(sourcePath.c_str()))
+	{
+		LD_CORE_WARN("Skipping {0}, HDR images are not block compressed", sourcePath);
+
+		return false;
+	}
+
+	int width;
+	int height;
+	int channels;
+
+	stbi_uc* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+	if (!pixels)
+	{
+		LD_CORE_WARN("Could not read {0} for cooking", sourcePath);
+
+		return false;
+	}
+
+	CookImage image;
+	image.Width = width;
+	image.Height = height;
+	image.Texels.resize((size_t)width * height);
+
+	bool transparent = false;
+
+	for (size_t i = 0; i < image.Texels.size(); i++)
+	{
+		glm::vec4 texel = glm::vec4(pixels[i * 4 + 0], pixels[i * 4 + 1], pixels[i * 4 + 2], pixels[i * 4 + 3]) / 255.0f;
+
+		if (settings.SRGB)
+		{
+			texel = glm::vec4(SRGBToLinear(texel.r), SRGBToLinear(texel.g), SRGBToLinear(texel.b), texel.a);
+		}
+
+		transparent |= pixels[i * 4 + 3] < 255;
+
+		image.Texels[i] = texel;
+	}
+
+	stbi_image_free(pixels);
+
+	TextureCompression compression = settings.NormalMap ? TextureCompression::BC5 : (transparent ? TextureCompression::BC3 : TextureCompression::BC1);
+
+	// Mips from largest down to 1x1
+	std::vector<CookedTextureMip> mips;
+	std::vector<std::vector<uint8_t>> mipData;
+
+	while (true)
+	{
+		CookedTextureMip& mip = mips.emplace_back();
+		mip.Width = image.Width;
+		mip.Height = image.Height;
+
+		mipData.push_back(CompressImage(QuantiseImage(image, settings.SRGB), image.Width, image.Height, compression));
+
+		if (image.Width == 1 && image.Height == 1)
+		{
+			break;
+		}
+
+		// Each mip is filtered from the one above it, in linear space
+		image = Resample(image, std::max(image.Width / 2, 1u), std::max(image.Height / 2, 1u));
+
+		if (settings.NormalMap)
+		{
+			RenormaliseNormals(image);
+		}
+	}
+
+	if (!CookedTexture::Write(sourcePath, compression, settings.SRGB, mips, mipData))
+	{
+		return false;
+	}
+
+	uint64_t compressedSize = 0;
+
+	for (const std::vector<uint8_t>& data : mipData)
+	{
+		compressedSize += data.size();
+	}
+
+	const char* compressionName = compression == TextureCompression::BC1 ? "BC1" : (compression == TextureCompression::BC3 ? "BC3" : "BC5");
+
+	LD_CORE_INFO("Cooked {0} to {1}, {2} mips ({3} KB)", sourcePath, compressionName, mips.size(), compressedSize / 1024);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Lucid/Renderer/CookedTexture.h"
+
+struct TextureCookSettings
+{
+	// Colour is sRGB encoded, mips are filtered after decoding it
+	bool SRGB = false;
+
+	// Tangent space normals, compressed to two channels and renormalised on every mip
+	bool NormalMap = false;
+};
+
+// Offline conversion of source images into cooked textures, runs on the CPU and does not touch the renderer so it can run on any thread
+// Normal maps compress to BC5, images with transparency to BC3 and everything else to BC1
+class TextureCooker
+{
+
+public:
+
+	// Cooks a source image into its container beside it, returns false when the image could not be read or the container written
+	static bool Cook(const std::string& sourcePath, const TextureCookSettings& settings);
+};
\ No newline at end of file
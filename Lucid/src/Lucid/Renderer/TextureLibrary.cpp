@@ -0,0 +1,102 @@
+#include "ldpch.h"
+
+#include "TextureLibrary.h"
+
+#include <mutex>
+
+#include "Lucid/Core/FileSystem.h"
+
+struct TextureLibraryData
+{
+	std::mutex Mutex;
+
+	std::unordered_map<std::string, Ref<Texture2D>> Textures;
+};
+
+static TextureLibraryData s_Data;
+
+// The same file is cached once as sRGB and once as linear
+static std::string GetTextureKey(const std::string& filepath, bool srgb)
+{
+	return FileSystem::GetCanonicalPath(filepath) + (srgb ? "|srgb" : "|linear");
+}
+
+Ref<Texture2D> TextureLibrary::Find(const std::string& filepath, bool srgb)
+{
+	std::string key = GetTextureKey(filepath, srgb);
+
+	std::lock_guard<std::mutex> lock(s_Data.Mutex);
+
+	auto it = s_Data.Textures.find(key);
+
+	return it != s_Data.Textures.end() ? it->second : nullptr;
+}
+
+Ref<Texture2D> TextureLibrary::Add(TextureImage& image)
+{
+	std::string key = GetTextureKey(image.Path, image.SRGB);
+
+	std::lock_guard<std::mutex> lock(s_Data.Mutex);
+
+	auto it = s_Data.Textures.find(key);
+
+	if (it != s_Data.Textures.end())
+	{
+		Texture2D::FreeImage(image);
+
+		return it->second;
+	}
+
+	Ref<Texture2D> texture = Texture2D::Create(image);
+
+	// The texture owns the pixels or the cooked mapping now
+	image.Data = nullptr;
+	image.Cooked = nullptr;
+
+	// Files that failed to decode are not cached so a later load retries them
+	if (texture->Loaded())
+	{
+		s_Data.Textures[key] = texture;
+	}
+
+	return texture;
+}
+
+void TextureLibrary::ReleaseUnused()
+{
+	std::lock_guard<std::mutex> lock(s_Data.Mutex);
+
+	for (auto it = s_Data.Textures.begin(); it != s_Data.Textures.end();)
+	{
+		// A texture a loading mesh found in the library is also referenced by the mesh
+		if (it->second->GetRefCount() == 1)
+		{
+			it = s_Data.Textures.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+uint32_t TextureLibrary::GetTextureCount()
+{
+	std::lock_guard<std::mutex> lock(s_Data.Mutex);
+
+	return (uint32_t)s_Data.Textures.size();
+}
+
+uint64_t TextureLibrary::GetMemoryUsage()
+{
+	std::lock_guard<std::mutex> lock(s_Data.Mutex);
+
+	uint64_t memory = 0;
+
+	for (const auto& [key, texture] : s_Data.Textures)
+	{
+		memory += texture->GetMemorySize();
+	}
+
+	return memory;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Lucid/Renderer/Texture.h"
+
+// Shared textures keyed by canonical path and sRGB flag, so materials referencing the same file share one texture
+// Lookups are safe from worker threads, textures are only created and released on the main thread
+class TextureLibrary
+{
+
+public:
+
+	// Returns the cached texture of a file, null when it is not loaded
+	static Ref<Texture2D> Find(const std::string& filepath, bool srgb);
+
+	// Uploads a decoded image and caches the texture, if another load cached the same file first that texture is returned and the image freed
+	static Ref<Texture2D> Add(TextureImage& image);
+
+	// Releases textures that are no longer referenced outside the library
+	static void ReleaseUnused();
+
+	static uint32_t GetTextureCount();
+
+	// Estimated video memory of every cached texture, in bytes
+	static uint64_t GetMemoryUsage();
+};
\ No newline at end of file
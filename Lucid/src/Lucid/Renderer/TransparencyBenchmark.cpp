@@ -0,0 +1,219 @@
+#include "ldpch.h"
+
+#include "TransparencyBenchmark.h"
+
+#include <atomic>
+
+#include <glad/glad.h>
+
+#include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderProfiler.h"
+#include "Lucid/Renderer/RenderState.h"
+#include "Lucid/Renderer/SceneRenderer.h"
+
+// Frames rendered with each technique, enough for the render profiler's history to hold nothing but the technique being measured
+static constexpr uint32_t s_BenchmarkFrames = 150;
+
+// Graph passes timed for each technique, in the order of the runs
+static const std::vector<std::string> s_TechniquePasses[2] =
+{
+	{ "DualDepthPeel" },
+	{ "WeightedBlended", "WeightedBlendedResolve" }
+};
+
+static const TransparencyTechnique s_Techniques[2] = { TransparencyTechnique::DualDepthPeeling, TransparencyTechnique::WeightedBlended };
+
+// Final colour buffer read back at the end of a run, written on the render thread
+struct TransparencyCapture
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+
+	std::vector<uint8_t> Pixels;
+};
+
+struct TransparencyBenchmarkData
+{
+	// Main thread
+	bool Running = false;
+	uint32_t Run = 0;
+	uint32_t Frame = 0;
+
+	TransparencyTechnique PreviousTechnique = TransparencyTechnique::DualDepthPeeling;
+
+	float GPUTimes[2] = {};
+
+	TransparencyCapture Captures[2];
+
+	// Written on the render thread before the flags are cleared
+	TransparencyBenchmarkResult Result;
+
+	std::atomic<bool> Comparing{ false };
+	std::atomic<bool> ResultReady{ false };
+};
+
+static TransparencyBenchmarkData s_Data;
+
+// Sum of the averaged GPU time of a run's passes, every frame in the profiler history was rendered with that run's technique
+static float GetRunGPUTime(uint32_t run)
+{
+	float time = 0.0f;
+
+	for (const RenderProfilerResult& result : RenderProfiler::GetResults())
+	{
+		const std::vector<std::string>& passes = s_TechniquePasses[run];
+
+		if (std::find(passes.begin(), passes.end(), result.Name) != passes.end())
+		{
+			time += result.GPUTime;
+		}
+	}
+
+	return time;
+}
+
+// Reads back the final colour buffer ahead of the passes of the frame being recorded, which holds the last frame of the run
+static void CaptureRun(uint32_t run)
+{
+	Ref<Framebuffer> framebuffer = SceneRenderer::GetFinalRenderPass()->GetSpecification().TargetFramebuffer;
+
+	uint32_t width = framebuffer->GetViewportWidth();
+	uint32_t height = framebuffer->GetViewportHeight();
+
+	TransparencyCapture* capture = &s_Data.Captures[run];
+
+	Renderer::Submit([capture, framebuffer, width, height]()
+	{
+		capture->Width = width;
+		capture->Height = height;
+		capture->Pixels.resize((size_t)width * height * 4);
+
+		RenderState::BindReadFramebuffer(framebuffer->GetRendererID());
+
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, capture->Pixels.data());
+	});
+}
+
+// Render thread, runs after both captures have been read back
+static void CompareCaptures(TransparencyBenchmarkResult result)
+{
+	const TransparencyCapture& peeled = s_Data.Captures[0];
+	const TransparencyCapture& weighted = s_Data.Captures[1];
+
+	result.ImageCompared = !peeled.Pixels.empty() && peeled.Width == weighted.Width && peeled.Height == weighted.Height;
+
+	if (result.ImageCompared)
+	{
+		double squaredError = 0.0;
+		int maxError = 0;
+
+		for (size_t i = 0; i < peeled.Pixels.size(); i++)
+		{
+			// The composite always writes an alpha of one
+			if (i % 4 == 3)
+			{
+				continue;
+			}
+
+			int error = std::abs((int)peeled.Pixels[i] - (int)weighted.Pixels[i]);
+
+			squaredError += (double)(error * error);
+			maxError = std::max(maxError, error);
+		}
+
+		result.RMSError = (float)(std::sqrt(squaredError / (double)(peeled.Pixels.size() / 4 * 3)) / 255.0);
+		result.MaxError = (float)maxError / 255.0f;
+	}
+
+	s_Data.Result = result;
+
+	LD_CORE_INFO("Transparency benchmark: dual depth peeling {0:.3f} ms, weighted blended {1:.3f} ms, RMS error {2:.4f}, max error {3:.4f}",
+		result.DualDepthPeelingTime, result.WeightedBlendedTime, result.RMSError, result.MaxError);
+
+	s_Data.ResultReady = true;
+	s_Data.Comparing = false;
+}
+
+void TransparencyBenchmark::Start()
+{
+	if (IsRunning())
+	{
+		return;
+	}
+
+	SceneRendererOptions& options = SceneRenderer::GetOptions();
+
+	s_Data.PreviousTechnique = options.Transparency;
+	options.Transparency = s_Techniques[0];
+
+	s_Data.Running = true;
+	s_Data.Run = 0;
+	s_Data.Frame = 0;
+
+	s_Data.ResultReady = false;
+}
+
+bool TransparencyBenchmark::IsRunning()
+{
+	return s_Data.Running || s_Data.Comparing;
+}
+
+void TransparencyBenchmark::Update()
+{
+	if (!s_Data.Running || ++s_Data.Frame <= s_BenchmarkFrames)
+	{
+		return;
+	}
+
+	CaptureRun(s_Data.Run);
+
+	s_Data.GPUTimes[s_Data.Run] = GetRunGPUTime(s_Data.Run);
+
+	SceneRendererOptions& options = SceneRenderer::GetOptions();
+
+	// The frame being recorded is the first of the next run
+	if (s_Data.Run == 0)
+	{
+		options.Transparency = s_Techniques[1];
+
+		s_Data.Run = 1;
+		s_Data.Frame = 1;
+
+		return;
+	}
+
+	options.Transparency = s_Data.PreviousTechnique;
+
+	s_Data.Running = false;
+	s_Data.Comparing = true;
+
+	TransparencyBenchmarkResult result;
+	result.DualDepthPeelingTime = s_Data.GPUTimes[0];
+	result.WeightedBlendedTime = s_Data.GPUTimes[1];
+
+	Renderer::Submit([result]()
+	{
+		CompareCaptures(result);
+	});
+}
+
+float TransparencyBenchmark::GetProgress()
+{
+	if (!s_Data.Running)
+	{
+		return s_Data.Comparing ? 1.0f : 0.0f;
+	}
+
+	return (float)(s_Data.Run * s_BenchmarkFrames + std::min(s_Data.Frame, s_BenchmarkFrames)) / (float)(s_BenchmarkFrames * 2);
+}
+
+bool TransparencyBenchmark::HasResult()
+{
+	return s_Data.ResultReady;
+}
+
+TransparencyBenchmarkResult TransparencyBenchmark::GetResult()
+{
+	return s_Data.ResultReady ? s_Data.Result : TransparencyBenchmarkResult();
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Lucid/Core/Base.h"
+
+// Frame cost and image difference of the two transparency techniques rendering the same view
+struct TransparencyBenchmarkResult
+{
+	// Average GPU milliseconds of each technique's passes, from the render profiler
+	float DualDepthPeelingTime = 0.0f;
+	float WeightedBlendedTime = 0.0f;
+
+	// False when the viewport changed size between the two captures
+	bool ImageCompared = false;
+
+	// Difference of the final colour buffers over every channel, in [0, 1]
+	float RMSError = 0.0f;
+	float MaxError = 0.0f;
+};
+
+// Renders the active scene with dual depth peeling and then with weighted blended transparency and compares the two
+// The camera should stay still while it runs, the transparency option is restored once it finishes
+class TransparencyBenchmark
+{
+
+public:
+
+	static void Start();
+
+	// True until the comparison of the captured images has finished
+	static bool IsRunning();
+
+	// Called once a frame before the scene is rendered, switches technique and captures the final image between runs
+	static void Update();
+
+	// Fraction of the benchmark frames rendered so far
+	static float GetProgress();
+
+	static bool HasResult();
+	static TransparencyBenchmarkResult GetResult();
+};
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "VertexArray.h"
 
 #include "Lucid/Renderer/Renderer.h"
+#include "Lucid/Renderer/RenderState.h"
 
 static GLenum ShaderDataTypeToOpenGLBaseType(ShaderDataType type)
 {
@@ -81,6 +82,8 @@ VertexArray::~VertexArray()
 	Renderer::Submit([rendererID]()
 	{
 		glDeleteVertexArrays(1, &rendererID);
+
+		RenderState::Invalidate();
 	});
 }
 
@@ -90,7 +93,7 @@ void VertexArray::Bind() const
 
 	Renderer::Submit([instance]()
 	{
-		glBindVertexArray(instance->m_RendererID);
+		RenderState::BindVertexArray(instance->m_RendererID);
 	});
 }
 
@@ -100,7 +103,7 @@ void VertexArray::Unbind() const
 
 	Renderer::Submit([instance]()
 	{
-		glBindVertexArray(0);
+		RenderState::BindVertexArray(0);
 	});
 }
 
@@ -16,8 +16,8 @@ public:
 	void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer);
 	void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer);
 
-	const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() { return m_VertexBuffers; }
-	const Ref<IndexBuffer>& GetIndexBuffer() { return m_IndexBuffer; }
+	const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const { return m_VertexBuffers; }
+	const Ref<IndexBuffer>& GetIndexBuffer() const { return m_IndexBuffer; }
 
 	RendererID GetRendererID() { return m_RendererID; };
 
@@ -21,6 +21,11 @@ Ref<IndexBuffer> IndexBuffer::Create(void* data, uint32_t size)
 	return Ref<IndexBuffer>::Create(data, size);
 }
 
+Ref<IndexBuffer> IndexBuffer::Create(uint32_t size, VertexBufferUsage usage)
+{
+	return Ref<IndexBuffer>::Create(size, usage);
+}
+
 static GLenum OpenGLUsage(VertexBufferUsage usage)
 {
 	switch (usage)
@@ -98,15 +103,15 @@ void VertexBuffer::Bind() const
 	});
 }
 
-IndexBuffer::IndexBuffer(uint32_t size)
+IndexBuffer::IndexBuffer(uint32_t size, VertexBufferUsage usage)
 	: m_Size(size)
 {
 	Ref<IndexBuffer> instance = this;
 
-	Renderer::Submit([instance]() mutable 
+	Renderer::Submit([instance, usage]() mutable 
 	{
 		glCreateBuffers(1, &instance->m_RendererID);
-		glNamedBufferData(instance->m_RendererID, instance->m_Size, nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(instance->m_RendererID, instance->m_Size, nullptr, OpenGLUsage(usage));
 	});
 }
 
@@ -225,7 +225,7 @@ class IndexBuffer : public RefCounted
 
 public:
 
-	IndexBuffer(uint32_t size);
+	IndexBuffer(uint32_t size, VertexBufferUsage usage = VertexBufferUsage::Dynamic);
 	IndexBuffer(void* data, uint32_t size);
 	~IndexBuffer();
 
@@ -238,6 +238,7 @@ public:
 	RendererID GetRendererID() const { return m_RendererID; }
 
 	static Ref<IndexBuffer> Create(void* data, uint32_t size = 0);
+	static Ref<IndexBuffer> Create(uint32_t size, VertexBufferUsage usage = VertexBufferUsage::Dynamic);
 
 private:
 
@@ -56,15 +56,14 @@ void Scene::Init()
 
 void Scene::OnUpdate(Timestep ts, const EditorCamera& editorCamera)
 {
-	SceneRenderer::BeginScene(this, { editorCamera, editorCamera.GetViewMatrix() });
-
-	// Iterate over all point lights
+	// Iterate over all point lights, lights are written in place and the environment is only marked changed when one differs from last frame
 	{
 		const auto& group = m_Registry.group<LightComponent>(entt::get<TransformComponent>);
 
-		int pointLightIndex = 0;
+		auto& pointLights = m_LightEnvironment.PointLights;
 
-		LightEnvironment lightEnvironment;
+		uint32_t pointLightCount = 0;
+		bool changed = false;
 
 		for (auto entity : group)
 		{
@@ -81,7 +80,7 @@ void Scene::OnUpdate(Timestep ts, const EditorCamera& editorCamera)
 			{
 				case LightComponent::Type::Point:
 				{
-					PointLight& light = lightEnvironment.PointLights[pointLightIndex++];
+					PointLight light;
 
 					light.Position = translation;
 					light.Brightness = lightComponent.Brightness;
@@ -89,14 +88,41 @@ void Scene::OnUpdate(Timestep ts, const EditorCamera& editorCamera)
 					light.Specular = lightComponent.Specular;
 					light.Quadratic = lightComponent.Quadratic;
 
+					if (pointLightCount == pointLights.size())
+					{
+						pointLights.push_back(light);
+
+						changed = true;
+					}
+					else if (memcmp(&pointLights[pointLightCount], &light, sizeof(PointLight)) != 0)
+					{
+						pointLights[pointLightCount] = light;
+
+						changed = true;
+					}
+
+					pointLightCount++;
+
 					break;
 				}
 			}
 		}
 
-		SetLightEnvironment(lightEnvironment);
+		if (pointLightCount != pointLights.size())
+		{
+			pointLights.resize(pointLightCount);
+
+			changed = true;
+		}
+
+		if (changed)
+		{
+			m_LightEnvironment.Version++;
+		}
 	}
 
+	SceneRenderer::BeginScene(this, { editorCamera, editorCamera.GetViewMatrix() });
+
 	// Iterate over all meshes
 	{
 		const auto& group = m_Registry.group<MeshComponent>(entt::get<TransformComponent>);
@@ -105,7 +131,8 @@ void Scene::OnUpdate(Timestep ts, const EditorCamera& editorCamera)
 		{
 			const auto& [transformComponent, meshComponent] = group.get<TransformComponent, MeshComponent>(entity);
 			
-			if (meshComponent.MeshComp)
+			// Meshes still loading asynchronously are left out until they are uploaded
+			if (meshComponent.MeshComp && meshComponent.MeshComp->IsLoaded())
 			{
 				if (m_SelectedEntity == entity)
 				{
@@ -134,7 +161,10 @@ void Scene::SetViewportSize(uint32_t width, uint32_t height)
 
 void Scene::SetLightEnvironment(const LightEnvironment& lightEnvironment)
 {
+	uint32_t version = m_LightEnvironment.Version;
+
 	m_LightEnvironment = lightEnvironment;
+	m_LightEnvironment.Version = version + 1;
 }
 
 Entity Scene::CreateEntity(const std::string& name)
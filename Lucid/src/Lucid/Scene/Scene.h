@@ -28,7 +28,10 @@ struct PointLight
 
 struct LightEnvironment
 {
-	PointLight PointLights[100];
+	std::vector<PointLight> PointLights;
+
+	// Incremented whenever the point lights change, lets the renderer skip re-uploading unchanged lights
+	uint32_t Version = 0;
 };
 
 class Entity;
@@ -4,13 +4,12 @@
 
 #include <imgui.h>
 
-#include <assimp/scene.h>
-
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 
 #include "Lucid/Renderer/Mesh.h"
+#include "Lucid/Renderer/MeshLibrary.h"
 
 #include "Lucid/Core/Application.h"
 
@@ -271,8 +270,6 @@ static void EndPropertyGrid()
 
 #pragma endregion
 
-glm::mat4 Mat4FromAssimpMat4(const aiMatrix4x4& matrix);
-
 SceneHierarchy::SceneHierarchy(const Ref<Scene>& context)
 	: m_Context(context)
 {
@@ -441,9 +438,10 @@ void SceneHierarchy::DrawMeshNode(const Ref<Mesh>& mesh, uint32_t& imguiMeshID)
 	// Mesh hierarchy
 	if (ImGui::TreeNode(imguiName))
 	{
-		auto rootNode = mesh->m_Scene->mRootNode;
-
-		MeshNodeHierarchy(mesh, rootNode);
+		if (mesh->IsLoaded() && !mesh->GetNodes().empty())
+		{
+			MeshNodeHierarchy(mesh, 0);
+		}
 
 		ImGui::TreePop();
 	}
@@ -462,12 +460,14 @@ static std::tuple<glm::vec3, glm::quat, glm::vec3> GetTransformDecomposition(con
 	return { translation, orientation, scale };
 }
 
-void SceneHierarchy::MeshNodeHierarchy(const Ref<Mesh>& mesh, aiNode* node, const glm::mat4& parentTransform, uint32_t level)
+void SceneHierarchy::MeshNodeHierarchy(const Ref<Mesh>& mesh, uint32_t nodeIndex, const glm::mat4& parentTransform, uint32_t level)
 {
-	glm::mat4 localTransform = Mat4FromAssimpMat4(node->mTransformation);
+	const MeshNode& node = mesh->GetNodes()[nodeIndex];
+
+	glm::mat4 localTransform = node.LocalTransform;
 	glm::mat4 transform = parentTransform * localTransform;
 
-	if (ImGui::TreeNode(node->mName.C_Str()))
+	if (ImGui::TreeNode(node.Name.c_str()))
 	{
 		{
 			auto [translation, rotation, scale] = GetTransformDecomposition(transform);
@@ -484,9 +484,9 @@ void SceneHierarchy::MeshNodeHierarchy(const Ref<Mesh>& mesh, aiNode* node, cons
 			ImGui::Text("  Scale: %.2f, %.2f, %.2f", scale.x, scale.y, scale.z);
 		}
 
-		for (uint32_t i = 0; i < node->mNumChildren; i++)
+		for (uint32_t i = 0; i < node.ChildCount; i++)
 		{
-			MeshNodeHierarchy(mesh, node->mChildren[i], transform, level + 1);
+			MeshNodeHierarchy(mesh, node.FirstChild + i, transform, level + 1);
 		}
 
 		ImGui::TreePop();
@@ -622,7 +622,7 @@ void SceneHierarchy::DrawComponents(Entity entity)
 
 				if (!file.empty())
 				{
-					mc.MeshComp = Ref<Mesh>::Create(file);
+					mc.MeshComp = MeshLibrary::LoadAsync(file);
 				}
 			}
 
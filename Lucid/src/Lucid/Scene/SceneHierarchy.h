@@ -23,7 +23,7 @@ private:
 
 	void DrawEntityNode(Entity entity);
 	void DrawMeshNode(const Ref<Mesh>& mesh, uint32_t& imguiMeshID);
-	void MeshNodeHierarchy(const Ref<Mesh>& mesh, aiNode* node, const glm::mat4& parentTransform = glm::mat4(1.0f), uint32_t level = 0);
+	void MeshNodeHierarchy(const Ref<Mesh>& mesh, uint32_t nodeIndex, const glm::mat4& parentTransform = glm::mat4(1.0f), uint32_t level = 0);
 	void DrawComponents(Entity entity);
 
 private:
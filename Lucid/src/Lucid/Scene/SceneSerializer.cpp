@@ -15,6 +15,8 @@
 #include "Lucid/Scene/Entity.h"
 #include "Lucid/Scene/Components.h"
 
+#include "Lucid/Renderer/MeshLibrary.h"
+
 #pragma region YAML-CPP Helpers
 
 namespace YAML {
@@ -390,7 +392,7 @@ bool SceneSerializer::Deserialize(const std::string& filepath)
 
 				if (!deserializedEntity.HasComponent<MeshComponent>())
 				{
-					auto& mc = deserializedEntity.AddComponent<MeshComponent>(Ref<Mesh>::Create(meshPath));
+					auto& mc = deserializedEntity.AddComponent<MeshComponent>(MeshLibrary::LoadAsync(meshPath));
 
 					mc.Transparent = meshComponent["Transparent"].as<bool>();
 				}
@@ -407,13 +409,7 @@ bool SceneSerializer::Deserialize(const std::string& filepath)
 				{
 					deserializedEntity.AddComponent<LightComponent>();
 
-					auto& pointLight = m_Scene->GetLightEnvironment().PointLights;
-
-					// Get the point lights translation
-					auto& transform = deserializedEntity.GetComponent<TransformComponent>().TransformComp;
-					glm::vec3 translation = transformComponent["Position"].as<glm::vec3>();
-					pointLight->Position = translation;
-
+					// Light positions come from the transform component, the scene gathers them into its light environment every update
 					auto& pntLight = deserializedEntity.GetComponent<LightComponent>();
 					
 					pntLight.Brightness = lightComponent["Brightness"].as<float>();